@@ -61,6 +61,10 @@ def generate_project_files():
     # construct the command as a string with quoted paths
     cmd = f'"{str(premake_exe)}" --file="{str(premake_lua)}" "{action}" "{platform}"'
 
+    # opt-in benchmarks project
+    if "benchmarks" in sys.argv:
+        cmd = f'"{str(premake_exe)}" --file="{str(premake_lua)}" --benchmarks "{action}" "{platform}"'
+
     print("Running command:", cmd)
     
     try:
@@ -21,6 +21,7 @@ CPP_VERSION      = "C++20"
 SOLUTION_NAME    = "spartan"
 EXECUTABLE_NAME  = "spartan"
 EDITOR_DIR       = "../source/editor"
+BENCHMARKS_DIR   = "../source/benchmarks"
 RUNTIME_DIR      = "../source/runtime"
 LIBRARY_DIR      = "../third_party/libraries"
 OBJ_DIR          = "../binaries/obj"
@@ -28,6 +29,11 @@ TARGET_DIR       = "../binaries"
 API_CPP_DEFINE   = ""
 ARG_API_GRAPHICS = _ARGS[1]
 
+newoption {
+    trigger     = "benchmarks",
+    description = "Also generate the benchmarks console project (runtime + source/benchmarks)"
+}
+
 function configure_graphics_api()
     if ARG_API_GRAPHICS == "d3d12" then
         API_CPP_DEFINE = "API_GRAPHICS_D3D12"
@@ -73,22 +79,18 @@ function solution_configuration()
             buildoptions { "-mavx2" }
 end
 
-function spartan_project_configuration()
-    project(SOLUTION_NAME)
+-- sources, includes and libraries of the runtime, shared by every project that compiles it
+function runtime_configuration()
         location "../"
         objdir(OBJ_DIR)
         cppdialect(CPP_VERSION)
-        kind "WindowedApp"
         staticruntime "On"
         defines { API_CPP_DEFINE }
         libdirs { LIBRARY_DIR }
 
         files {
             RUNTIME_DIR .. "/**.h",   RUNTIME_DIR .. "/**.cpp",
-            RUNTIME_DIR .. "/**.hpp", RUNTIME_DIR .. "/**.inl",
-            EDITOR_DIR .. "/**.h",    EDITOR_DIR .. "/**.cpp",
-            EDITOR_DIR .. "/**.hpp",  EDITOR_DIR .. "/**.inl",
-            RUNTIME_DIR .. "/**.rc"
+            RUNTIME_DIR .. "/**.hpp", RUNTIME_DIR .. "/**.inl"
         }
 
         if ARG_API_GRAPHICS == "d3d12" then
@@ -153,9 +155,6 @@ function spartan_project_configuration()
 
         -- Release configuration
         filter { "configurations:release" }
-            targetname(EXECUTABLE_NAME)
-            targetdir(TARGET_DIR)
-            debugdir(TARGET_DIR)
             links { "dxcompiler", "assimp", "FreeImageLib", "freetype", "SDL3", "Compressonator_MT", "meshoptimizer" }
             links {
                 "PhysX_static_64", "PhysXCommon_static_64", "PhysXFoundation_static_64", "PhysXExtensions_static_64",
@@ -173,9 +172,6 @@ function spartan_project_configuration()
 
         -- Debug configuration
         filter { "configurations:debug" }
-            targetname(EXECUTABLE_NAME .. "_debug")
-            targetdir(TARGET_DIR)
-            debugdir(TARGET_DIR)
             links { "dxcompiler" }
 
         filter { "configurations:debug", "system:windows" }
@@ -194,8 +190,54 @@ function spartan_project_configuration()
 
         filter { "configurations:debug", "system:linux" }
             links { "assimp", "FreeImageLib", "freetype", "SDL3", "Compressonator_MT" }
+
+        filter {}
+end
+
+-- the project's output goes to the binaries folder, debug builds get a suffix
+function target_configuration(name)
+        filter { "configurations:release" }
+            targetname(name)
+            targetdir(TARGET_DIR)
+            debugdir(TARGET_DIR)
+
+        filter { "configurations:debug" }
+            targetname(name .. "_debug")
+            targetdir(TARGET_DIR)
+            debugdir(TARGET_DIR)
+
+        filter {}
+end
+
+function spartan_project_configuration()
+    project(SOLUTION_NAME)
+        kind "WindowedApp"
+        runtime_configuration()
+        target_configuration(EXECUTABLE_NAME)
+
+        files {
+            EDITOR_DIR .. "/**.h",    EDITOR_DIR .. "/**.cpp",
+            EDITOR_DIR .. "/**.hpp",  EDITOR_DIR .. "/**.inl",
+            RUNTIME_DIR .. "/**.rc"
+        }
+end
+
+-- opt-in, generated with --benchmarks
+function benchmarks_project_configuration()
+    project("benchmarks")
+        kind "ConsoleApp"
+        runtime_configuration()
+        target_configuration("benchmarks")
+        includedirs { BENCHMARKS_DIR }
+
+        files {
+            BENCHMARKS_DIR .. "/**.h", BENCHMARKS_DIR .. "/**.cpp"
+        }
 end
 
 configure_graphics_api()
 solution_configuration()
 spartan_project_configuration()
+if _OPTIONS["benchmarks"] then
+    benchmarks_project_configuration()
+end
@@ -0,0 +1,79 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =========
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <cfloat>
+#include "Stopwatch.h"
+//====================
+
+namespace spartan::benchmark
+{
+    using Function = void(*)();
+
+    // registers a benchmark so main() can list and run it by name
+    struct Registration
+    {
+        Registration(const char* name, Function function);
+    };
+
+    // runs a function a few times and returns the best time in milliseconds, the first run warms caches
+    template<typename F>
+    float measure_ms(F&& function, const uint32_t runs = 5)
+    {
+        float best = FLT_MAX;
+        for (uint32_t i = 0; i < runs; i++)
+        {
+            Stopwatch stopwatch;
+            function();
+            best = std::min(best, stopwatch.GetElapsedTimeMs());
+        }
+
+        return best;
+    }
+
+    // for benchmarks that need the renderer (gpu buffers etc.), initializes the whole engine once, it's shut down on exit
+    void require_engine();
+
+    inline void report(const char* label, const float ms)
+    {
+        printf("    %-48s %10.2f ms\n", label, ms);
+    }
+
+    // keeps the optimizer from removing a result that is otherwise unused, the address escapes through a volatile store
+    // so the value has to be in memory, a volatile local sink instead trips -Wunused-but-set-variable on gcc
+    inline const void* volatile sink = nullptr;
+
+    template<typename T>
+    void keep(const T& value)
+    {
+        sink = &value;
+    }
+}
+
+#define SP_BENCHMARK(name)                                                                                    \
+    static void benchmark_##name();                                                                           \
+    static spartan::benchmark::Registration benchmark_registration_##name(#name, benchmark_##name);           \
+    static void benchmark_##name()
@@ -0,0 +1,258 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "pch.h"
+#include "Benchmark.h"
+#include "Memory/Allocator.h"
+//=============================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace spartan;
+//==================
+
+namespace
+{
+    // the allocator the size-class slabs replaced, a header per allocation, global atomic counters
+    // and a small thread-local cache for sizes up to 256 bytes
+    namespace legacy
+    {
+        constexpr size_t cache_max_size     = 256;
+        constexpr size_t cache_max_entries  = 32;
+        constexpr size_t cache_size_classes = 8;
+        constexpr size_t cache_granularity  = 32;
+        constexpr size_t alignment          = 16;
+
+        atomic<size_t> bytes_allocated      = 0;
+        atomic<size_t> bytes_allocated_peak = 0;
+        atomic<size_t> allocation_count     = 0;
+        atomic<size_t> bytes_by_tag         = 0;
+
+        struct header
+        {
+            uint32_t magic;
+            uint32_t offset;
+            size_t size;
+        };
+
+        struct thread_cache
+        {
+            void* entries[cache_size_classes][cache_max_entries];
+            size_t count[cache_size_classes] = {};
+        };
+        thread_local thread_cache cache = {};
+
+        size_t size_class(const size_t size)
+        {
+            return size == 0 ? 0 : min((size - 1) / cache_granularity, cache_size_classes - 1);
+        }
+
+        void* allocate_internal(const size_t size)
+        {
+            const size_t total = (size + sizeof(header) + alignment + alignment - 1) & ~(alignment - 1);
+#if defined(_MSC_VER)
+            void* raw = _aligned_malloc(total, alignment);
+#else
+            void* raw = aligned_alloc(alignment, total);
+#endif
+
+            const uintptr_t user = (reinterpret_cast<uintptr_t>(raw) + sizeof(header) + alignment - 1) & ~(alignment - 1);
+            header* h            = reinterpret_cast<header*>(user - sizeof(header));
+            h->magic             = 0xABCD1234;
+            h->offset            = static_cast<uint32_t>(user - reinterpret_cast<uintptr_t>(raw));
+            h->size              = size;
+
+            const size_t current = bytes_allocated.fetch_add(size, memory_order_relaxed) + size;
+            size_t peak          = bytes_allocated_peak.load(memory_order_relaxed);
+            while (current > peak && !bytes_allocated_peak.compare_exchange_weak(peak, current, memory_order_relaxed)) {}
+            allocation_count.fetch_add(1, memory_order_relaxed);
+            bytes_by_tag.fetch_add(size, memory_order_relaxed);
+
+            return reinterpret_cast<void*>(user);
+        }
+
+        void* allocate(size_t size)
+        {
+            if (size <= cache_max_size)
+            {
+                const size_t index = size_class(size);
+                if (cache.count[index] > 0)
+                {
+                    void* ptr  = cache.entries[index][--cache.count[index]];
+                    header* h  = reinterpret_cast<header*>(static_cast<char*>(ptr) - sizeof(header));
+                    h->magic   = 0xABCD1234;
+                    bytes_by_tag.fetch_add(h->size, memory_order_relaxed);
+                    return ptr;
+                }
+
+                size = (index + 1) * cache_granularity;
+            }
+
+            return allocate_internal(size);
+        }
+
+        void deallocate(void* ptr)
+        {
+            header* h = reinterpret_cast<header*>(static_cast<char*>(ptr) - sizeof(header));
+            SP_ASSERT(h->magic == 0xABCD1234);
+            bytes_by_tag.fetch_sub(h->size, memory_order_relaxed);
+
+            if (h->size <= cache_max_size)
+            {
+                const size_t index = size_class(h->size);
+                if (cache.count[index] < cache_max_entries)
+                {
+                    h->magic                                   = 0xDEADBEEF;
+                    cache.entries[index][cache.count[index]++] = ptr;
+                    return;
+                }
+            }
+
+            h->magic = 0xDEADBEEF;
+            bytes_allocated.fetch_sub(h->size, memory_order_relaxed);
+            allocation_count.fetch_sub(1, memory_order_relaxed);
+#if defined(_MSC_VER)
+            _aligned_free(static_cast<char*>(ptr) - h->offset);
+#else
+            ::free(static_cast<char*>(ptr) - h->offset);
+#endif
+        }
+    }
+
+    constexpr uint32_t thread_count     = 4;
+    constexpr uint32_t ops_per_thread   = 2000000;
+    constexpr uint32_t live_slots       = 1024;
+    constexpr uint32_t remote_free_odds = 8; // one in this many frees is handed to another thread
+    constexpr uint32_t drain_interval   = 64;
+
+    // frees handed over from other threads
+    struct inbox
+    {
+        mutex lock;
+        vector<void*> pointers;
+    };
+
+    // every thread keeps a set of live allocations of random sizes and replaces a random one per op
+    template<typename Allocate, typename Deallocate>
+    void run(Allocate allocate, Deallocate deallocate)
+    {
+        array<inbox, thread_count> inboxes;
+        atomic<uint32_t> running = thread_count;
+
+        auto drain = [&](inbox& box)
+        {
+            vector<void*> pointers;
+            {
+                lock_guard<mutex> guard(box.lock);
+                pointers.swap(box.pointers);
+            }
+
+            for (void* ptr : pointers)
+            {
+                deallocate(ptr);
+            }
+        };
+
+        vector<thread> threads;
+        for (uint32_t t = 0; t < thread_count; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                mt19937 random(t + 1);
+                uniform_int_distribution<uint32_t> size_distribution(16, 2048);
+                array<void*, live_slots> live = {};
+
+                for (uint32_t op = 0; op < ops_per_thread; op++)
+                {
+                    void*& slot = live[random() % live_slots];
+                    if (slot)
+                    {
+                        if (random() % remote_free_odds == 0)
+                        {
+                            inbox& box = inboxes[(t + 1) % thread_count];
+                            lock_guard<mutex> guard(box.lock);
+                            box.pointers.push_back(slot);
+                        }
+                        else
+                        {
+                            deallocate(slot);
+                        }
+                    }
+                    slot = allocate(size_distribution(random));
+
+                    if (op % drain_interval == 0)
+                    {
+                        drain(inboxes[t]);
+                    }
+                }
+
+                for (void* ptr : live)
+                {
+                    if (ptr)
+                    {
+                        deallocate(ptr);
+                    }
+                }
+
+                // keep draining until every thread is done handing over frees
+                running.fetch_sub(1);
+                while (running.load() > 0)
+                {
+                    drain(inboxes[t]);
+                    this_thread::yield();
+                }
+                drain(inboxes[t]);
+            });
+        }
+
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+
+        // frees handed over after the owner's last drain
+        for (inbox& box : inboxes)
+        {
+            drain(box);
+        }
+    }
+}
+
+SP_BENCHMARK(allocator)
+{
+    printf("    %u threads x %u ops, 16-2048 bytes, 1/%u of the frees on another thread\n", thread_count, ops_per_thread, remote_free_odds);
+
+    benchmark::report("legacy allocator", benchmark::measure_ms([]()
+    {
+        run([](size_t size) { return legacy::allocate(size); }, [](void* ptr) { legacy::deallocate(ptr); });
+    }, 3));
+
+    benchmark::report("Allocator", benchmark::measure_ms([]()
+    {
+        run([](size_t size) { return Allocator::Allocate(size); }, [](void* ptr) { Allocator::Free(ptr); });
+    }, 3));
+
+    benchmark::report("malloc (reference)", benchmark::measure_ms([]()
+    {
+        run([](size_t size) { return malloc(size); }, [](void* ptr) { free(ptr); });
+    }, 3));
+}
@@ -0,0 +1,92 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========
+#include "pch.h"
+#include "Benchmark.h"
+#include "Math/Frustum.h"
+//======================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan;
+using namespace spartan::math;
+//============================
+
+namespace
+{
+    constexpr uint32_t box_count = 100000;
+}
+
+SP_BENCHMARK(frustum_culling)
+{
+    // reverse-z like the renderer, looking down +z from the origin, boxes scattered all around the camera
+    const Matrix view       = Matrix::CreateLookAtLH(Vector3::Zero, Vector3::Forward, Vector3::Up);
+    const Matrix projection = Matrix::CreatePerspectiveFieldOfViewLH(1.22f, 16.0f / 9.0f, 1000.0f, 0.1f);
+    const Frustum frustum(view, projection);
+
+    mt19937 random(7);
+    uniform_real_distribution<float> position(-500.0f, 500.0f);
+    uniform_real_distribution<float> size(0.1f, 10.0f);
+    vector<float> center_x(box_count), center_y(box_count), center_z(box_count);
+    vector<float> extent_x(box_count), extent_y(box_count), extent_z(box_count);
+    for (uint32_t i = 0; i < box_count; i++)
+    {
+        center_x[i] = position(random);
+        center_y[i] = position(random);
+        center_z[i] = position(random);
+        extent_x[i] = size(random);
+        extent_y[i] = size(random);
+        extent_z[i] = size(random);
+    }
+
+    vector<uint8_t> visible_single(box_count);
+    vector<uint8_t> visible_batched(box_count);
+
+    benchmark::report("100k boxes, IsVisible per box", benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < box_count; i++)
+        {
+            const Vector3 center(center_x[i], center_y[i], center_z[i]);
+            const Vector3 extent(extent_x[i], extent_y[i], extent_z[i]);
+            visible_single[i] = frustum.IsVisible(center, extent) ? 1 : 0;
+        }
+    }, 20));
+
+    benchmark::report("100k boxes, AreVisible", benchmark::measure_ms([&]()
+    {
+        frustum.AreVisible(
+            center_x.data(), center_y.data(), center_z.data(),
+            extent_x.data(), extent_y.data(), extent_z.data(),
+            box_count, visible_batched.data()
+        );
+    }, 20));
+
+    // the batched path has to agree with the scalar one on every box
+    uint32_t mismatches = 0;
+    uint32_t visible    = 0;
+    for (uint32_t i = 0; i < box_count; i++)
+    {
+        mismatches += visible_single[i] != visible_batched[i];
+        visible    += visible_batched[i];
+    }
+    printf("    %u visible, %u mismatches\n", visible, mismatches);
+}
@@ -0,0 +1,175 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "pch.h"
+#include "Benchmark.h"
+#include "Geometry/Mesh.h"
+#include "Geometry/GeometryGeneration.h"
+//=====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan;
+using namespace spartan::math;
+//============================
+
+namespace
+{
+    constexpr uint32_t sub_mesh_count       = 16;
+    constexpr uint32_t grid_points          = 256; // per dimension, so 64k vertices per sub-mesh
+    constexpr const char* file_path_v1      = "benchmark_mesh_v1.mesh";
+    constexpr const char* file_path_v2      = "benchmark_mesh_v2.mesh";
+
+    // the writer of the version 1 format, which SaveToFile no longer produces
+    void save_v1(Mesh& mesh, const string& file_path)
+    {
+        ofstream outfile(file_path, ios::binary);
+
+        const uint32_t version       = 1;
+        const uint32_t type          = static_cast<uint32_t>(mesh.GetType());
+        const uint32_t legacy_field  = 0;
+        const uint32_t flags         = mesh.GetFlags();
+        const uint32_t submesh_count = sub_mesh_count;
+        outfile.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+        outfile.write(reinterpret_cast<const char*>(&type), sizeof(uint32_t));
+        outfile.write(reinterpret_cast<const char*>(&legacy_field), sizeof(uint32_t));
+        outfile.write(reinterpret_cast<const char*>(&flags), sizeof(uint32_t));
+        outfile.write(reinterpret_cast<const char*>(&submesh_count), sizeof(uint32_t));
+
+        for (uint32_t sub_idx = 0; sub_idx < submesh_count; sub_idx++)
+        {
+            const SubMesh& sub = mesh.GetSubMesh(sub_idx);
+            uint32_t lod_count = static_cast<uint32_t>(sub.lods.size());
+            outfile.write(reinterpret_cast<const char*>(&lod_count), sizeof(uint32_t));
+
+            for (const MeshLod& lod : sub.lods)
+            {
+                outfile.write(reinterpret_cast<const char*>(&lod.vertex_offset), sizeof(uint32_t));
+                outfile.write(reinterpret_cast<const char*>(&lod.vertex_count), sizeof(uint32_t));
+                outfile.write(reinterpret_cast<const char*>(&lod.index_offset), sizeof(uint32_t));
+                outfile.write(reinterpret_cast<const char*>(&lod.index_count), sizeof(uint32_t));
+
+                const Vector3 min = lod.aabb.GetMin();
+                const Vector3 max = lod.aabb.GetMax();
+                const float aabb[6] = { min.x, min.y, min.z, max.x, max.y, max.z };
+                outfile.write(reinterpret_cast<const char*>(aabb), sizeof(aabb));
+            }
+        }
+
+        const uint32_t vertex_count = static_cast<uint32_t>(mesh.GetVertices().size());
+        outfile.write(reinterpret_cast<const char*>(&vertex_count), sizeof(uint32_t));
+        outfile.write(reinterpret_cast<const char*>(mesh.GetVertices().data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
+
+        const uint32_t index_count = static_cast<uint32_t>(mesh.GetIndices().size());
+        outfile.write(reinterpret_cast<const char*>(&index_count), sizeof(uint32_t));
+        outfile.write(reinterpret_cast<const char*>(mesh.GetIndices().data()), index_count * sizeof(uint32_t));
+    }
+
+    // the reader the mapped loader replaced, field by field stream reads, cpu side only
+    void load_v1_stream(const string& file_path, vector<RHI_Vertex_PosTexNorTan>& vertices, vector<uint32_t>& indices)
+    {
+        ifstream infile(file_path, ios::binary);
+
+        uint32_t header[5] = {}; // version, type, legacy field, flags, sub-mesh count
+        infile.read(reinterpret_cast<char*>(header), sizeof(header));
+
+        for (uint32_t sub_idx = 0; sub_idx < header[4]; sub_idx++)
+        {
+            uint32_t lod_count = 0;
+            infile.read(reinterpret_cast<char*>(&lod_count), sizeof(uint32_t));
+
+            for (uint32_t lod_idx = 0; lod_idx < lod_count; lod_idx++)
+            {
+                MeshLod lod;
+                infile.read(reinterpret_cast<char*>(&lod.vertex_offset), sizeof(uint32_t));
+                infile.read(reinterpret_cast<char*>(&lod.vertex_count), sizeof(uint32_t));
+                infile.read(reinterpret_cast<char*>(&lod.index_offset), sizeof(uint32_t));
+                infile.read(reinterpret_cast<char*>(&lod.index_count), sizeof(uint32_t));
+
+                float aabb[6];
+                for (float& value : aabb)
+                {
+                    infile.read(reinterpret_cast<char*>(&value), sizeof(float));
+                }
+                lod.aabb = BoundingBox(Vector3(aabb[0], aabb[1], aabb[2]), Vector3(aabb[3], aabb[4], aabb[5]));
+            }
+        }
+
+        uint32_t vertex_count = 0;
+        infile.read(reinterpret_cast<char*>(&vertex_count), sizeof(uint32_t));
+        vertices.resize(vertex_count);
+        infile.read(reinterpret_cast<char*>(vertices.data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
+
+        uint32_t index_count = 0;
+        infile.read(reinterpret_cast<char*>(&index_count), sizeof(uint32_t));
+        indices.resize(index_count);
+        infile.read(reinterpret_cast<char*>(indices.data()), index_count * sizeof(uint32_t));
+    }
+}
+
+SP_BENCHMARK(mesh_load)
+{
+    // gpu buffers are created as part of the load
+    benchmark::require_engine();
+
+    // the same mesh in both formats
+    {
+        Mesh mesh;
+        for (uint32_t i = 0; i < sub_mesh_count; i++)
+        {
+            vector<RHI_Vertex_PosTexNorTan> vertices;
+            vector<uint32_t> indices;
+            geometry_generation::generate_grid(&vertices, &indices, grid_points, 100.0f);
+            mesh.AddGeometry(vertices, indices, false);
+        }
+
+        save_v1(mesh, file_path_v1);
+        mesh.SaveToFile(file_path_v2);
+    }
+
+    printf("    %u sub-meshes, %llu MB file\n", sub_mesh_count, static_cast<unsigned long long>(filesystem::file_size(file_path_v2) / (1024 * 1024)));
+
+    benchmark::report("v1, stream reader (cpu only, before)", benchmark::measure_ms([]()
+    {
+        vector<RHI_Vertex_PosTexNorTan> vertices;
+        vector<uint32_t> indices;
+        load_v1_stream(file_path_v1, vertices, indices);
+        benchmark::keep(vertices.size() + indices.size());
+    }));
+
+    benchmark::report("v1, Mesh::LoadFromFile", benchmark::measure_ms([]()
+    {
+        Mesh mesh;
+        mesh.LoadFromFile(file_path_v1);
+        benchmark::keep(mesh.GetVertexCount());
+    }));
+
+    benchmark::report("v2, Mesh::LoadFromFile", benchmark::measure_ms([]()
+    {
+        Mesh mesh;
+        mesh.LoadFromFile(file_path_v2);
+        benchmark::keep(mesh.GetVertexCount());
+    }));
+
+    filesystem::remove(file_path_v1);
+    filesystem::remove(file_path_v2);
+}
@@ -0,0 +1,144 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "pch.h"
+#include "Benchmark.h"
+#include "Resource/ResourceCache.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace spartan;
+//==================
+
+namespace
+{
+    constexpr uint32_t resource_count       = 100000;
+    constexpr uint32_t lookup_count         = 1000000;
+    constexpr uint32_t lookup_count_legacy  = 1000; // a scan per lookup, extrapolated to lookup_count
+    constexpr ResourceType resource_type    = ResourceType::Texture;
+
+    // cached only for lookups, never loaded
+    class benchmark_resource : public IResource
+    {
+    public:
+        benchmark_resource() : IResource(resource_type) {}
+    };
+
+    // the lookups the hash index replaced, a locked scan with string compares
+    shared_ptr<IResource> legacy_get_by_path(const string& path)
+    {
+        lock_guard<mutex> guard(ResourceCache::GetMutex());
+        for (shared_ptr<IResource>& resource : ResourceCache::GetResources())
+        {
+            if (path == resource->GetResourceFilePath())
+                return resource;
+        }
+
+        return nullptr;
+    }
+
+    shared_ptr<IResource> legacy_get_by_name(const string& name)
+    {
+        lock_guard<mutex> guard(ResourceCache::GetMutex());
+        for (shared_ptr<IResource>& resource : ResourceCache::GetResources())
+        {
+            if (name == resource->GetObjectName())
+                return resource;
+        }
+
+        return nullptr;
+    }
+}
+
+SP_BENCHMARK(resource_cache)
+{
+    vector<shared_ptr<IResource>> resources(resource_count);
+    benchmark::report("cache 100k resources", benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < resource_count; i++)
+        {
+            resources[i] = make_shared<benchmark_resource>();
+            resources[i]->SetResourceFilePath("benchmark/resource_" + to_string(i) + ".texture");
+            ResourceCache::Cache(resources[i]);
+        }
+    }, 1));
+
+    // the same random hits for every variant, strings built up front so only the lookup is timed
+    mt19937 random(7);
+    uniform_int_distribution<uint32_t> distribution(0, resource_count - 1);
+    vector<string> paths(lookup_count);
+    vector<string> names(lookup_count);
+    for (uint32_t i = 0; i < lookup_count; i++)
+    {
+        const uint32_t index = distribution(random);
+        paths[i]             = resources[index]->GetResourceFilePath();
+        names[i]             = resources[index]->GetObjectName();
+    }
+
+    uint32_t hits = 0;
+    const float scale = static_cast<float>(lookup_count) / static_cast<float>(lookup_count_legacy);
+
+    benchmark::report("1M GetByPath, linear scan (extrapolated)", scale * benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < lookup_count_legacy; i++)
+        {
+            hits += legacy_get_by_path(paths[i]) != nullptr;
+        }
+    }, 1));
+
+    benchmark::report("1M GetByPath", benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < lookup_count; i++)
+        {
+            hits += ResourceCache::GetByPath(paths[i]) != nullptr;
+        }
+    }));
+
+    benchmark::report("1M GetByName, linear scan (extrapolated)", scale * benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < lookup_count_legacy; i++)
+        {
+            hits += legacy_get_by_name(names[i]) != nullptr;
+        }
+    }, 1));
+
+    benchmark::report("1M GetByName", benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < lookup_count; i++)
+        {
+            hits += ResourceCache::GetByName(names[i], resource_type) != nullptr;
+        }
+    }));
+
+    // random order, so most removals move the last slot into the hole
+    shuffle(resources.begin(), resources.end(), random);
+    benchmark::report("remove 100k resources", benchmark::measure_ms([&]()
+    {
+        for (shared_ptr<IResource>& resource : resources)
+        {
+            ResourceCache::Remove(resource.get());
+        }
+    }, 1));
+
+    benchmark::keep(hits);
+}
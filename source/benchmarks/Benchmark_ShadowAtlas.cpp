@@ -0,0 +1,167 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====================
+#include "pch.h"
+#include "Benchmark.h"
+#include "Rendering/ShadowAtlas.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace spartan;
+//==================
+
+namespace
+{
+    constexpr uint32_t atlas_resolution   = 8192;
+    constexpr uint32_t update_count       = 500;
+    constexpr float coverage_drift        = 0.05f; // per update
+    constexpr uint32_t cascade_count      = 2;
+    constexpr uint32_t point_light_slices = 6;
+
+    // the largest uniform slice size the scanline packer the atlas replaced could fit
+    uint32_t legacy_uniform_res(const uint32_t slice_count)
+    {
+        auto can_fit = [&](const uint32_t res)
+        {
+            uint32_t x = 0, y = 0;
+            for (uint32_t i = 0; i < slice_count; i++)
+            {
+                uint32_t placed_x = x == 0 ? 0 : x + ShadowAtlas::border;
+                if (placed_x + res > atlas_resolution)
+                {
+                    y        += res + ShadowAtlas::border;
+                    placed_x  = 0;
+                }
+
+                if (y + res > atlas_resolution)
+                    return false;
+
+                x = placed_x + res;
+            }
+
+            return true;
+        };
+
+        uint32_t low  = ShadowAtlas::cell_min;
+        uint32_t high = atlas_resolution;
+        while (low < high)
+        {
+            const uint32_t mid = (low + high + 1) / 2;
+            if (can_fit(mid)) low = mid; else high = mid - 1;
+        }
+
+        return low;
+    }
+
+    // one directional light and point lights whose coverage drifts like a moving camera would make it
+    void simulate(const uint32_t point_light_count)
+    {
+        // the atlas only compares light pointers, so any unique address will do
+        vector<uint8_t> light_ids(point_light_count + 1);
+        auto light = [&](const uint32_t index) { return reinterpret_cast<Light*>(&light_ids[index]); };
+
+        mt19937 random(point_light_count);
+        uniform_real_distribution<float> coverage_initial(0.05f, 1.0f);
+        uniform_real_distribution<float> drift(-coverage_drift, coverage_drift);
+        vector<float> coverage(point_light_count);
+        for (float& value : coverage)
+        {
+            value = coverage_initial(random);
+        }
+
+        ShadowAtlas atlas;
+        double occupancy_sum    = 0.0;
+        uint32_t repacks        = 0;
+        uint32_t moved          = 0;
+        uint32_t unplaced       = 0;
+        uint32_t cascade_res    = 0;
+        float update_ms         = 0.0f;
+        for (uint32_t update = 0; update < update_count; update++)
+        {
+            vector<ShadowSlice> slices;
+            for (uint32_t i = 0; i < cascade_count; i++)
+            {
+                const uint32_t cell = ShadowAtlas::GetCellSize(true, 1.0f, atlas_resolution, atlas.GetCellRequested(light(0), i));
+                slices.push_back({ light(0), i, cell, math::Rectangle::Zero, cell, true });
+            }
+
+            for (uint32_t l = 0; l < point_light_count; l++)
+            {
+                coverage[l] = clamp(coverage[l] * (1.0f + drift(random)), 0.01f, 1.0f);
+                for (uint32_t i = 0; i < point_light_slices; i++)
+                {
+                    const uint32_t cell = ShadowAtlas::GetCellSize(false, coverage[l], atlas_resolution, atlas.GetCellRequested(light(l + 1), i));
+                    slices.push_back({ light(l + 1), i, cell, math::Rectangle::Zero, cell, false });
+                }
+            }
+
+            const vector<ShadowSlice> previous = atlas.GetSlices();
+            Stopwatch stopwatch;
+            atlas.Update(atlas_resolution, move(slices));
+            update_ms += stopwatch.GetElapsedTimeMs();
+
+            // the first update places everything from scratch, it doesn't count as a repack
+            repacks += update > 0 && atlas.WasRepacked();
+
+            uint64_t area = 0;
+            for (const ShadowSlice& slice : atlas.GetSlices())
+            {
+                if (!slice.rect.IsDefined())
+                {
+                    unplaced++;
+                    continue;
+                }
+
+                area += static_cast<uint64_t>(slice.res) * slice.res;
+                if (slice.directional)
+                {
+                    cascade_res = static_cast<uint32_t>(slice.rect.width);
+                }
+
+                // slices that kept their cell size but had to move anyway
+                auto it = find_if(previous.begin(), previous.end(), [&](const ShadowSlice& p) { return p.light == slice.light && p.slice_index == slice.slice_index; });
+                if (it != previous.end() && it->res == slice.res && (it->rect.x != slice.rect.x || it->rect.y != slice.rect.y))
+                {
+                    moved++;
+                }
+            }
+            occupancy_sum += static_cast<double>(area) / (static_cast<double>(atlas_resolution) * atlas_resolution);
+        }
+
+        const uint32_t slice_count = cascade_count + point_light_count * point_light_slices;
+        printf("    %6u %7u %16u %9.1f%% %8u %13.2f %9u %10u %9.3f\n",
+            point_light_count, slice_count, legacy_uniform_res(slice_count),
+            100.0 * occupancy_sum / update_count, repacks, static_cast<float>(moved) / update_count,
+            unplaced, cascade_res, update_ms / update_count);
+    }
+}
+
+SP_BENCHMARK(shadow_atlas)
+{
+    printf("    %u updates on a %u atlas, point light coverage drifts %.0f%% per update\n", update_count, atlas_resolution, coverage_drift * 100.0f);
+    printf("    %6s %7s %16s %10s %8s %13s %9s %10s %9s\n", "lights", "slices", "old uniform res", "occupancy", "repacks", "moved/update", "unplaced", "cascade", "ms/update");
+    for (uint32_t point_light_count : { 2u, 8u, 16u, 32u, 64u })
+    {
+        simulate(point_light_count);
+    }
+}
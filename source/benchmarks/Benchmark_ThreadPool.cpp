@@ -0,0 +1,193 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========
+#include "pch.h"
+#include "Benchmark.h"
+#include "ThreadPool.h"
+//====================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace spartan;
+//==================
+
+namespace
+{
+    // the pool the job system replaced, one mutex guarded deque and a future per parallel loop chunk
+    class legacy_pool
+    {
+    public:
+        legacy_pool()
+        {
+            const uint32_t hw_threads = max(4u, thread::hardware_concurrency());
+            const uint32_t core_count = max(1u, hw_threads / 2);
+            const uint32_t count      = min(core_count * 2, core_count + 4);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                m_threads.emplace_back([this]() { thread_loop(); });
+            }
+        }
+
+        ~legacy_pool()
+        {
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_cv.notify_all();
+
+            for (thread& t : m_threads)
+            {
+                t.join();
+            }
+        }
+
+        future<void> add_task(Task&& task)
+        {
+            auto packaged       = make_shared<packaged_task<void()>>(std::move(task));
+            future<void> result = packaged->get_future();
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_tasks.emplace_back([packaged]() { (*packaged)(); });
+            }
+            m_cv.notify_one();
+
+            return result;
+        }
+
+        void parallel_loop(function<void(uint32_t, uint32_t)>&& function, const uint32_t work_total)
+        {
+            const uint32_t workers   = min(static_cast<uint32_t>(m_threads.size()), work_total);
+            const uint32_t base_work = work_total / workers;
+            const uint32_t remainder = work_total % workers;
+
+            vector<future<void>> futures;
+            futures.reserve(workers);
+
+            uint32_t work_index = 0;
+            for (uint32_t i = 0; i < workers; i++)
+            {
+                const uint32_t start = work_index;
+                const uint32_t end   = work_index + base_work + (i < remainder ? 1u : 0u);
+                futures.emplace_back(add_task([fn = function, start, end]() { fn(start, end); }));
+                work_index = end;
+            }
+
+            for (future<void>& f : futures)
+            {
+                f.get();
+            }
+        }
+
+    private:
+        void thread_loop()
+        {
+            while (true)
+            {
+                Task task;
+                {
+                    unique_lock<mutex> lock(m_mutex);
+                    m_cv.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+                    if (m_stopping && m_tasks.empty())
+                        return;
+
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        vector<thread> m_threads;
+        deque<Task> m_tasks;
+        mutex m_mutex;
+        condition_variable m_cv;
+        bool m_stopping = false;
+    };
+
+    constexpr uint32_t loop_count = 20000;
+    constexpr uint32_t loop_items = 4096;
+    constexpr uint32_t task_count = 100000;
+
+    // a little arithmetic per item so the loop cost is dominated by scheduling, like most engine loops
+    void work(vector<float>& data, const uint32_t start, const uint32_t end)
+    {
+        for (uint32_t i = start; i < end; i++)
+        {
+            data[i] = data[i] * 0.5f + 1.0f;
+        }
+    }
+}
+
+SP_BENCHMARK(thread_pool)
+{
+    vector<float> data(loop_items, 1.0f);
+    atomic<uint32_t> completed = 0;
+
+    {
+        legacy_pool pool;
+
+        benchmark::report("parallel loop, legacy pool", benchmark::measure_ms([&]()
+        {
+            for (uint32_t i = 0; i < loop_count; i++)
+            {
+                pool.parallel_loop([&](uint32_t start, uint32_t end) { work(data, start, end); }, loop_items);
+            }
+        }, 3));
+
+        benchmark::report("tasks, legacy pool", benchmark::measure_ms([&]()
+        {
+            vector<future<void>> futures;
+            futures.reserve(task_count);
+            for (uint32_t i = 0; i < task_count; i++)
+            {
+                futures.emplace_back(pool.add_task([&completed]() { completed.fetch_add(1, memory_order_relaxed); }));
+            }
+
+            for (future<void>& f : futures)
+            {
+                f.get();
+            }
+        }, 3));
+    }
+
+    benchmark::report("parallel loop, job system", benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < loop_count; i++)
+        {
+            ThreadPool::ParallelLoop([&](uint32_t start, uint32_t end) { work(data, start, end); }, loop_items);
+        }
+    }, 3));
+
+    benchmark::report("tasks, job system (job counter)", benchmark::measure_ms([&]()
+    {
+        JobCounter counter;
+        for (uint32_t i = 0; i < task_count; i++)
+        {
+            ThreadPool::AddTask([&completed]() { completed.fetch_add(1, memory_order_relaxed); }, counter);
+        }
+        ThreadPool::Wait(counter);
+    }, 3));
+
+    benchmark::keep(data[0]);
+    benchmark::keep(completed.load());
+}
@@ -0,0 +1,108 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ==================
+#include "pch.h"
+#include "Benchmark.h"
+#include "World/World.h"
+#include "World/Entity.h"
+//=============================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace spartan;
+//==================
+
+namespace
+{
+    constexpr uint32_t entity_count        = 100000;
+    constexpr uint32_t lookup_count        = 1000000;
+    constexpr uint32_t lookup_count_legacy = 1000; // a scan per lookup, extrapolated to lookup_count
+
+    // the lookup the id index replaced, a locked scan over the entities
+    mutex legacy_mutex;
+    Entity* legacy_get_entity_by_id(const uint64_t id)
+    {
+        lock_guard<mutex> lock(legacy_mutex);
+        for (Entity* entity : World::GetEntities())
+        {
+            if (entity && entity->GetObjectId() == id)
+                return entity;
+        }
+
+        return nullptr;
+    }
+}
+
+SP_BENCHMARK(world_lookup)
+{
+    // created entities are pending until the next tick
+    for (uint32_t i = 0; i < entity_count; i++)
+    {
+        World::CreateEntity();
+    }
+    World::Tick();
+
+    // the same random hits for every variant
+    const vector<Entity*>& entities = World::GetEntities();
+    mt19937 random(7);
+    uniform_int_distribution<uint32_t> distribution(0, static_cast<uint32_t>(entities.size()) - 1);
+    vector<uint64_t> ids(lookup_count);
+    vector<EntityHandle> handles(lookup_count);
+    for (uint32_t i = 0; i < lookup_count; i++)
+    {
+        Entity* entity = entities[distribution(random)];
+        ids[i]         = entity->GetObjectId();
+        handles[i]     = World::GetEntityHandle(entity);
+    }
+
+    uint32_t hits = 0;
+    const float scale = static_cast<float>(lookup_count) / static_cast<float>(lookup_count_legacy);
+
+    benchmark::report("1M GetEntityById, linear scan (extrapolated)", scale * benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < lookup_count_legacy; i++)
+        {
+            hits += legacy_get_entity_by_id(ids[i]) != nullptr;
+        }
+    }, 1));
+
+    benchmark::report("1M GetEntityById", benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < lookup_count; i++)
+        {
+            hits += World::GetEntityById(ids[i]) != nullptr;
+        }
+    }));
+
+    benchmark::report("1M GetEntity (handle)", benchmark::measure_ms([&]()
+    {
+        for (uint32_t i = 0; i < lookup_count; i++)
+        {
+            hits += World::GetEntity(handles[i]) != nullptr;
+        }
+    }));
+
+    World::Shutdown();
+
+    benchmark::keep(hits);
+}
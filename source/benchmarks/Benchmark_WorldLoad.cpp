@@ -0,0 +1,87 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================
+#include "pch.h"
+#include "Benchmark.h"
+#include "World/World.h"
+#include "World/Entity.h"
+#include "FileSystem/FileSystem.h"
+//============================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan;
+using namespace spartan::math;
+//============================
+
+namespace
+{
+    constexpr uint32_t root_count     = 10000;
+    constexpr uint32_t children_count = 4; // per root, 50k entities in total
+    constexpr uint32_t runs           = 3;
+
+    // loads leave the entities pending, they join on the next tick, which is kept out of the timing
+    float measure_load_ms(const string& file_path)
+    {
+        float best = FLT_MAX;
+        for (uint32_t i = 0; i < runs; i++)
+        {
+            Stopwatch stopwatch;
+            World::LoadFromFile(file_path);
+            best = min(best, stopwatch.GetElapsedTimeMs());
+            World::Tick();
+        }
+
+        return best;
+    }
+}
+
+SP_BENCHMARK(world_load)
+{
+    mt19937 random(7);
+    uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+    for (uint32_t i = 0; i < root_count; i++)
+    {
+        Entity* root = World::CreateEntity();
+        root->SetPosition(Vector3(distribution(random), distribution(random), distribution(random)));
+        for (uint32_t j = 0; j < children_count; j++)
+        {
+            Entity* child = World::CreateEntity();
+            child->SetParent(root);
+            child->SetPositionLocal(Vector3(distribution(random), distribution(random), distribution(random)) * 0.01f);
+        }
+    }
+    World::Tick();
+
+    const string directory   = (filesystem::temp_directory_path() / "spartan_benchmark_world").string();
+    const string path_xml    = directory + "/benchmark" + EXTENSION_WORLD;
+    const string path_binary = directory + "/benchmark" + EXTENSION_WORLD_BINARY;
+    FileSystem::CreateDirectory_(directory);
+    World::SaveToFile(path_xml);
+    World::SaveToFile(path_binary);
+
+    benchmark::report("load 50k entities, xml", measure_load_ms(path_xml));
+    benchmark::report("load 50k entities, binary", measure_load_ms(path_binary));
+
+    World::Shutdown();
+    filesystem::remove_all(directory);
+}
@@ -0,0 +1,115 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========
+#include "pch.h"
+#include "Benchmark.h"
+#include "Engine.h"
+#include "ThreadPool.h"
+//======================
+
+//= NAMESPACES =====
+using namespace std;
+using namespace spartan;
+//==================
+
+namespace
+{
+    struct entry
+    {
+        const char* name;
+        benchmark::Function function;
+    };
+
+    // function local so registrations from other translation units can run in any order
+    vector<entry>& get_entries()
+    {
+        static vector<entry> entries;
+        return entries;
+    }
+
+    bool engine_initialized = false;
+}
+
+namespace spartan::benchmark
+{
+    Registration::Registration(const char* name, Function function)
+    {
+        get_entries().push_back({ name, function });
+    }
+
+    void require_engine()
+    {
+        if (engine_initialized)
+            return;
+
+        // the engine brings up its own thread pool
+        ThreadPool::Shutdown();
+        Engine::Initialize({ "benchmarks" });
+        engine_initialized = true;
+    }
+}
+
+// usage: benchmarks [name ...], runs every benchmark when no name is given
+int main(int argc, char** argv)
+{
+    vector<entry>& entries = get_entries();
+    sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) { return strcmp(a.name, b.name) < 0; });
+
+    ThreadPool::Initialize();
+
+    uint32_t run_count = 0;
+    for (const entry& e : entries)
+    {
+        bool selected = argc <= 1;
+        for (int i = 1; i < argc; i++)
+        {
+            selected |= strcmp(argv[i], e.name) == 0;
+        }
+
+        if (!selected)
+            continue;
+
+        printf("%s\n", e.name);
+        e.function();
+        run_count++;
+    }
+
+    if (run_count == 0)
+    {
+        printf("no benchmark matched, available benchmarks:\n");
+        for (const entry& e : entries)
+        {
+            printf("    %s\n", e.name);
+        }
+    }
+
+    if (engine_initialized)
+    {
+        Engine::Shutdown();
+    }
+    else
+    {
+        ThreadPool::Shutdown();
+    }
+
+    return run_count > 0 ? 0 : 1;
+}
@@ -748,7 +748,7 @@ void FileDialog::DialogUpdateFromDirectory(const string& file_path)
     {
         for (const string& anything : paths_anything)
         {
-            if (FileSystem::GetExtensionFromFilePath(anything) == EXTENSION_WORLD)
+            if (FileSystem::IsEngineWorldFile(anything))
             {
                 m_items.emplace_back(anything, spartan::ResourceCache::GetIcon(spartan::IconType::World));
             }
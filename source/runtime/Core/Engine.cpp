@@ -131,6 +131,7 @@ namespace spartan
         Input::Tick();
         PhysicsWorld::Tick();
         World::Tick();
+        PhysicsWorld::PostTick();
         Renderer::Tick();
         Allocator::Tick();
 
@@ -49,6 +49,21 @@ namespace spartan
         m_text      = text;
     }
 
+    void Progress::AddJobs(const uint32_t job_count, const string& text)
+    {
+        lock_guard lock(mutex_jobs);
+
+        // finished progress starts over, so the fraction is that of the work in flight
+        if (m_jobs_done == m_job_count)
+        {
+            m_job_count = 0;
+            m_jobs_done = 0;
+        }
+
+        m_job_count += job_count;
+        m_text       = text;
+    }
+
     float Progress::GetFraction() const
     {
         lock_guard lock(mutex_jobs);
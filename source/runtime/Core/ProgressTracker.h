@@ -39,6 +39,8 @@ namespace spartan
     {
     public:
         void Start(const uint32_t job_count, const std::string& text);
+        // for work that can overlap with other work of the same type, the jobs are added to what's in flight
+        void AddJobs(const uint32_t job_count, const std::string& text);
 
         float GetFraction() const;
         void JobDone();
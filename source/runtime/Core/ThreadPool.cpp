@@ -32,52 +32,508 @@ namespace spartan
 {
     namespace
     {
+        constexpr uint32_t job_pool_size               = 4096; // jobs that can be in flight before falling back to the heap
+        constexpr uint32_t queue_capacity              = 4096; // per worker deque and injection queue capacity (power of two)
+        constexpr uint32_t loop_slot_count             = 64;   // concurrent parallel loops before falling back to serial execution
+        constexpr uint32_t loop_chunks_per_participant = 64;   // lower bound for chunk size, keeps the tail of guided scheduling short
+        constexpr uint32_t spin_count_before_sleep     = 64;
+        constexpr uint32_t invalid_worker              = numeric_limits<uint32_t>::max();
+
+        struct Job
+        {
+            Task task;                           // work to execute
+            void (*entry)(Job*)      = nullptr;  // alternative entry point, used by parallel loop helpers
+            JobCounter* counter      = nullptr;  // decremented when the job completes
+            Job* next_dependent      = nullptr;  // intrusive list of jobs waiting on a counter
+            uint32_t loop_slot       = 0;
+            uint32_t loop_generation = 0;
+            TaskPriority priority    = TaskPriority::Normal;
+            bool from_heap           = false;
+        };
+
+        // bounded multi-producer/multi-consumer queue (dmitry vyukov's design)
+        template<typename T, uint32_t capacity>
+        class mpmc_queue
+        {
+        public:
+            mpmc_queue()
+            {
+                Reset();
+            }
+
+            void Reset()
+            {
+                for (uint32_t i = 0; i < capacity; i++)
+                {
+                    m_cells[i].sequence.store(i, memory_order_relaxed);
+                }
+                m_enqueue_pos.store(0, memory_order_relaxed);
+                m_dequeue_pos.store(0, memory_order_relaxed);
+            }
+
+            bool Push(T data)
+            {
+                size_t pos = m_enqueue_pos.load(memory_order_relaxed);
+                cell* c    = nullptr;
+                while (true)
+                {
+                    c               = &m_cells[pos & (capacity - 1)];
+                    size_t sequence = c->sequence.load(memory_order_acquire);
+                    intptr_t diff   = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                    if (diff == 0)
+                    {
+                        if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                            break;
+                    }
+                    else if (diff < 0)
+                    {
+                        return false; // full
+                    }
+                    else
+                    {
+                        pos = m_enqueue_pos.load(memory_order_relaxed);
+                    }
+                }
+
+                c->data = data;
+                c->sequence.store(pos + 1, memory_order_release);
+                return true;
+            }
+
+            bool Pop(T& data)
+            {
+                size_t pos = m_dequeue_pos.load(memory_order_relaxed);
+                cell* c    = nullptr;
+                while (true)
+                {
+                    c               = &m_cells[pos & (capacity - 1)];
+                    size_t sequence = c->sequence.load(memory_order_acquire);
+                    intptr_t diff   = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+                    if (diff == 0)
+                    {
+                        if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                            break;
+                    }
+                    else if (diff < 0)
+                    {
+                        return false; // empty
+                    }
+                    else
+                    {
+                        pos = m_dequeue_pos.load(memory_order_relaxed);
+                    }
+                }
+
+                data = c->data;
+                c->sequence.store(pos + capacity, memory_order_release);
+                return true;
+            }
+
+        private:
+            static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+            struct cell
+            {
+                atomic<size_t> sequence = 0;
+                T data                  = {};
+            };
+
+            cell m_cells[capacity];
+            alignas(64) atomic<size_t> m_enqueue_pos = 0;
+            alignas(64) atomic<size_t> m_dequeue_pos = 0;
+        };
+
+        // chase-lev work stealing deque, the owning worker pushes and pops at the bottom, thieves steal from the top
+        class work_stealing_queue
+        {
+        public:
+            bool Push(Job* job)
+            {
+                int64_t bottom = m_bottom.load(memory_order_relaxed);
+                int64_t top    = m_top.load(memory_order_acquire);
+                if (bottom - top >= static_cast<int64_t>(queue_capacity))
+                    return false;
+
+                m_jobs[bottom & (queue_capacity - 1)].store(job, memory_order_relaxed);
+                m_bottom.store(bottom + 1, memory_order_release);
+                return true;
+            }
+
+            Job* Pop()
+            {
+                int64_t bottom = m_bottom.load(memory_order_relaxed) - 1;
+                m_bottom.store(bottom, memory_order_relaxed);
+                atomic_thread_fence(memory_order_seq_cst);
+                int64_t top = m_top.load(memory_order_relaxed);
+
+                if (top > bottom)
+                {
+                    // empty
+                    m_bottom.store(bottom + 1, memory_order_relaxed);
+                    return nullptr;
+                }
+
+                Job* job = m_jobs[bottom & (queue_capacity - 1)].load(memory_order_relaxed);
+                if (top == bottom)
+                {
+                    // last job, race against thieves for it
+                    if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+                    {
+                        job = nullptr;
+                    }
+                    m_bottom.store(bottom + 1, memory_order_relaxed);
+                }
+
+                return job;
+            }
+
+            Job* Steal()
+            {
+                int64_t top = m_top.load(memory_order_acquire);
+                atomic_thread_fence(memory_order_seq_cst);
+                int64_t bottom = m_bottom.load(memory_order_acquire);
+                if (top >= bottom)
+                    return nullptr;
+
+                Job* job = m_jobs[top & (queue_capacity - 1)].load(memory_order_relaxed);
+                if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+                    return nullptr; // lost the race
+
+                return job;
+            }
+
+        private:
+            alignas(64) atomic<int64_t> m_top    = 0;
+            alignas(64) atomic<int64_t> m_bottom = 0;
+            atomic<Job*> m_jobs[queue_capacity]  = {};
+        };
+
+        // shared state of a parallel loop, helpers reference it by slot and generation so stale helpers can be detected
+        struct parallel_loop
+        {
+            atomic<bool> in_use         = false;
+            atomic<uint32_t> generation = 0;
+            atomic<uint32_t> references = 0; // helpers currently inside the loop
+            atomic<uint32_t> next       = 0; // next unclaimed work index
+            atomic<uint32_t> completed  = 0; // work items done
+            uint32_t total              = 0;
+            uint32_t participants       = 0;
+            uint32_t min_chunk          = 1;
+            const function<void(uint32_t, uint32_t)>* work = nullptr;
+        };
+
         uint32_t thread_count           = 0;
-        atomic<uint32_t> working_count  = 0;
-        atomic<uint32_t> pending_count  = 0;
-        bool stopping                   = false;
+        atomic<uint32_t> working_count  = 0; // workers executing a job
+        atomic<uint32_t> pending_count  = 0; // jobs created (queued, running or parked on a dependency) but not yet completed
+        atomic<uint32_t> queued_count   = 0; // jobs sitting in a queue
+        atomic<uint32_t> sleeping_count = 0;
+        atomic<bool> stopping           = false;
 
-        mutex task_mutex;
-        condition_variable task_cv;      // signaled when tasks are added or stopping
-        condition_variable idle_cv;      // signaled when a task completes
+        mutex sleep_mutex;
+        condition_variable sleep_cv; // signaled when jobs are added or stopping
 
         vector<thread> threads;
-        deque<Task> tasks;
+        vector<unique_ptr<work_stealing_queue>> worker_queues;
+        mpmc_queue<Job*, queue_capacity> injection_queues[static_cast<uint32_t>(TaskPriority::Max)]; // jobs submitted from non-worker threads, or with a non-normal priority
+        mpmc_queue<uint32_t, job_pool_size> free_jobs;
+        Job job_pool[job_pool_size];
+        parallel_loop loops[loop_slot_count];
+
+        // index of the current thread in worker_queues, used to push locally and to detect workers
+        thread_local uint32_t worker_index = invalid_worker;
+    }
+
+    // counter internals are only touched by the pool
+    struct JobCounterAccess
+    {
+        static void Lock(JobCounter& counter)
+        {
+            while (counter.m_lock.exchange(true, memory_order_acquire))
+            {
+                this_thread::yield();
+            }
+        }
+
+        static void Unlock(JobCounter& counter)
+        {
+            counter.m_lock.store(false, memory_order_release);
+        }
+
+        static atomic<uint32_t>& Value(JobCounter& counter)
+        {
+            return counter.m_value;
+        }
+
+        // parks a job on the counter, returns false if the counter is already zero
+        static bool AddDependent(JobCounter& counter, Job* job)
+        {
+            Lock(counter);
+            bool parked = counter.m_value.load(memory_order_acquire) != 0;
+            if (parked)
+            {
+                job->next_dependent  = static_cast<Job*>(counter.m_dependents);
+                counter.m_dependents = job;
+            }
+            Unlock(counter);
+
+            return parked;
+        }
+
+        // decrements the counter, returns the jobs that were waiting on it if it reached zero
+        static Job* Decrement(JobCounter& counter)
+        {
+            // the lock is held until waiters have been notified, so that a waiter can't destroy the counter under us
+            Job* dependents = nullptr;
+            Lock(counter);
+            if (counter.m_value.fetch_sub(1, memory_order_acq_rel) == 1)
+            {
+                dependents           = static_cast<Job*>(counter.m_dependents);
+                counter.m_dependents = nullptr;
+                counter.m_value.notify_all();
+            }
+            Unlock(counter);
+
+            return dependents;
+        }
+    };
+
+    static Job* job_acquire()
+    {
+        // counted from the moment it exists, so Flush() also waits for jobs which are parked on a dependency
+        pending_count.fetch_add(1, memory_order_relaxed);
+
+        uint32_t index = 0;
+        if (free_jobs.Pop(index))
+            return &job_pool[index];
+
+        // pool exhausted (e.g. thousands of long running tasks), fall back to the heap
+        Job* job       = new Job();
+        job->from_heap = true;
+        return job;
+    }
+
+    static void job_release(Job* job)
+    {
+        job->task           = nullptr;
+        job->entry          = nullptr;
+        job->counter        = nullptr;
+        job->next_dependent = nullptr;
+        job->priority       = TaskPriority::Normal;
 
-        // track if current thread is a worker thread to detect nested ParallelLoop calls
-        thread_local bool is_worker_thread = false;
+        if (job->from_heap)
+        {
+            delete job;
+            return;
+        }
+
+        free_jobs.Push(static_cast<uint32_t>(job - job_pool));
     }
 
-    static void thread_loop()
+    static void wake_worker()
     {
-        is_worker_thread = true;
+        if (sleeping_count.load(memory_order_seq_cst) == 0)
+            return;
 
+        {
+            lock_guard<mutex> lock(sleep_mutex);
+        }
+
+        sleep_cv.notify_one();
+    }
+
+    static void job_execute(Job* job);
+
+    static void job_submit(Job* job)
+    {
+        queued_count.fetch_add(1, memory_order_seq_cst);
+
+        // only normal priority jobs go to the local deque, the other lanes are shared so that every worker honours them
+        bool queued = false;
+        if (worker_index != invalid_worker && job->priority == TaskPriority::Normal)
+        {
+            queued = worker_queues[worker_index]->Push(job);
+        }
+
+        if (!queued)
+        {
+            queued = injection_queues[static_cast<uint32_t>(job->priority)].Push(job);
+        }
+
+        if (!queued)
+        {
+            // every queue is full, run it here rather than dropping it
+            queued_count.fetch_sub(1, memory_order_relaxed);
+            job_execute(job);
+            return;
+        }
+
+        wake_worker();
+    }
+
+    static void job_complete(Job* job)
+    {
+        if (job->counter)
+        {
+            Job* dependents = JobCounterAccess::Decrement(*job->counter);
+            while (dependents)
+            {
+                Job* next = dependents->next_dependent;
+                job_submit(dependents);
+                dependents = next;
+            }
+        }
+
+        job_release(job);
+
+        if (pending_count.fetch_sub(1, memory_order_acq_rel) == 1)
+        {
+            pending_count.notify_all();
+        }
+    }
+
+    static void job_execute(Job* job)
+    {
+        if (job->entry)
+        {
+            job->entry(job);
+        }
+        else
+        {
+            job->task();
+        }
+
+        job_complete(job);
+    }
+
+    static Job* job_find()
+    {
+        if (queued_count.load(memory_order_relaxed) == 0)
+            return nullptr;
+
+        Job* job = nullptr;
+
+        // high priority lane first
+        injection_queues[static_cast<uint32_t>(TaskPriority::High)].Pop(job);
+
+        // then our own deque, it's the most likely to be hot in cache
+        if (!job && worker_index != invalid_worker)
+        {
+            job = worker_queues[worker_index]->Pop();
+        }
+
+        // then normal priority work submitted from outside the pool
+        if (!job)
+        {
+            injection_queues[static_cast<uint32_t>(TaskPriority::Normal)].Pop(job);
+        }
+
+        // then steal from the other workers, starting from our neighbour to spread contention
+        if (!job)
+        {
+            uint32_t start = (worker_index != invalid_worker) ? worker_index + 1 : 0;
+            for (uint32_t i = 0; i < thread_count && !job; i++)
+            {
+                uint32_t victim = (start + i) % thread_count;
+                if (victim != worker_index)
+                {
+                    job = worker_queues[victim]->Steal();
+                }
+            }
+        }
+
+        // low priority work only runs when there is nothing else to do
+        if (!job)
+        {
+            injection_queues[static_cast<uint32_t>(TaskPriority::Low)].Pop(job);
+        }
+
+        if (job)
+        {
+            queued_count.fetch_sub(1, memory_order_relaxed);
+        }
+
+        return job;
+    }
+
+    static void worker_loop(uint32_t index)
+    {
+        worker_index = index;
+
+        uint32_t spin = 0;
         while (true)
         {
-            Task task;
+            if (Job* job = job_find())
             {
-                unique_lock<mutex> lock(task_mutex);
+                working_count.fetch_add(1, memory_order_relaxed);
+                job_execute(job);
+                working_count.fetch_sub(1, memory_order_relaxed);
+                spin = 0;
+                continue;
+            }
 
-                task_cv.wait(lock, [] { return !tasks.empty() || stopping; });
+            if (++spin < spin_count_before_sleep)
+            {
+                this_thread::yield();
+                continue;
+            }
+            spin = 0;
+
+            unique_lock<mutex> lock(sleep_mutex);
+            sleeping_count.fetch_add(1, memory_order_seq_cst);
+            sleep_cv.wait(lock, [] { return queued_count.load(memory_order_seq_cst) > 0 || stopping.load(memory_order_relaxed); });
+            sleeping_count.fetch_sub(1, memory_order_relaxed);
 
-                if (stopping && tasks.empty())
-                    return;
+            if (stopping.load(memory_order_relaxed) && queued_count.load(memory_order_relaxed) == 0)
+                return;
+        }
+    }
 
-                task = std::move(tasks.front());
-                tasks.pop_front();
+    // claim the next chunk, chunks shrink as the loop drains (guided scheduling) so that the tail stays balanced
+    static bool loop_claim(parallel_loop& loop, uint32_t& start, uint32_t& end)
+    {
+        uint32_t current = loop.next.load(memory_order_relaxed);
+        while (current < loop.total)
+        {
+            uint32_t remaining = loop.total - current;
+            uint32_t chunk     = min(remaining, max(loop.min_chunk, remaining / (loop.participants * 2)));
+            if (loop.next.compare_exchange_weak(current, current + chunk, memory_order_relaxed))
+            {
+                start = current;
+                end   = current + chunk;
+                return true;
             }
+        }
 
-            working_count.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
 
-            // execute task - exceptions are handled by packaged_task if one is used
-            task();
+    static void loop_run(parallel_loop& loop)
+    {
+        uint32_t start = 0;
+        uint32_t end   = 0;
+        while (loop_claim(loop, start, end))
+        {
+            (*loop.work)(start, end);
 
-            working_count.fetch_sub(1, memory_order_relaxed);
-            pending_count.fetch_sub(1, memory_order_relaxed);
+            uint32_t count = end - start;
+            if (loop.completed.fetch_add(count, memory_order_acq_rel) + count == loop.total)
+            {
+                loop.completed.notify_all();
+            }
+        }
+    }
 
-            // wake up any thread waiting in flush()
-            idle_cv.notify_all();
+    static void loop_helper(Job* job)
+    {
+        parallel_loop& loop = loops[job->loop_slot];
+
+        // register before checking the generation, the owner bumps the generation before waiting for references to drain
+        loop.references.fetch_add(1, memory_order_seq_cst);
+        if (loop.generation.load(memory_order_seq_cst) == job->loop_generation)
+        {
+            loop_run(loop);
         }
+        loop.references.fetch_sub(1, memory_order_release);
     }
 
     void ThreadPool::Initialize()
@@ -92,10 +548,22 @@ namespace spartan
         uint32_t core_count = max(1u, hw_threads / 2);
         thread_count        = min(core_count * 2, core_count + 4);
 
+        free_jobs.Reset();
+        for (uint32_t i = 0; i < job_pool_size; i++)
+        {
+            free_jobs.Push(i);
+        }
+
+        worker_queues.clear();
+        for (uint32_t i = 0; i < thread_count; i++)
+        {
+            worker_queues.emplace_back(make_unique<work_stealing_queue>());
+        }
+
         threads.reserve(thread_count);
         for (uint32_t i = 0; i < thread_count; i++)
         {
-            threads.emplace_back(thread_loop);
+            threads.emplace_back(worker_loop, i);
         }
 
         SP_LOG_INFO("%d threads have been created", thread_count);
@@ -106,11 +574,11 @@ namespace spartan
         Flush(true);
 
         {
-            lock_guard<mutex> lock(task_mutex);
+            lock_guard<mutex> lock(sleep_mutex);
             stopping = true;
         }
 
-        task_cv.notify_all();
+        sleep_cv.notify_all();
 
         for (thread& t : threads)
         {
@@ -119,100 +587,192 @@ namespace spartan
         }
 
         threads.clear();
+        worker_queues.clear();
         working_count.store(0, memory_order_relaxed);
         pending_count.store(0, memory_order_relaxed);
+        queued_count.store(0, memory_order_relaxed);
         thread_count = 0;
     }
 
-    future<void> ThreadPool::AddTask(Task&& task)
+    future<void> ThreadPool::AddTask(Task&& task, const TaskPriority priority)
     {
         auto packaged = make_shared<packaged_task<void()>>(std::forward<Task>(task));
         future<void> result = packaged->get_future();
 
+        if (stopping.load(memory_order_relaxed))
+        {
+            SP_LOG_WARNING("ThreadPool::AddTask() called while pool is stopping");
+            return result;
+        }
+
+        Job* job      = job_acquire();
+        job->task     = [packaged]() { (*packaged)(); };
+        job->priority = priority;
+        job_submit(job);
+
+        return result;
+    }
+
+    void ThreadPool::AddTask(Task&& task, JobCounter& counter, const TaskPriority priority)
+    {
+        JobCounterAccess::Value(counter).fetch_add(1, memory_order_relaxed);
+
+        Job* job      = job_acquire();
+        job->task     = std::forward<Task>(task);
+        job->counter  = &counter;
+        job->priority = priority;
+        job_submit(job);
+    }
+
+    void ThreadPool::AddTask(Task&& task, JobCounter& counter, JobCounter& dependency)
+    {
+        JobCounterAccess::Value(counter).fetch_add(1, memory_order_relaxed);
+
+        Job* job     = job_acquire();
+        job->task    = std::forward<Task>(task);
+        job->counter = &counter;
+
+        // park the job on the dependency, whoever brings it to zero will submit it
+        if (!JobCounterAccess::AddDependent(dependency, job))
+        {
+            job_submit(job);
+        }
+    }
+
+    void ThreadPool::Wait(JobCounter& counter)
+    {
+        while (true)
         {
-            lock_guard<mutex> lock(task_mutex);
+            uint32_t value = JobCounterAccess::Value(counter).load(memory_order_acquire);
+            if (value == 0)
+                break;
 
-            if (stopping)
+            if (worker_index != invalid_worker)
             {
-                SP_LOG_WARNING("ThreadPool::AddTask() called while pool is stopping");
-                return result;
+                // a worker can't go to sleep here as the jobs it waits on may be queued behind it, so it helps out
+                if (Job* job = job_find())
+                {
+                    job_execute(job);
+                }
+                else
+                {
+                    this_thread::yield();
+                }
+            }
+            else
+            {
+                JobCounterAccess::Value(counter).wait(value, memory_order_acquire);
             }
-
-            pending_count.fetch_add(1, memory_order_relaxed);
-            tasks.emplace_back([packaged]() { (*packaged)(); });
         }
 
-        task_cv.notify_one();
-        return result;
+        // wait for the thread that completed the last job to release the counter
+        JobCounterAccess::Lock(counter);
+        JobCounterAccess::Unlock(counter);
     }
 
     void ThreadPool::ParallelLoop(function<void(uint32_t, uint32_t)>&& function, const uint32_t work_total)
     {
         SP_ASSERT_MSG(work_total > 0, "parallel loop requires work_total > 0");
 
-        // no threads available - run on calling thread
-        if (threads.empty())
+        // no threads available or nothing to split - run on calling thread
+        if (threads.empty() || work_total == 1)
         {
             function(0, work_total);
             return;
         }
 
-        // when called from a worker thread, check if we have idle workers available
-        // this allows nested parallelism when possible while preventing deadlock
-        uint32_t available_workers = thread_count;
-        if (is_worker_thread)
+        // acquire a loop slot
+        parallel_loop* loop = nullptr;
+        uint32_t slot       = 0;
+        for (; slot < loop_slot_count; slot++)
         {
-            uint32_t currently_working = working_count.load(memory_order_relaxed);
-            if (currently_working >= thread_count)
+            bool expected = false;
+            if (loops[slot].in_use.compare_exchange_strong(expected, true, memory_order_acquire))
             {
-                // all workers busy - run sequentially to prevent deadlock
-                function(0, work_total);
-                return;
+                loop = &loops[slot];
+                break;
             }
-            // use only idle workers to avoid deadlock
-            available_workers = thread_count - currently_working;
         }
 
-        // limit workers to available count and work count
-        uint32_t workers   = min(available_workers, work_total);
-        uint32_t base_work = work_total / workers;
-        uint32_t remainder = work_total % workers;
-
-        vector<future<void>> futures;
-        futures.reserve(workers);
+        if (!loop)
+        {
+            function(0, work_total);
+            return;
+        }
 
-        uint32_t work_index = 0;
-        for (uint32_t i = 0; i < workers; ++i)
+        // the calling thread participates, so helpers are only needed for the remaining workers
+        loop->participants = min(thread_count + 1, work_total);
+        loop->min_chunk    = max(1u, work_total / (loop->participants * loop_chunks_per_participant));
+        loop->total        = work_total;
+        loop->work         = &function;
+        loop->next.store(0, memory_order_relaxed);
+        loop->completed.store(0, memory_order_relaxed);
+        uint32_t generation = loop->generation.load(memory_order_relaxed);
+
+        uint32_t helper_count = loop->participants - 1;
+        for (uint32_t i = 0; i < helper_count; i++)
         {
-            uint32_t work_count = base_work + (i < remainder ? 1u : 0u);
-            uint32_t start      = work_index;
-            uint32_t end        = work_index + work_count;
+            Job* job             = job_acquire();
+            job->entry           = loop_helper;
+            job->loop_slot       = slot;
+            job->loop_generation = generation;
+            job_submit(job);
+        }
+
+        // do work on this thread until there is nothing left to claim
+        loop_run(*loop);
 
-            futures.emplace_back(AddTask([fn = function, start, end]() { fn(start, end); }));
-            work_index = end;
+        // wait for chunks claimed by helpers to finish
+        uint32_t completed = loop->completed.load(memory_order_acquire);
+        while (completed != work_total)
+        {
+            loop->completed.wait(completed, memory_order_acquire);
+            completed = loop->completed.load(memory_order_acquire);
         }
 
-        for (future<void>& f : futures)
+        // invalidate helpers that haven't started yet, then wait for the ones inside the loop to leave
+        loop->generation.fetch_add(1, memory_order_seq_cst);
+        while (loop->references.load(memory_order_seq_cst) != 0)
         {
-            f.get();
+            this_thread::yield();
         }
+
+        loop->work = nullptr;
+        loop->in_use.store(false, memory_order_release);
     }
 
     void ThreadPool::Flush(bool remove_queued)
     {
         if (remove_queued)
         {
-            lock_guard<mutex> lock(task_mutex);
-            uint32_t removed = static_cast<uint32_t>(tasks.size());
-            tasks.clear();
-            pending_count.fetch_sub(removed, memory_order_relaxed);
+            // drain every queue, discarded jobs still complete so that counters and futures are released
+            Job* job = nullptr;
+            for (auto& queue : injection_queues)
+            {
+                while (queue.Pop(job))
+                {
+                    queued_count.fetch_sub(1, memory_order_relaxed);
+                    job_complete(job);
+                }
+            }
+
+            for (unique_ptr<work_stealing_queue>& queue : worker_queues)
+            {
+                while ((job = queue->Steal()) != nullptr)
+                {
+                    queued_count.fetch_sub(1, memory_order_relaxed);
+                    job_complete(job);
+                }
+            }
         }
 
-        // wait for all in-flight work to complete using condition variable (no spin)
-        unique_lock<mutex> lock(task_mutex);
-        idle_cv.wait(lock, [] {
-            return tasks.empty() && working_count.load(memory_order_relaxed) == 0;
-        });
+        // wait for all in-flight work to complete (no spin)
+        uint32_t pending = pending_count.load(memory_order_acquire);
+        while (pending != 0)
+        {
+            pending_count.wait(pending, memory_order_acquire);
+            pending = pending_count.load(memory_order_acquire);
+        }
     }
 
     uint32_t ThreadPool::GetThreadCount()
@@ -24,12 +24,41 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ========
 #include <future>
 #include <functional>
+#include <atomic>
 //===================
 
 namespace spartan
 {
     using Task = std::function<void()>;
 
+    // scheduling lanes, high priority tasks are picked before anything else, low priority tasks only when idle
+    enum class TaskPriority : uint8_t
+    {
+        High,
+        Normal,
+        Low,
+        Max
+    };
+
+    // counts outstanding jobs, a job handle that can be waited on or depended upon without allocating
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        uint32_t GetValue() const { return m_value.load(std::memory_order_acquire); }
+        bool IsDone() const       { return GetValue() == 0; }
+
+    private:
+        friend struct JobCounterAccess;
+
+        std::atomic<uint32_t> m_value = 0;
+        std::atomic<bool> m_lock      = false; // guards the dependents list
+        void* m_dependents            = nullptr;
+    };
+
     class ThreadPool
     {
     public:
@@ -37,9 +66,18 @@ namespace spartan
         static void Shutdown();
 
         // add a task
-        static std::future<void> AddTask(Task&& task);
+        static std::future<void> AddTask(Task&& task, TaskPriority priority = TaskPriority::Normal);
+
+        // add a task which decrements the counter when it completes (no future/shared state allocation)
+        static void AddTask(Task&& task, JobCounter& counter, TaskPriority priority = TaskPriority::Normal);
+
+        // add a task which is only scheduled once the dependency counter reaches zero
+        static void AddTask(Task&& task, JobCounter& counter, JobCounter& dependency);
+
+        // block until the counter reaches zero, worker threads execute other jobs while waiting
+        static void Wait(JobCounter& counter);
 
-        // spread execution of a given function across all available threads
+        // spread execution of a given function across all available threads, the calling thread participates
         static void ParallelLoop(std::function<void(uint32_t work_index_start, uint32_t work_index_end)>&& function, const uint32_t work_total);
 
         // wait for all threads to finish work
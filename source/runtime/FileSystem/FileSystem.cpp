@@ -25,6 +25,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 SP_WARNINGS_OFF
 #include <SDL3/SDL_misc.h> // required for SDL_OpenURLWithApp
 SP_WARNINGS_ON
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 //========================
 
 //= NAMESPACES =====
@@ -664,7 +670,7 @@ namespace spartan
 
     bool FileSystem::IsEngineSceneFile(const string& path)
     {
-        return GetExtensionFromFilePath(path) == EXTENSION_WORLD;
+        return IsEngineWorldFile(path);
     }
 
     bool FileSystem::IsEngineAudioFile(const string& path)
@@ -684,7 +690,8 @@ namespace spartan
 
     bool FileSystem::IsEngineWorldFile(const string& path)
     {
-        return GetExtensionFromFilePath(path) == EXTENSION_WORLD;
+        const string extension = GetExtensionFromFilePath(path);
+        return extension == EXTENSION_WORLD || extension == EXTENSION_WORLD_BINARY;
     }
 
     bool FileSystem::IsEngineFile(const string& path)
@@ -1076,4 +1083,75 @@ namespace spartan
     
         return false;
     }
+
+    MappedFile::MappedFile(const string& path)
+    {
+    #ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return;
+        }
+
+        m_file    = file;
+        m_mapping = mapping;
+        m_data    = static_cast<const uint8_t*>(data);
+        m_size    = static_cast<uint64_t>(size.QuadPart);
+    #else
+        int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+
+        struct stat info = {};
+        if (fstat(file, &info) != 0 || info.st_size == 0)
+        {
+            close(file);
+            return;
+        }
+
+        void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file); // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED)
+            return;
+
+        madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = static_cast<uint64_t>(info.st_size);
+    #endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (!m_data)
+            return;
+
+    #ifdef _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+        CloseHandle(static_cast<HANDLE>(m_file));
+    #else
+        munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+    #endif
+    }
 }
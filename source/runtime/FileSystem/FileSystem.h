@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <string>
 #include <functional>
+#include <cstdint>
 //===================
 
 namespace spartan
@@ -99,12 +100,34 @@ namespace spartan
         static bool IsExecutableInPath(const std::string& executable);
     };
 
-    static const char* EXTENSION_WORLD    = ".world";
-    static const char* EXTENSION_MATERIAL = ".xml";
-    static const char* EXTENSION_MESH     = ".mesh";
-    static const char* EXTENSION_PREFAB   = ".prefab";
-    static const char* EXTENSION_SHADER   = ".shader";
-    static const char* EXTENSION_FONT     = ".font";
-    static const char* EXTENSION_AUDIO    = ".audio";
-    static const char* EXTENSION_TEXTURE  = ".texture";
+    // read-only memory mapping of an entire file, unmapped on destruction
+    class MappedFile
+    {
+    public:
+        MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool IsValid() const           { return m_data != nullptr; }
+        const uint8_t* GetData() const { return m_data; }
+        uint64_t GetSize() const       { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        uint64_t m_size       = 0;
+        void* m_file          = nullptr; // platform file handle
+        void* m_mapping       = nullptr; // platform mapping handle
+    };
+
+    static const char* EXTENSION_WORLD        = ".world";
+    static const char* EXTENSION_WORLD_BINARY = ".worldb";
+    static const char* EXTENSION_MATERIAL     = ".xml";
+    static const char* EXTENSION_MESH         = ".mesh";
+    static const char* EXTENSION_PREFAB       = ".prefab";
+    static const char* EXTENSION_SHADER       = ".shader";
+    static const char* EXTENSION_FONT         = ".font";
+    static const char* EXTENSION_AUDIO        = ".audio";
+    static const char* EXTENSION_TEXTURE      = ".texture";
 }
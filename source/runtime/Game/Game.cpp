@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Game.h"
 #include "../World/World.h"
 #include "../World/Entity.h"
+#include "../World/WorldPartition.h"
 #include "../World/Components/Camera.h"
 #include "../World/Components/Light.h"
 #include "../World/Components/Physics.h"
@@ -1480,6 +1481,10 @@ namespace spartan
                 const Vector3 position = Vector3(0.0f, 1.5f, 0.0f);
                 const float scale      = 1.5f;
 
+                // the curtains and the ivy import on the thread pool while the main building imports here, the loads below join them
+                ResourceCache::LoadAsync<Mesh>("project\\models\\sponza\\curtains\\NewSponza_Curtains_glTF.gltf");
+                ResourceCache::LoadAsync<Mesh>("project\\models\\sponza\\ivy\\NewSponza_IvyGrowth_glTF.gltf");
+
                 // main building
                 uint32_t mesh_flags = Mesh::GetDefaultFlags();
                 if (shared_ptr<Mesh> mesh = ResourceCache::Load<Mesh>("project\\models\\sponza\\main\\NewSponza_Main_Blender_glTF.gltf", mesh_flags))
@@ -1924,13 +1929,16 @@ namespace spartan
                                 entity->SetObjectName("tree");
                                 entity->SetParent(terrain_tile);
 
-                                vector<Matrix> transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Tree, entity, per_triangle_density_tree, 0.026f, transforms);
+                                vector<Instance> instances;
+                                terrain->FindInstances(tile_index, TerrainProp::Tree, entity, per_triangle_density_tree, 0.026f, [&instances](const vector<Instance>& cell)
+                                {
+                                    instances.insert(instances.end(), cell.begin(), cell.end());
+                                });
 
                                 if (Entity* trunk = entity->GetChildByIndex(0))
                                 {
                                     Renderable* renderable = trunk->GetComponent<Renderable>();
-                                    renderable->SetInstances(transforms);
+                                    renderable->SetInstances(instances);
                                     renderable->SetMaxRenderDistance(render_distance_trees);
                                     renderable->SetMaxShadowDistance(shadow_distance);
                                     renderable->SetMaterial(material_body);
@@ -1942,7 +1950,7 @@ namespace spartan
                                 if (Entity* leafs = entity->GetChildByIndex(1))
                                 {
                                     Renderable* renderable = leafs->GetComponent<Renderable>();
-                                    renderable->SetInstances(transforms);
+                                    renderable->SetInstances(instances);
                                     renderable->SetMaxRenderDistance(render_distance_trees);
                                     renderable->SetMaxShadowDistance(shadow_distance);
                                     renderable->SetMaterial(material_leaf);
@@ -1955,13 +1963,16 @@ namespace spartan
                                 entity->SetObjectName("rock");
                                 entity->SetParent(terrain_tile);
 
-                                vector<Matrix> transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Rock, entity, per_triangle_density_rock, 0.64f, transforms);
+                                vector<Instance> instances;
+                                terrain->FindInstances(tile_index, TerrainProp::Rock, entity, per_triangle_density_rock, 0.64f, [&instances](const vector<Instance>& cell)
+                                {
+                                    instances.insert(instances.end(), cell.begin(), cell.end());
+                                });
 
                                 if (Entity* rock_entity = entity->GetDescendantByName("untitled"))
                                 {
                                     Renderable* renderable = rock_entity->GetComponent<Renderable>();
-                                    renderable->SetInstances(transforms);
+                                    renderable->SetInstances(instances);
                                     renderable->SetMaxRenderDistance(render_distance_trees);
                                     renderable->SetMaxShadowDistance(shadow_distance);
                                     renderable->SetMaterial(material_rock);
@@ -1973,27 +1984,29 @@ namespace spartan
 
                             // grass - density layers for lod
                             {
-                                vector<Matrix> all_transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Grass, nullptr, per_triangle_density_grass_blade, 0.7f, all_transforms);
-
-                                if (!all_transforms.empty())
+                                // every cell is split across the layers so each layer covers the whole tile evenly
+                                vector<Instance> layer_low, layer_mid, layer_high;
+                                terrain->FindInstances(tile_index, TerrainProp::Grass, nullptr, per_triangle_density_grass_blade, 0.7f, [&](const vector<Instance>& cell)
+                                {
+                                    size_t split_1 = static_cast<size_t>(cell.size() * 0.15f);
+                                    size_t split_2 = static_cast<size_t>(cell.size() * 0.45f);
+                                    layer_low.insert(layer_low.end(), cell.begin(), cell.begin() + split_1);
+                                    layer_mid.insert(layer_mid.end(), cell.begin() + split_1, cell.begin() + split_2);
+                                    layer_high.insert(layer_high.end(), cell.begin() + split_2, cell.end());
+                                });
+
+                                if (!layer_low.empty() || !layer_mid.empty() || !layer_high.empty())
                                 {
-                                    size_t total_count = all_transforms.size();
-                                    size_t split_1     = static_cast<size_t>(total_count * 0.15f);
-                                    size_t split_2     = static_cast<size_t>(total_count * 0.45f);
-
                                     // far layer (15%)
                                     {
                                         Entity* entity = World::CreateEntity();
                                         entity->SetObjectName("grass_layer_density_low");
                                         entity->SetParent(terrain_tile);
 
-                                        vector<Matrix> far_transforms(all_transforms.begin(), all_transforms.begin() + split_1);
-
                                         Renderable* renderable = entity->AddComponent<Renderable>();
                                         renderable->SetMesh(mesh_grass_blade.get());
                                         renderable->SetFlag(RenderableFlags::CastsShadows, false);
-                                        renderable->SetInstances(far_transforms);
+                                        renderable->SetInstances(layer_low);
                                         renderable->SetMaterial(material_grass_blade);
                                         renderable->SetMaxRenderDistance(render_distance_foliage);
                                     }
@@ -2004,12 +2017,10 @@ namespace spartan
                                         entity->SetObjectName("grass_layer_density_mid");
                                         entity->SetParent(terrain_tile);
 
-                                        vector<Matrix> mid_transforms(all_transforms.begin() + split_1, all_transforms.begin() + split_2);
-
                                         Renderable* renderable = entity->AddComponent<Renderable>();
                                         renderable->SetMesh(mesh_grass_blade.get());
                                         renderable->SetFlag(RenderableFlags::CastsShadows, false);
-                                        renderable->SetInstances(mid_transforms);
+                                        renderable->SetInstances(layer_mid);
                                         renderable->SetMaterial(material_grass_blade);
                                         renderable->SetMaxRenderDistance(render_distance_foliage * 0.6f);
                                     }
@@ -2020,12 +2031,10 @@ namespace spartan
                                         entity->SetObjectName("grass_layer_density_high");
                                         entity->SetParent(terrain_tile);
 
-                                        vector<Matrix> near_transforms(all_transforms.begin() + split_2, all_transforms.end());
-
                                         Renderable* renderable = entity->AddComponent<Renderable>();
                                         renderable->SetMesh(mesh_grass_blade.get());
                                         renderable->SetFlag(RenderableFlags::CastsShadows, false);
-                                        renderable->SetInstances(near_transforms);
+                                        renderable->SetInstances(layer_high);
                                         renderable->SetMaterial(material_grass_blade);
                                         renderable->SetMaxRenderDistance(render_distance_foliage * 0.3f);
                                     }
@@ -2038,13 +2047,16 @@ namespace spartan
                                 entity->SetObjectName("flower");
                                 entity->SetParent(terrain_tile);
 
-                                vector<Matrix> transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Flower, entity, per_triangle_density_flower, 0.64f, transforms);
+                                vector<Instance> instances;
+                                terrain->FindInstances(tile_index, TerrainProp::Flower, entity, per_triangle_density_flower, 0.64f, [&instances](const vector<Instance>& cell)
+                                {
+                                    instances.insert(instances.end(), cell.begin(), cell.end());
+                                });
 
                                 Renderable* renderable = entity->AddComponent<Renderable>();
                                 renderable->SetMesh(mesh_flower.get());
                                 renderable->SetFlag(RenderableFlags::CastsShadows, false);
-                                renderable->SetInstances(transforms);
+                                renderable->SetInstances(instances);
                                 renderable->SetMaterial(material_flower);
                                 renderable->SetMaxRenderDistance(render_distance_foliage);
                             }
@@ -2052,6 +2064,22 @@ namespace spartan
                     };
 
                     ThreadPool::ParallelLoop(place_props_on_tiles, static_cast<uint32_t>(children.size()));
+
+                    // stream trees and rocks in and out around the camera, the tiles stay resident as their parents
+                    // grass and flowers use meshes owned by the game instead of the resource cache, so they can't be reloaded by name
+                    WorldPartition::Initialize(256.0f, render_distance_trees, 256ull * 1024 * 1024);
+                    vector<Entity*> props;
+                    for (Entity* terrain_tile : children)
+                    {
+                        for (Entity* prop : terrain_tile->GetChildren())
+                        {
+                            if (prop->GetObjectName() == "tree" || prop->GetObjectName() == "rock")
+                            {
+                                props.push_back(prop);
+                            }
+                        }
+                    }
+                    WorldPartition::Add(props);
                 }
             }
 
@@ -0,0 +1,282 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==============
+#include "pch.h"
+#include "Bvh.h"
+#include "../Core/ThreadPool.h"
+//=========================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace spartan::math;
+//=============================
+
+namespace spartan
+{
+    namespace
+    {
+        const uint32_t bin_count          = 16;
+        const uint32_t leaf_size_max      = 4;     // leaves at or below this size are kept if the heuristic prefers them
+        const uint32_t parallel_threshold = 16384; // subtrees with more primitives than this are built on the thread pool
+        const uint32_t sah_depth_max      = 32;    // past this depth splits are made at the median so the depth stays bounded
+
+        struct bin
+        {
+            Vector3 min    = Vector3::Infinity;
+            Vector3 max    = Vector3::InfinityNeg;
+            uint32_t count = 0;
+        };
+
+        float surface_area(const Vector3& min, const Vector3& max)
+        {
+            const Vector3 extent = max - min;
+            return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+
+        float axis(const Vector3& v, const uint32_t index)
+        {
+            return index == 0 ? v.x : (index == 1 ? v.y : v.z);
+        }
+
+        struct builder
+        {
+            const vector<BoundingBox>& boxes;
+            vector<Vector3> centroids;
+            vector<Bvh::Node>& nodes;
+            vector<uint32_t>& indices;
+            atomic<uint32_t> node_count = 1;
+
+            void build(const uint32_t node_index, const uint32_t first, const uint32_t count, const uint32_t depth)
+            {
+                // bounds of the primitives and of their centroids
+                Vector3 box_min      = Vector3::Infinity;
+                Vector3 box_max      = Vector3::InfinityNeg;
+                Vector3 centroid_min = Vector3::Infinity;
+                Vector3 centroid_max = Vector3::InfinityNeg;
+                for (uint32_t i = first; i < first + count; i++)
+                {
+                    const BoundingBox& box  = boxes[indices[i]];
+                    const Vector3& centroid = centroids[indices[i]];
+                    box_min                 = Vector3::Min(box_min, box.GetMin());
+                    box_max                 = Vector3::Max(box_max, box.GetMax());
+                    centroid_min            = Vector3::Min(centroid_min, centroid);
+                    centroid_max            = Vector3::Max(centroid_max, centroid);
+                }
+
+                Bvh::Node& node = nodes[node_index];
+                node.min        = box_min;
+                node.max        = box_max;
+                node.first      = first;
+                node.count      = count;
+
+                if (count <= 1)
+                    return;
+
+                // pick the split with the lowest surface area heuristic cost across all three axes
+                const Vector3 centroid_extent = centroid_max - centroid_min;
+                uint32_t split_axis           = 0;
+                uint32_t split_bin            = 0;
+                float split_cost              = numeric_limits<float>::max();
+                if (depth < sah_depth_max)
+                {
+                    // bin along all three axes in one pass over the primitives
+                    bin bins[3][bin_count];
+                    const Vector3 scale
+                    (
+                        centroid_extent.x > 0.0f ? bin_count / centroid_extent.x : 0.0f,
+                        centroid_extent.y > 0.0f ? bin_count / centroid_extent.y : 0.0f,
+                        centroid_extent.z > 0.0f ? bin_count / centroid_extent.z : 0.0f
+                    );
+
+                    for (uint32_t i = first; i < first + count; i++)
+                    {
+                        const BoundingBox& box = boxes[indices[i]];
+                        const Vector3 offset   = (centroids[indices[i]] - centroid_min) * scale;
+                        for (uint32_t a = 0; a < 3; a++)
+                        {
+                            bin& b = bins[a][min(bin_count - 1, static_cast<uint32_t>(axis(offset, a)))];
+                            b.min  = Vector3::Min(b.min, box.GetMin());
+                            b.max  = Vector3::Max(b.max, box.GetMax());
+                            b.count++;
+                        }
+                    }
+
+                    for (uint32_t a = 0; a < 3; a++)
+                    {
+                        if (axis(scale, a) == 0.0f)
+                            continue;
+
+                        // sweep from both sides to get the cost of every plane between two bins
+                        float area_left[bin_count - 1];
+                        uint32_t count_left[bin_count - 1];
+                        bin left;
+                        for (uint32_t b = 0; b < bin_count - 1; b++)
+                        {
+                            left.min       = Vector3::Min(left.min, bins[a][b].min);
+                            left.max       = Vector3::Max(left.max, bins[a][b].max);
+                            left.count    += bins[a][b].count;
+                            count_left[b]  = left.count;
+                            area_left[b]   = left.count > 0 ? surface_area(left.min, left.max) : 0.0f;
+                        }
+
+                        bin right;
+                        for (uint32_t b = bin_count - 1; b > 0; b--)
+                        {
+                            right.min    = Vector3::Min(right.min, bins[a][b].min);
+                            right.max    = Vector3::Max(right.max, bins[a][b].max);
+                            right.count += bins[a][b].count;
+
+                            const uint32_t plane = b - 1;
+                            if (count_left[plane] == 0 || right.count == 0)
+                                continue;
+
+                            const float cost = area_left[plane] * count_left[plane] + surface_area(right.min, right.max) * right.count;
+                            if (cost < split_cost)
+                            {
+                                split_cost = cost;
+                                split_axis = a;
+                                split_bin  = plane;
+                            }
+                        }
+                    }
+                }
+
+                // a split is worth it when it costs less than testing every primitive, the traversal step costs about one primitive
+                const float cost_leaf = surface_area(box_min, box_max) * count;
+                if (count <= leaf_size_max && split_cost >= cost_leaf - surface_area(box_min, box_max))
+                    return;
+
+                uint32_t left_count = 0;
+                if (split_cost != numeric_limits<float>::max())
+                {
+                    const float scale = bin_count / axis(centroid_extent, split_axis);
+                    uint32_t* begin   = indices.data() + first;
+                    uint32_t* middle  = partition(begin, begin + count, [&](const uint32_t index)
+                    {
+                        return min(bin_count - 1, static_cast<uint32_t>((axis(centroids[index], split_axis) - axis(centroid_min, split_axis)) * scale)) <= split_bin;
+                    });
+                    left_count = static_cast<uint32_t>(middle - begin);
+                }
+                else
+                {
+                    // degenerate centroids or too deep, split in half along the largest axis
+                    uint32_t largest = 0;
+                    if (centroid_extent.y > axis(centroid_extent, largest)) largest = 1;
+                    if (centroid_extent.z > axis(centroid_extent, largest)) largest = 2;
+
+                    uint32_t* begin = indices.data() + first;
+                    left_count      = count / 2;
+                    nth_element(begin, begin + left_count, begin + count, [&](const uint32_t a, const uint32_t b)
+                    {
+                        return axis(centroids[a], largest) < axis(centroids[b], largest);
+                    });
+                }
+
+                if (left_count == 0 || left_count == count)
+                    return;
+
+                const uint32_t child = node_count.fetch_add(2, memory_order_relaxed);
+                node.first           = child;
+                node.count           = 0;
+
+                if (count > parallel_threshold)
+                {
+                    JobCounter counter;
+                    ThreadPool::AddTask([this, child, first, left_count, depth]()
+                    {
+                        build(child, first, left_count, depth + 1);
+                    }, counter);
+                    build(child + 1, first + left_count, count - left_count, depth + 1);
+                    ThreadPool::Wait(counter);
+                }
+                else
+                {
+                    build(child, first, left_count, depth + 1);
+                    build(child + 1, first + left_count, count - left_count, depth + 1);
+                }
+            }
+        };
+    }
+
+    void Bvh::Build(const vector<BoundingBox>& primitive_boxes)
+    {
+        Clear();
+
+        const uint32_t count = static_cast<uint32_t>(primitive_boxes.size());
+        if (count == 0)
+            return;
+
+        m_primitive_indices.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            m_primitive_indices[i] = i;
+        }
+
+        // a binary tree with single primitive leaves is as large as it gets
+        m_nodes.resize(2 * count - 1);
+
+        builder b = { primitive_boxes, {}, m_nodes, m_primitive_indices };
+        b.centroids.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            b.centroids[i] = primitive_boxes[i].GetCenter();
+        }
+
+        b.build(0, 0, count, 0);
+
+        m_nodes.resize(b.node_count.load());
+        m_nodes.shrink_to_fit();
+    }
+
+    void Bvh::Refit(const vector<BoundingBox>& primitive_boxes)
+    {
+        // children always come after their parent, so a reverse walk sees them first
+        for (uint32_t i = static_cast<uint32_t>(m_nodes.size()); i-- > 0;)
+        {
+            Node& node = m_nodes[i];
+            if (node.count > 0)
+            {
+                node.min = Vector3::Infinity;
+                node.max = Vector3::InfinityNeg;
+                for (uint32_t p = node.first; p < node.first + node.count; p++)
+                {
+                    const BoundingBox& box = primitive_boxes[m_primitive_indices[p]];
+                    node.min               = Vector3::Min(node.min, box.GetMin());
+                    node.max               = Vector3::Max(node.max, box.GetMax());
+                }
+            }
+            else
+            {
+                const Node& left  = m_nodes[node.first];
+                const Node& right = m_nodes[node.first + 1];
+                node.min          = Vector3::Min(left.min, right.min);
+                node.max          = Vector3::Max(left.max, right.max);
+            }
+        }
+    }
+
+    void Bvh::Clear()
+    {
+        m_nodes.clear();
+        m_primitive_indices.clear();
+    }
+}
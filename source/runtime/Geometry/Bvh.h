@@ -0,0 +1,142 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include "../Math/Vector3.h"
+#include "../Math/BoundingBox.h"
+//================================
+
+namespace spartan
+{
+    // bounding volume hierarchy over the bounding boxes of arbitrary primitives (triangles, instances, entities)
+    // built top down with a binned surface area heuristic, large subtrees are built on the thread pool
+    class Bvh
+    {
+    public:
+        struct Node
+        {
+            math::Vector3 min;
+            uint32_t first = 0; // first child for interior nodes (the second follows it), first primitive for leaves
+            math::Vector3 max;
+            uint32_t count = 0; // primitive count, zero for interior nodes
+        };
+
+        void Build(const std::vector<math::BoundingBox>& primitive_boxes);
+
+        // updates the node bounds for primitives that moved, the topology is kept so the quality degrades with large moves
+        void Refit(const std::vector<math::BoundingBox>& primitive_boxes);
+
+        void Clear();
+
+        // walks the nodes front to back and calls hit(primitive_index, closest_distance) for every primitive whose leaf the ray
+        // enters before the closest hit so far, hit returns the distance to the primitive or infinity if it misses
+        // the direction doesn't need to be normalized, distances are in multiples of it
+        template <typename F>
+        float Raycast(const math::Vector3& origin, const math::Vector3& direction, float max_distance, F&& hit) const
+        {
+            const float infinity = std::numeric_limits<float>::infinity();
+            if (m_nodes.empty())
+                return infinity;
+
+            const math::Vector3 direction_inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+            float closest = infinity;
+            uint32_t stack[64];
+            uint32_t stack_size = 0;
+
+            if (intersect(m_nodes[0], origin, direction_inverse, max_distance) == infinity)
+                return infinity;
+            stack[stack_size++] = 0;
+
+            while (stack_size > 0)
+            {
+                const Node& node = m_nodes[stack[--stack_size]];
+
+                if (node.count > 0)
+                {
+                    for (uint32_t i = 0; i < node.count; i++)
+                    {
+                        const float distance = hit(m_primitive_indices[node.first + i], std::min(closest, max_distance));
+                        if (distance < closest && distance <= max_distance)
+                        {
+                            closest = distance;
+                        }
+                    }
+                    continue;
+                }
+
+                // visit the nearer child first, push it last
+                const float limit   = std::min(closest, max_distance);
+                uint32_t child_near = node.first;
+                uint32_t child_far  = node.first + 1;
+                float distance_near = intersect(m_nodes[child_near], origin, direction_inverse, limit);
+                float distance_far  = intersect(m_nodes[child_far], origin, direction_inverse, limit);
+                if (distance_far < distance_near)
+                {
+                    std::swap(child_near, child_far);
+                    std::swap(distance_near, distance_far);
+                }
+
+                if (distance_far != infinity)
+                {
+                    stack[stack_size++] = child_far;
+                }
+                if (distance_near != infinity)
+                {
+                    stack[stack_size++] = child_near;
+                }
+            }
+
+            return closest;
+        }
+
+        bool IsEmpty() const                                     { return m_nodes.empty(); }
+        const std::vector<Node>& GetNodes() const                { return m_nodes; }
+        const std::vector<uint32_t>& GetPrimitiveIndices() const { return m_primitive_indices; }
+        uint64_t GetMemoryUsage() const                          { return m_nodes.size() * sizeof(Node) + m_primitive_indices.size() * sizeof(uint32_t); }
+
+    private:
+        // slab test, returns the entry distance or infinity if the ray misses the box within max_distance
+        static float intersect(const Node& node, const math::Vector3& origin, const math::Vector3& direction_inverse, const float max_distance)
+        {
+            const float tx_0 = (node.min.x - origin.x) * direction_inverse.x;
+            const float tx_1 = (node.max.x - origin.x) * direction_inverse.x;
+            const float ty_0 = (node.min.y - origin.y) * direction_inverse.y;
+            const float ty_1 = (node.max.y - origin.y) * direction_inverse.y;
+            const float tz_0 = (node.min.z - origin.z) * direction_inverse.z;
+            const float tz_1 = (node.max.z - origin.z) * direction_inverse.z;
+
+            const float t_enter = std::max(std::max(std::min(tx_0, tx_1), std::min(ty_0, ty_1)), std::max(std::min(tz_0, tz_1), 0.0f));
+            const float t_exit  = std::min(std::min(std::max(tx_0, tx_1), std::max(ty_0, ty_1)), std::min(std::max(tz_0, tz_1), max_distance));
+
+            return t_enter <= t_exit ? t_enter : std::numeric_limits<float>::infinity();
+        }
+
+        std::vector<Node> m_nodes;                 // the root is the first node, children always come after their parent
+        std::vector<uint32_t> m_primitive_indices; // leaves refer to ranges of this
+    };
+}
@@ -28,6 +28,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World/Entity.h"
 #include "../Resource/Import/ModelImporter.h"
 #include "GeometryProcessing.h"
+#include "Bvh.h"
 //===========================================
 
 //= NAMESPACES ================
@@ -55,64 +56,150 @@ namespace spartan
 
         m_vertices.clear();
         m_vertices.shrink_to_fit();
+
+        lock_guard lock(m_bvh_mutex);
+        m_bvh.clear();
     }
 
-    void Mesh::SaveToFile(const string& file_path)
+    namespace
     {
-        ofstream outfile(file_path, ios::binary);
-        if (!outfile)
+        // native mesh format
+        // version 2: a 64 byte header, a sub-mesh table, a lod table and 64 byte aligned vertex/index blobs
+        // which can be memory mapped and uploaded to the gpu without any parsing
+        // version 1: the legacy field by field stream, still readable
+        constexpr uint32_t mesh_version_legacy = 1;
+        constexpr uint32_t mesh_version        = 2;
+        constexpr uint64_t mesh_blob_alignment = 64;
+
+        struct mesh_file_header
         {
-            SP_LOG_ERROR("Failed to open file for writing: %s", file_path.c_str());
-            return;
+            uint32_t version;
+            uint32_t type;
+            uint32_t flags;
+            uint32_t sub_mesh_count;
+            uint32_t lod_count;     // total, across all sub-meshes
+            uint32_t vertex_stride; // validated on load, a vertex layout change invalidates the file
+            uint32_t vertex_count;
+            uint32_t index_count;
+            uint64_t sub_mesh_table_offset;
+            uint64_t lod_table_offset;
+            uint64_t vertex_blob_offset;
+            uint64_t index_blob_offset;
+        };
+        static_assert(sizeof(mesh_file_header) == 64, "mesh header must stay 64 bytes");
+
+        struct mesh_file_sub_mesh
+        {
+            uint32_t lod_offset; // first entry in the lod table
+            uint32_t lod_count;
+        };
+
+        struct mesh_file_lod
+        {
+            uint32_t vertex_offset;
+            uint32_t vertex_count;
+            uint32_t index_offset;
+            uint32_t index_count;
+            float aabb_min[3];
+            float aabb_max[3];
+        };
+
+        uint64_t align_blob(const uint64_t offset)
+        {
+            return (offset + mesh_blob_alignment - 1) & ~(mesh_blob_alignment - 1);
         }
 
-        uint32_t version = 1;
-        outfile.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+        // whether byte_count bytes starting at offset lie within size, written so that nothing can overflow
+        bool fits(const uint64_t offset, const uint64_t byte_count, const uint64_t size)
+        {
+            return offset <= size && byte_count <= size - offset;
+        }
 
-        uint32_t type = static_cast<uint32_t>(m_type);
-        outfile.write(reinterpret_cast<const char*>(&type), sizeof(uint32_t));
+        // bounds checked reader over a mapped file
+        struct mesh_file_reader
+        {
+            const uint8_t* data = nullptr;
+            uint64_t size       = 0;
+            uint64_t cursor     = 0;
+            bool failed         = false;
 
-        // legacy field for backward compatibility (previously stored lod curve type)
-        uint32_t legacy_field = 0;
-        outfile.write(reinterpret_cast<const char*>(&legacy_field), sizeof(uint32_t));
+            template <typename T>
+            T Read()
+            {
+                T value = {};
+                Read(&value, sizeof(T));
+                return value;
+            }
 
-        outfile.write(reinterpret_cast<const char*>(&m_flags), sizeof(uint32_t));
+            void Read(void* destination, const uint64_t byte_count)
+            {
+                if (failed || !fits(cursor, byte_count, size))
+                {
+                    failed = true;
+                    return;
+                }
 
-        uint32_t submesh_count = static_cast<uint32_t>(m_sub_meshes.size());
-        outfile.write(reinterpret_cast<const char*>(&submesh_count), sizeof(uint32_t));
+                memcpy(destination, data + cursor, byte_count);
+                cursor += byte_count;
+            }
+        };
+    }
 
-        for (uint32_t sub_idx = 0; sub_idx < submesh_count; sub_idx++)
+    void Mesh::SaveToFile(const string& file_path)
+    {
+        ofstream outfile(file_path, ios::binary);
+        if (!outfile)
+        {
+            SP_LOG_ERROR("Failed to open file for writing: %s", file_path.c_str());
+            return;
+        }
+
+        // flatten the lods into a single table
+        vector<mesh_file_sub_mesh> sub_mesh_table;
+        vector<mesh_file_lod> lod_table;
+        sub_mesh_table.reserve(m_sub_meshes.size());
+        for (const SubMesh& sub_mesh : m_sub_meshes)
         {
-            const SubMesh& sub = m_sub_meshes[sub_idx];
-            uint32_t lod_count = static_cast<uint32_t>(sub.lods.size());
-            outfile.write(reinterpret_cast<const char*>(&lod_count), sizeof(uint32_t));
-            SP_LOG_INFO("Mesh '%s' sub-mesh %u: saving %u LODs", m_object_name.c_str(), sub_idx, lod_count);
+            sub_mesh_table.push_back({ static_cast<uint32_t>(lod_table.size()), static_cast<uint32_t>(sub_mesh.lods.size()) });
 
-            for (const auto& lod : sub.lods)
+            for (const MeshLod& lod : sub_mesh.lods)
             {
-                outfile.write(reinterpret_cast<const char*>(&lod.vertex_offset), sizeof(uint32_t));
-                outfile.write(reinterpret_cast<const char*>(&lod.vertex_count), sizeof(uint32_t));
-                outfile.write(reinterpret_cast<const char*>(&lod.index_offset), sizeof(uint32_t));
-                outfile.write(reinterpret_cast<const char*>(&lod.index_count), sizeof(uint32_t));
-
-                Vector3 min = lod.aabb.GetMin();
-                Vector3 max = lod.aabb.GetMax();
-                outfile.write(reinterpret_cast<const char*>(&min.x), sizeof(float));
-                outfile.write(reinterpret_cast<const char*>(&min.y), sizeof(float));
-                outfile.write(reinterpret_cast<const char*>(&min.z), sizeof(float));
-                outfile.write(reinterpret_cast<const char*>(&max.x), sizeof(float));
-                outfile.write(reinterpret_cast<const char*>(&max.y), sizeof(float));
-                outfile.write(reinterpret_cast<const char*>(&max.z), sizeof(float));
+                const Vector3 min = lod.aabb.GetMin();
+                const Vector3 max = lod.aabb.GetMax();
+                lod_table.push_back({ lod.vertex_offset, lod.vertex_count, lod.index_offset, lod.index_count, { min.x, min.y, min.z }, { max.x, max.y, max.z } });
             }
         }
 
-        uint32_t vertex_count = static_cast<uint32_t>(m_vertices.size());
-        outfile.write(reinterpret_cast<const char*>(&vertex_count), sizeof(uint32_t));
-        outfile.write(reinterpret_cast<const char*>(m_vertices.data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
+        mesh_file_header header      = {};
+        header.version               = mesh_version;
+        header.type                  = static_cast<uint32_t>(m_type);
+        header.flags                 = m_flags;
+        header.sub_mesh_count        = static_cast<uint32_t>(sub_mesh_table.size());
+        header.lod_count             = static_cast<uint32_t>(lod_table.size());
+        header.vertex_stride         = static_cast<uint32_t>(sizeof(RHI_Vertex_PosTexNorTan));
+        header.vertex_count          = static_cast<uint32_t>(m_vertices.size());
+        header.index_count           = static_cast<uint32_t>(m_indices.size());
+        header.sub_mesh_table_offset = sizeof(mesh_file_header);
+        header.lod_table_offset      = header.sub_mesh_table_offset + sub_mesh_table.size() * sizeof(mesh_file_sub_mesh);
+        header.vertex_blob_offset    = align_blob(header.lod_table_offset + lod_table.size() * sizeof(mesh_file_lod));
+        header.index_blob_offset     = align_blob(header.vertex_blob_offset + m_vertices.size() * sizeof(RHI_Vertex_PosTexNorTan));
+
+        const char padding[mesh_blob_alignment] = {};
+        auto write_padding_to = [&outfile, &padding](const uint64_t offset)
+        {
+            const uint64_t position = static_cast<uint64_t>(outfile.tellp());
+            outfile.write(padding, static_cast<streamsize>(offset - position));
+        };
+
+        outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        outfile.write(reinterpret_cast<const char*>(sub_mesh_table.data()), sub_mesh_table.size() * sizeof(mesh_file_sub_mesh));
+        outfile.write(reinterpret_cast<const char*>(lod_table.data()), lod_table.size() * sizeof(mesh_file_lod));
 
-        uint32_t index_count = static_cast<uint32_t>(m_indices.size());
-        outfile.write(reinterpret_cast<const char*>(&index_count), sizeof(uint32_t));
-        outfile.write(reinterpret_cast<const char*>(m_indices.data()), index_count * sizeof(uint32_t));
+        write_padding_to(header.vertex_blob_offset);
+        outfile.write(reinterpret_cast<const char*>(m_vertices.data()), m_vertices.size() * sizeof(RHI_Vertex_PosTexNorTan));
+
+        write_padding_to(header.index_blob_offset);
+        outfile.write(reinterpret_cast<const char*>(m_indices.data()), m_indices.size() * sizeof(uint32_t));
 
         outfile.close();
     }
@@ -128,8 +215,8 @@ namespace spartan
         }
         else if (FileSystem::IsEngineMeshFile(file_path)) // native
         {
-            ifstream infile(file_path, ios::binary);
-            if (!infile)
+            MappedFile file(file_path);
+            if (!file.IsValid())
             {
                 SP_LOG_ERROR("Failed to open file: %s", file_path.c_str());
                 return;
@@ -137,68 +224,140 @@ namespace spartan
 
             Clear();
 
-            uint32_t version;
-            infile.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
-            if (version != 1)
+            mesh_file_reader reader = { file.GetData(), file.GetSize() };
+            const uint32_t version  = reader.Read<uint32_t>();
+            if (version == mesh_version)
             {
-                SP_LOG_ERROR("Version mismatch for file: %s", file_path.c_str());
-                return;
-            }
+                mesh_file_header header = {};
+                reader.cursor           = 0;
+                reader.Read(&header, sizeof(header));
+
+                // validate the layout before allocating anything, every count has to be backed by bytes in the file
+                const uint64_t sub_mesh_table_size = static_cast<uint64_t>(header.sub_mesh_count) * sizeof(mesh_file_sub_mesh);
+                const uint64_t lod_table_size      = static_cast<uint64_t>(header.lod_count) * sizeof(mesh_file_lod);
+                const uint64_t vertex_blob_size    = static_cast<uint64_t>(header.vertex_count) * sizeof(RHI_Vertex_PosTexNorTan);
+                const uint64_t index_blob_size     = static_cast<uint64_t>(header.index_count) * sizeof(uint32_t);
+                if (reader.failed ||
+                    header.vertex_stride != sizeof(RHI_Vertex_PosTexNorTan) ||
+                    !fits(header.sub_mesh_table_offset, sub_mesh_table_size, file.GetSize()) ||
+                    !fits(header.lod_table_offset, lod_table_size, file.GetSize()) ||
+                    !fits(header.vertex_blob_offset, vertex_blob_size, file.GetSize()) ||
+                    !fits(header.index_blob_offset, index_blob_size, file.GetSize()))
+                {
+                    SP_LOG_ERROR("Corrupted or incompatible mesh file: %s", file_path.c_str());
+                    return;
+                }
 
-            uint32_t type;
-            infile.read(reinterpret_cast<char*>(&type), sizeof(uint32_t));
-            m_type = static_cast<MeshType>(type);
+                m_type  = static_cast<MeshType>(header.type);
+                m_flags = header.flags;
 
-            // legacy field for backward compatibility (skip)
-            uint32_t legacy_field;
-            infile.read(reinterpret_cast<char*>(&legacy_field), sizeof(uint32_t));
+                vector<mesh_file_sub_mesh> sub_mesh_table(header.sub_mesh_count);
+                vector<mesh_file_lod> lod_table(header.lod_count);
+                reader.cursor = header.sub_mesh_table_offset;
+                reader.Read(sub_mesh_table.data(), sub_mesh_table.size() * sizeof(mesh_file_sub_mesh));
+                reader.cursor = header.lod_table_offset;
+                reader.Read(lod_table.data(), lod_table.size() * sizeof(mesh_file_lod));
 
-            infile.read(reinterpret_cast<char*>(&m_flags), sizeof(uint32_t));
+                m_sub_meshes.resize(header.sub_mesh_count);
+                for (uint32_t sub_idx = 0; sub_idx < header.sub_mesh_count && !reader.failed; sub_idx++)
+                {
+                    const mesh_file_sub_mesh& entry = sub_mesh_table[sub_idx];
+                    if (!fits(entry.lod_offset, entry.lod_count, header.lod_count))
+                    {
+                        reader.failed = true;
+                        break;
+                    }
+
+                    SubMesh& sub = m_sub_meshes[sub_idx];
+                    sub.lods.resize(entry.lod_count);
+                    for (uint32_t lod_idx = 0; lod_idx < entry.lod_count; lod_idx++)
+                    {
+                        const mesh_file_lod& lod_file = lod_table[entry.lod_offset + lod_idx];
+                        if (!fits(lod_file.vertex_offset, lod_file.vertex_count, header.vertex_count) ||
+                            !fits(lod_file.index_offset, lod_file.index_count, header.index_count))
+                        {
+                            reader.failed = true;
+                            break;
+                        }
+
+                        MeshLod& lod      = sub.lods[lod_idx];
+                        lod.vertex_offset = lod_file.vertex_offset;
+                        lod.vertex_count  = lod_file.vertex_count;
+                        lod.index_offset  = lod_file.index_offset;
+                        lod.index_count   = lod_file.index_count;
+                        lod.aabb          = BoundingBox(Vector3(lod_file.aabb_min[0], lod_file.aabb_min[1], lod_file.aabb_min[2]), Vector3(lod_file.aabb_max[0], lod_file.aabb_max[1], lod_file.aabb_max[2]));
+                    }
+                }
 
-            uint32_t submesh_count;
-            infile.read(reinterpret_cast<char*>(&submesh_count), sizeof(uint32_t));
-            m_sub_meshes.resize(submesh_count);
+                if (reader.failed)
+                {
+                    SP_LOG_ERROR("Corrupted mesh file: %s", file_path.c_str());
+                    m_sub_meshes.clear();
+                    return;
+                }
 
-            for (uint32_t sub_idx = 0; sub_idx < submesh_count; sub_idx++)
+                // upload straight from the mapping, then keep a cpu copy for picking, physics etc. (a single memcpy per blob)
+                const auto* vertices = reinterpret_cast<const RHI_Vertex_PosTexNorTan*>(file.GetData() + header.vertex_blob_offset);
+                const auto* indices  = reinterpret_cast<const uint32_t*>(file.GetData() + header.index_blob_offset);
+                CreateGpuBuffers(vertices, header.vertex_count, indices, header.index_count);
+                m_vertices.assign(vertices, vertices + header.vertex_count);
+                m_indices.assign(indices, indices + header.index_count);
+                NormalizeScale();
+            }
+            else if (version == mesh_version_legacy)
             {
-                SubMesh& sub = m_sub_meshes[sub_idx];
-                uint32_t lod_count;
-                infile.read(reinterpret_cast<char*>(&lod_count), sizeof(uint32_t));
-                sub.lods.resize(lod_count);
-                SP_LOG_INFO("Mesh '%s' sub-mesh %u: loaded %u LODs", m_object_name.c_str(), sub_idx, lod_count);
+                m_type = static_cast<MeshType>(reader.Read<uint32_t>());
+                reader.Read<uint32_t>(); // legacy field (previously stored lod curve type)
+                m_flags = reader.Read<uint32_t>();
 
-                for (auto& lod : sub.lods)
+                uint32_t submesh_count = reader.Read<uint32_t>();
+                for (uint32_t sub_idx = 0; sub_idx < submesh_count && !reader.failed; sub_idx++)
                 {
-                    infile.read(reinterpret_cast<char*>(&lod.vertex_offset), sizeof(uint32_t));
-                    infile.read(reinterpret_cast<char*>(&lod.vertex_count), sizeof(uint32_t));
-                    infile.read(reinterpret_cast<char*>(&lod.index_offset), sizeof(uint32_t));
-                    infile.read(reinterpret_cast<char*>(&lod.index_count), sizeof(uint32_t));
-
-                    float min_x, min_y, min_z, max_x, max_y, max_z;
-                    infile.read(reinterpret_cast<char*>(&min_x), sizeof(float));
-                    infile.read(reinterpret_cast<char*>(&min_y), sizeof(float));
-                    infile.read(reinterpret_cast<char*>(&min_z), sizeof(float));
-                    infile.read(reinterpret_cast<char*>(&max_x), sizeof(float));
-                    infile.read(reinterpret_cast<char*>(&max_y), sizeof(float));
-                    infile.read(reinterpret_cast<char*>(&max_z), sizeof(float));
-
-                    lod.aabb = BoundingBox(Vector3(min_x, min_y, min_z), Vector3(max_x, max_y, max_z));
+                    SubMesh& sub       = m_sub_meshes.emplace_back();
+                    uint32_t lod_count = reader.Read<uint32_t>();
+                    for (uint32_t lod_idx = 0; lod_idx < lod_count && !reader.failed; lod_idx++)
+                    {
+                        MeshLod& lod      = sub.lods.emplace_back();
+                        lod.vertex_offset = reader.Read<uint32_t>();
+                        lod.vertex_count  = reader.Read<uint32_t>();
+                        lod.index_offset  = reader.Read<uint32_t>();
+                        lod.index_count   = reader.Read<uint32_t>();
+
+                        float aabb[6] = {};
+                        reader.Read(aabb, sizeof(aabb));
+                        lod.aabb = BoundingBox(Vector3(aabb[0], aabb[1], aabb[2]), Vector3(aabb[3], aabb[4], aabb[5]));
+                    }
                 }
-            }
 
-            uint32_t vertex_count;
-            infile.read(reinterpret_cast<char*>(&vertex_count), sizeof(uint32_t));
-            m_vertices.resize(vertex_count);
-            infile.read(reinterpret_cast<char*>(m_vertices.data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
+                uint32_t vertex_count = reader.Read<uint32_t>();
+                if (!reader.failed && fits(reader.cursor, static_cast<uint64_t>(vertex_count) * sizeof(RHI_Vertex_PosTexNorTan), reader.size))
+                {
+                    m_vertices.resize(vertex_count);
+                    reader.Read(m_vertices.data(), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
+                }
 
-            uint32_t index_count;
-            infile.read(reinterpret_cast<char*>(&index_count), sizeof(uint32_t));
-            m_indices.resize(index_count);
-            infile.read(reinterpret_cast<char*>(m_indices.data()), index_count * sizeof(uint32_t));
+                uint32_t index_count = reader.Read<uint32_t>();
+                if (!reader.failed && fits(reader.cursor, static_cast<uint64_t>(index_count) * sizeof(uint32_t), reader.size))
+                {
+                    m_indices.resize(index_count);
+                    reader.Read(m_indices.data(), index_count * sizeof(uint32_t));
+                }
 
-            infile.close();
+                if (reader.failed || m_vertices.size() != vertex_count || m_indices.size() != index_count)
+                {
+                    SP_LOG_ERROR("Corrupted mesh file: %s", file_path.c_str());
+                    Clear();
+                    m_sub_meshes.clear();
+                    return;
+                }
 
-            CreateGpuBuffers();
+                CreateGpuBuffers();
+            }
+            else
+            {
+                SP_LOG_ERROR("Version mismatch for file: %s", file_path.c_str());
+                return;
+            }
         }
         else
         {
@@ -291,10 +450,15 @@ namespace spartan
 
     void Mesh::AddGeometry(vector<RHI_Vertex_PosTexNorTan>& vertices, vector<uint32_t>& indices, const bool generate_lods, uint32_t* sub_mesh_index)
     {
-        // create a sub-mesh
-        SubMesh sub_mesh;
-        uint32_t current_sub_mesh_index = static_cast<uint32_t>(m_sub_meshes.size());
-        m_sub_meshes.push_back(sub_mesh); // add it to the list so AddLod() can access it
+        vector<MeshLodGeometry> lods;
+        BuildLods(vertices, indices, generate_lods, lods);
+        AddGeometry(lods, sub_mesh_index);
+    }
+
+    void Mesh::BuildLods(vector<RHI_Vertex_PosTexNorTan>& vertices, vector<uint32_t>& indices, const bool generate_lods, vector<MeshLodGeometry>& lods) const
+    {
+        lods.clear();
+        lods.reserve(mesh_lod_count);
 
         // lod 0: original geometry
         {
@@ -305,7 +469,7 @@ namespace spartan
             }
 
             // add the original geometry as lod 0
-            AddLod(vertices, indices, current_sub_mesh_index);
+            lods.push_back({ vertices, indices });
         }
 
         // generate additional lods if requested
@@ -327,15 +491,12 @@ namespace spartan
 
             size_t original_index_count = indices.size();
 
-            // start with lod0 geometry for progressive simplification
-            vector<RHI_Vertex_PosTexNorTan> prev_vertices = vertices;
-            vector<uint32_t> prev_indices                 = indices;
-
             for (uint32_t lod_level = 1; lod_level < mesh_lod_count; lod_level++)
             {
                 // use previous lod as starting point for simplification
-                vector<RHI_Vertex_PosTexNorTan> lod_vertices = prev_vertices;
-                vector<uint32_t> lod_indices                 = prev_indices;
+                const MeshLodGeometry& lod_previous          = lods.back();
+                vector<RHI_Vertex_PosTexNorTan> lod_vertices = lod_previous.vertices;
+                vector<uint32_t> lod_indices                 = lod_previous.indices;
 
                 // geometry too simple to benefit from further simplification
                 if (lod_indices.size() <= 64)
@@ -359,17 +520,29 @@ namespace spartan
                 geometry_processing::simplify(lod_indices, lod_vertices, target_index_count, preserve_uvs, preserve_edges);
 
                 // stop if simplification couldn't reduce complexity further
-                if (lod_indices.size() >= prev_indices.size())
+                if (lod_indices.size() >= lod_previous.indices.size())
                     break;
 
                 // add simplified geometry as new lod
-                AddLod(lod_vertices, lod_indices, current_sub_mesh_index);
-
-                // update for next iteration
-                prev_vertices = move(lod_vertices);
-                prev_indices  = move(lod_indices);
+                lods.push_back({ move(lod_vertices), move(lod_indices) });
             }
         }
+    }
+
+    void Mesh::AddGeometry(vector<MeshLodGeometry>& lods, uint32_t* sub_mesh_index)
+    {
+        // create a sub-mesh
+        uint32_t current_sub_mesh_index = 0;
+        {
+            lock_guard lock(m_mutex);
+            current_sub_mesh_index = static_cast<uint32_t>(m_sub_meshes.size());
+            m_sub_meshes.emplace_back(); // add it to the list so AddLod() can access it
+        }
+
+        for (MeshLodGeometry& lod : lods)
+        {
+            AddLod(lod.vertices, lod.indices, current_sub_mesh_index);
+        }
 
         // return the sub-mesh index if requested
         if (sub_mesh_index)
@@ -398,26 +571,34 @@ namespace spartan
     }
 
     void Mesh::CreateGpuBuffers()
+    {
+        CreateGpuBuffers(m_vertices.data(), static_cast<uint32_t>(m_vertices.size()), m_indices.data(), static_cast<uint32_t>(m_indices.size()));
+        NormalizeScale();
+    }
+
+    void Mesh::CreateGpuBuffers(const RHI_Vertex_PosTexNorTan* vertices, const uint32_t vertex_count, const uint32_t* indices, const uint32_t index_count)
     {
         // vertex buffer
         m_vertex_buffer = make_unique<RHI_Buffer>(RHI_Buffer_Type::Vertex,
-            sizeof(m_vertices[0]),
-            static_cast<uint32_t>(m_vertices.size()),
-            static_cast<void*>(&m_vertices[0]),
+            sizeof(RHI_Vertex_PosTexNorTan),
+            vertex_count,
+            const_cast<void*>(static_cast<const void*>(vertices)),
             false,
             (string("mesh_vertex_buffer_") + m_object_name).c_str()
         );
 
         // index buffer
         m_index_buffer = make_unique<RHI_Buffer>(RHI_Buffer_Type::Index,
-            sizeof(m_indices[0]),
-            static_cast<uint32_t>(m_indices.size()),
-            static_cast<void*>(&m_indices[0]),
+            sizeof(uint32_t),
+            index_count,
+            const_cast<void*>(static_cast<const void*>(indices)),
             false,
             (string("mesh_index_buffer_") + m_object_name).c_str()
         );
+    }
 
-        // normalize scale
+    void Mesh::NormalizeScale()
+    {
         if (m_flags & static_cast<uint32_t>(MeshFlags::PostProcessNormalizeScale))
         {
             if (m_root_entity)
@@ -488,4 +669,90 @@ namespace spartan
 
         return m_blas[sub_mesh_index] != nullptr;
     }
+
+    void Mesh::BuildBvh(const uint32_t sub_mesh_index)
+    {
+        if (HasBvh(sub_mesh_index) || sub_mesh_index >= m_sub_meshes.size() || m_sub_meshes[sub_mesh_index].lods.empty())
+            return;
+
+        // one box per triangle, indices are relative to the lod's vertices
+        const MeshLod& lod               = m_sub_meshes[sub_mesh_index].lods[0];
+        RHI_Vertex_PosTexNorTan* v       = m_vertices.data() + lod.vertex_offset;
+        const uint32_t* indices          = m_indices.data() + lod.index_offset;
+        const uint32_t triangle_count    = lod.index_count / 3;
+        vector<BoundingBox> boxes(triangle_count);
+        for (uint32_t i = 0; i < triangle_count; i++)
+        {
+            const Vector3 p0(v[indices[i * 3 + 0]].pos);
+            const Vector3 p1(v[indices[i * 3 + 1]].pos);
+            const Vector3 p2(v[indices[i * 3 + 2]].pos);
+            boxes[i] = BoundingBox(Vector3::Min(p0, Vector3::Min(p1, p2)), Vector3::Max(p0, Vector3::Max(p1, p2)));
+        }
+
+        unique_ptr<Bvh> bvh = make_unique<Bvh>();
+        bvh->Build(boxes);
+
+        lock_guard lock(m_bvh_mutex);
+        if (m_bvh.size() != m_sub_meshes.size())
+        {
+            m_bvh.resize(m_sub_meshes.size());
+        }
+        if (!m_bvh[sub_mesh_index]) // another thread may have beaten us to it
+        {
+            m_bvh[sub_mesh_index] = move(bvh);
+        }
+    }
+
+    bool Mesh::HasBvh(const uint32_t sub_mesh_index)
+    {
+        lock_guard lock(m_bvh_mutex);
+        return sub_mesh_index < m_bvh.size() && m_bvh[sub_mesh_index] != nullptr;
+    }
+
+    float Mesh::Raycast(const uint32_t sub_mesh_index, const Vector3& origin, const Vector3& direction, const float max_distance, Vector3* out_normal)
+    {
+        BuildBvh(sub_mesh_index);
+
+        const Bvh* bvh = nullptr;
+        {
+            lock_guard lock(m_bvh_mutex);
+            if (sub_mesh_index < m_bvh.size())
+            {
+                bvh = m_bvh[sub_mesh_index].get();
+            }
+        }
+        if (!bvh)
+            return numeric_limits<float>::infinity();
+
+        // the direction is left as is so distances stay in the caller's units
+        Ray ray;
+        ray.m_origin    = origin;
+        ray.m_direction = direction;
+
+        const MeshLod& lod               = m_sub_meshes[sub_mesh_index].lods[0];
+        RHI_Vertex_PosTexNorTan* v       = m_vertices.data() + lod.vertex_offset;
+        const uint32_t* indices          = m_indices.data() + lod.index_offset;
+        uint32_t closest_triangle        = 0;
+        float closest                    = numeric_limits<float>::infinity();
+        const float distance = bvh->Raycast(origin, direction, max_distance, [&](const uint32_t triangle, const float)
+        {
+            const float d = ray.HitDistance(Vector3(v[indices[triangle * 3 + 0]].pos), Vector3(v[indices[triangle * 3 + 1]].pos), Vector3(v[indices[triangle * 3 + 2]].pos));
+            if (d < closest && d <= max_distance)
+            {
+                closest          = d;
+                closest_triangle = triangle;
+            }
+            return d;
+        });
+
+        if (out_normal && distance != numeric_limits<float>::infinity())
+        {
+            const Vector3 p0(v[indices[closest_triangle * 3 + 0]].pos);
+            const Vector3 p1(v[indices[closest_triangle * 3 + 1]].pos);
+            const Vector3 p2(v[indices[closest_triangle * 3 + 2]].pos);
+            *out_normal = (p1 - p0).Cross(p2 - p0).Normalized();
+        }
+
+        return distance;
+    }
 }
@@ -34,6 +34,7 @@ namespace spartan
     class RHI_Buffer;
     class RHI_AccelerationStructure;
     class RHI_CommandList;
+    class Bvh;
 
     enum class MeshFlags : uint32_t
     {
@@ -71,6 +72,13 @@ namespace spartan
         std::vector<MeshLod> lods; // list of LOD levels for this sub-mesh
     };
 
+    // geometry of a single lod before it's appended to a mesh
+    struct MeshLodGeometry
+    {
+        std::vector<RHI_Vertex_PosTexNorTan> vertices;
+        std::vector<uint32_t> indices;
+    };
+
     class Mesh : public IResource
     {
     public:
@@ -87,6 +95,9 @@ namespace spartan
         uint32_t GetMemoryUsage() const;
         void AddLod(std::vector<RHI_Vertex_PosTexNorTan>& vertices, std::vector<uint32_t>& indices, const uint32_t sub_mesh_index);
         void AddGeometry(std::vector<RHI_Vertex_PosTexNorTan>& vertices, std::vector<uint32_t>& indices, const bool generate_lods, uint32_t* sub_mesh_index = nullptr);
+        // optimizes and simplifies without touching the mesh, so sub-meshes can be built in parallel and appended in a fixed order
+        void BuildLods(std::vector<RHI_Vertex_PosTexNorTan>& vertices, std::vector<uint32_t>& indices, const bool generate_lods, std::vector<MeshLodGeometry>& lods) const;
+        void AddGeometry(std::vector<MeshLodGeometry>& lods, uint32_t* sub_mesh_index = nullptr);
         std::vector<RHI_Vertex_PosTexNorTan>& GetVertices()   { return m_vertices; }
         std::vector<uint32_t>& GetIndices()                   { return m_indices; }
         const SubMesh& GetSubMesh(const uint32_t index) const { return m_sub_meshes[index]; }
@@ -117,7 +128,16 @@ namespace spartan
         RHI_AccelerationStructure* GetBlas(uint32_t sub_mesh_index) const;
         bool HasBlas(uint32_t sub_mesh_index) const;
 
+        // cpu ray queries - one bvh per sub-mesh over the triangles of lod 0, built on first use and safe from any thread
+        void BuildBvh(const uint32_t sub_mesh_index);
+        bool HasBvh(const uint32_t sub_mesh_index);
+        // the ray is in the space of the vertices, returns the hit distance in multiples of the direction or infinity
+        float Raycast(const uint32_t sub_mesh_index, const math::Vector3& origin, const math::Vector3& direction, const float max_distance, math::Vector3* out_normal = nullptr);
+
     private:
+        void CreateGpuBuffers(const RHI_Vertex_PosTexNorTan* vertices, uint32_t vertex_count, const uint32_t* indices, uint32_t index_count);
+        void NormalizeScale();
+
         // geometry
         std::vector<RHI_Vertex_PosTexNorTan> m_vertices; // all vertices of a model file
         std::vector<uint32_t> m_indices;                 // all indices of a model file
@@ -128,6 +148,10 @@ namespace spartan
         std::unique_ptr<RHI_Buffer> m_index_buffer;
         std::vector<std::unique_ptr<RHI_AccelerationStructure>> m_blas; // one blas per sub-mesh
 
+        // cpu acceleration structure
+        std::vector<std::unique_ptr<Bvh>> m_bvh; // one bvh per sub-mesh
+        std::mutex m_bvh_mutex;
+
         // misc
         std::mutex m_mutex;
         Entity* m_root_entity = nullptr;
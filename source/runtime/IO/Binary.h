@@ -0,0 +1,188 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+//=========================
+
+namespace spartan
+{
+    // strings are stored once per file, writers and readers refer to them by index
+    class BinaryStringTable
+    {
+    public:
+        uint32_t Add(const std::string& value)
+        {
+            auto it = m_indices.find(value);
+            if (it != m_indices.end())
+                return it->second;
+
+            const uint32_t index = static_cast<uint32_t>(m_strings.size());
+            m_strings.push_back(value);
+            m_indices.emplace(value, index);
+
+            return index;
+        }
+
+        const std::string& Get(const uint32_t index) const
+        {
+            static const std::string empty;
+            return index < m_strings.size() ? m_strings[index] : empty;
+        }
+
+        const std::vector<std::string>& GetStrings() const { return m_strings; }
+
+    private:
+        std::vector<std::string> m_strings;
+        std::unordered_map<std::string, uint32_t> m_indices;
+    };
+
+    // appends plain data to a growing byte buffer
+    class BinaryWriter
+    {
+    public:
+        BinaryWriter(BinaryStringTable* strings = nullptr) : m_strings(strings) {}
+
+        template <typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be written");
+            Write(&value, sizeof(T));
+        }
+
+        void Write(const void* source, const uint64_t byte_count)
+        {
+            if (byte_count == 0)
+                return;
+
+            const size_t offset = m_data.size();
+            m_data.resize(offset + static_cast<size_t>(byte_count));
+            memcpy(m_data.data() + offset, source, static_cast<size_t>(byte_count));
+        }
+
+        // an index into the string table if there is one, the characters otherwise
+        void WriteString(const std::string& value)
+        {
+            if (m_strings)
+            {
+                Write<uint32_t>(m_strings->Add(value));
+                return;
+            }
+
+            Write<uint32_t>(static_cast<uint32_t>(value.size()));
+            Write(value.data(), value.size());
+        }
+
+        const uint8_t* GetData() const { return m_data.data(); }
+        uint64_t GetSize() const       { return m_data.size(); }
+        void Clear()                   { m_data.clear(); }
+        std::vector<uint8_t> Release() { return std::move(m_data); }
+
+    private:
+        std::vector<uint8_t> m_data;
+        BinaryStringTable* m_strings = nullptr;
+    };
+
+    // bounds checked reader over memory it doesn't own
+    // reading past the end returns the given fallback and flags the reader, so data written by an older version,
+    // which simply ends earlier, leaves the fields that came later at their defaults
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const uint8_t* data, const uint64_t size, const BinaryStringTable* strings = nullptr, const uint32_t version = 0)
+            : m_data(data), m_size(size), m_strings(strings), m_version(version) {}
+
+        template <typename T>
+        T Read(const T& fallback = T())
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be read");
+            T value = fallback;
+            Read(&value, sizeof(T));
+            return value;
+        }
+
+        bool Read(void* destination, const uint64_t byte_count)
+        {
+            if (m_failed || m_cursor + byte_count > m_size)
+            {
+                m_failed = true;
+                return false;
+            }
+
+            memcpy(destination, m_data + m_cursor, static_cast<size_t>(byte_count));
+            m_cursor += byte_count;
+
+            return true;
+        }
+
+        std::string ReadString(const std::string& fallback = "")
+        {
+            if (m_strings)
+            {
+                const uint32_t index = Read<uint32_t>(UINT32_MAX);
+                return m_failed ? fallback : m_strings->Get(index);
+            }
+
+            const uint32_t length = Read<uint32_t>();
+            if (m_failed || m_cursor + length > m_size)
+            {
+                m_failed = true;
+                return fallback;
+            }
+
+            std::string value(reinterpret_cast<const char*>(m_data + m_cursor), length);
+            m_cursor += length;
+
+            return value;
+        }
+
+        void Skip(const uint64_t byte_count)
+        {
+            if (m_failed || m_cursor + byte_count > m_size)
+            {
+                m_failed = true;
+                return;
+            }
+
+            m_cursor += byte_count;
+        }
+
+        const uint8_t* GetCursorData() const { return m_data + m_cursor; }
+        uint64_t GetRemaining() const        { return m_size - m_cursor; }
+        uint32_t GetVersion() const          { return m_version; } // the version the data was written with
+        bool HasFailed() const               { return m_failed; }
+
+    private:
+        const uint8_t* m_data              = nullptr;
+        uint64_t m_size                    = 0;
+        uint64_t m_cursor                  = 0;
+        const BinaryStringTable* m_strings = nullptr;
+        uint32_t m_version                 = 0;
+        bool m_failed                      = false;
+    };
+}
@@ -19,10 +19,15 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =======
+//= INCLUDES ===========
 #include "pch.h"
 #include "Frustum.h"
-//==================
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+//======================
 
 //= NAMESPACES =====
 using namespace std;
@@ -82,6 +87,126 @@ namespace spartan::math
         return CheckCube(center, extent, ignore_depth) != Intersection::Outside;
     }
 
+    void Frustum::AreVisible(
+        const float* center_x, const float* center_y, const float* center_z,
+        const float* extent_x, const float* extent_y, const float* extent_z,
+        uint32_t count, uint8_t* visible, bool ignore_depth
+    ) const
+    {
+        // skip near and far plane checks if depth is to be ignored
+        const uint32_t plane_start = ignore_depth ? 2 : 0;
+
+        // a box is outside if it's fully behind any plane: dot(n, c) + d + dot(|n|, e) < 0
+        uint32_t i = 0;
+    #if defined(__AVX2__)
+        // 8 boxes per iteration
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 cx = _mm256_loadu_ps(center_x + i);
+            const __m256 cy = _mm256_loadu_ps(center_y + i);
+            const __m256 cz = _mm256_loadu_ps(center_z + i);
+            const __m256 ex = _mm256_loadu_ps(extent_x + i);
+            const __m256 ey = _mm256_loadu_ps(extent_y + i);
+            const __m256 ez = _mm256_loadu_ps(extent_z + i);
+
+            __m256 outside = _mm256_setzero_ps();
+            for (uint32_t p = plane_start; p < 6; p++)
+            {
+                const Plane& plane = m_planes[p];
+                __m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.normal.x), cx), _mm256_set1_ps(plane.d));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane.normal.y), cy));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane.normal.z), cz));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(fabs(plane.normal.x)), ex));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(fabs(plane.normal.y)), ey));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(fabs(plane.normal.z)), ez));
+                outside  = _mm256_or_ps(outside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(outside));
+            for (uint32_t lane = 0; lane < 8; lane++)
+            {
+                visible[i + lane] = ((mask >> lane) & 1) ? 0 : 1;
+            }
+        }
+    #elif defined(__SSE2__) || defined(_M_X64)
+        // 4 boxes per iteration
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 cx = _mm_loadu_ps(center_x + i);
+            const __m128 cy = _mm_loadu_ps(center_y + i);
+            const __m128 cz = _mm_loadu_ps(center_z + i);
+            const __m128 ex = _mm_loadu_ps(extent_x + i);
+            const __m128 ey = _mm_loadu_ps(extent_y + i);
+            const __m128 ez = _mm_loadu_ps(extent_z + i);
+
+            __m128 outside = _mm_setzero_ps();
+            for (uint32_t p = plane_start; p < 6; p++)
+            {
+                const Plane& plane = m_planes[p];
+                __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal.x), cx), _mm_set1_ps(plane.d));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane.normal.y), cy));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane.normal.z), cz));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(fabs(plane.normal.x)), ex));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(fabs(plane.normal.y)), ey));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(fabs(plane.normal.z)), ez));
+                outside  = _mm_or_ps(outside, _mm_cmplt_ps(d, _mm_setzero_ps()));
+            }
+
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(outside));
+            for (uint32_t lane = 0; lane < 4; lane++)
+            {
+                visible[i + lane] = ((mask >> lane) & 1) ? 0 : 1;
+            }
+        }
+    #elif defined(__ARM_NEON)
+        // 4 boxes per iteration
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4_t cx = vld1q_f32(center_x + i);
+            const float32x4_t cy = vld1q_f32(center_y + i);
+            const float32x4_t cz = vld1q_f32(center_z + i);
+            const float32x4_t ex = vld1q_f32(extent_x + i);
+            const float32x4_t ey = vld1q_f32(extent_y + i);
+            const float32x4_t ez = vld1q_f32(extent_z + i);
+
+            uint32x4_t outside = vdupq_n_u32(0);
+            for (uint32_t p = plane_start; p < 6; p++)
+            {
+                const Plane& plane = m_planes[p];
+                float32x4_t d = vmlaq_n_f32(vdupq_n_f32(plane.d), cx, plane.normal.x);
+                d             = vmlaq_n_f32(d, cy, plane.normal.y);
+                d             = vmlaq_n_f32(d, cz, plane.normal.z);
+                d             = vmlaq_n_f32(d, ex, fabs(plane.normal.x));
+                d             = vmlaq_n_f32(d, ey, fabs(plane.normal.y));
+                d             = vmlaq_n_f32(d, ez, fabs(plane.normal.z));
+                outside       = vorrq_u32(outside, vcltq_f32(d, vdupq_n_f32(0.0f)));
+            }
+
+            uint32_t lanes[4];
+            vst1q_u32(lanes, outside);
+            for (uint32_t lane = 0; lane < 4; lane++)
+            {
+                visible[i + lane] = lanes[lane] ? 0 : 1;
+            }
+        }
+    #endif
+
+        // scalar fallback and remainder
+        for (; i < count; i++)
+        {
+            bool outside = false;
+            for (uint32_t p = plane_start; p < 6 && !outside; p++)
+            {
+                const Plane& plane = m_planes[p];
+                const float d      = plane.normal.x * center_x[i] + plane.normal.y * center_y[i] + plane.normal.z * center_z[i] + plane.d;
+                const float r      = fabs(plane.normal.x) * extent_x[i] + fabs(plane.normal.y) * extent_y[i] + fabs(plane.normal.z) * extent_z[i];
+                outside            = d + r < 0.0f;
+            }
+
+            visible[i] = outside ? 0 : 1;
+        }
+    }
+
     Intersection Frustum::CheckCube(const Vector3& center, const Vector3& extent, float ignore_depth) const
     {
         SP_ASSERT(!center.IsNaN() && !extent.IsNaN());
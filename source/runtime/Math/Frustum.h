@@ -38,6 +38,13 @@ namespace spartan::math
 
         bool IsVisible(const Vector3& center, const Vector3& extent, bool ignore_depth = false) const;
 
+        // batched version of IsVisible() over boxes stored as structure of arrays, writes 1 (visible) or 0 (culled) per box
+        void AreVisible(
+            const float* center_x, const float* center_y, const float* center_z,
+            const float* extent_x, const float* extent_y, const float* extent_z,
+            uint32_t count, uint8_t* visible, bool ignore_depth = false
+        ) const;
+
     private:
         Intersection CheckCube(const Vector3& center, const Vector3& extent, float ignore_depth = false) const;
         Intersection CheckSphere(const Vector3& center, float radius, float ignore_depth = false) const;
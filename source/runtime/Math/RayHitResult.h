@@ -35,6 +35,7 @@ namespace spartan
         class RayHitResult
         {
         public:
+            RayHitResult() = default;
             RayHitResult(Entity* entity, const Vector3& position, float distance, bool is_inside)
             {
                 m_entity   = entity;
@@ -43,10 +44,11 @@ namespace spartan
                 m_inside   = is_inside;
             };
 
-            Entity* m_entity;
-            Vector3 m_position;
-            float m_distance;
-            bool m_inside;
+            Entity* m_entity   = nullptr;
+            Vector3 m_position = Vector3::Zero;
+            Vector3 m_normal   = Vector3::Zero;
+            float m_distance   = 0.0f;
+            bool m_inside      = false;
         };
     }
 }
@@ -44,13 +44,8 @@ namespace spartan
                 this->height = height;
             }
 
-            Rectangle(const Rectangle& rectangle)
-            {
-                x      = rectangle.x;
-                y      = rectangle.y;
-                width  = rectangle.width;
-                height = rectangle.height;
-            }
+            Rectangle(const Rectangle& rectangle)            = default;
+            Rectangle& operator=(const Rectangle& rectangle) = default;
 
             ~Rectangle() = default;
 
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pch.h"
 #include "Allocator.h"
 #include <cstring>
+#include <bit>
 #if defined(_WIN32)
 #include <Windows.h>
 #include <psapi.h>
@@ -31,6 +32,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #elif defined(__linux__)
 #include <unistd.h>
 #include <sys/resource.h>
+#include <sys/mman.h>
 #endif
 //===============================
 
@@ -50,21 +52,63 @@ namespace spartan
         constexpr unsigned char poison_allocated = 0xCD; // freshly allocated memory
         constexpr unsigned char poison_freed     = 0xDD; // freed memory
 
-        // thread-local cache settings
-        constexpr size_t cache_max_size       = 256;  // max allocation size to cache
-        constexpr size_t cache_max_entries    = 32;   // max entries per size class
-        constexpr size_t cache_size_classes   = 8;    // number of size classes: 32, 64, 96, 128, 160, 192, 224, 256
-        constexpr size_t cache_size_granularity = 32; // size class granularity
+        // slab settings
+        // allocations of up to 32 KB are served from size-class slabs, carved out of one reserved virtual range
+        // larger or over-aligned allocations go straight to the os with a header in front of them
+        constexpr size_t  slab_min_size       = 16;
+        constexpr size_t  slab_max_size       = 32 * 1024;
+        constexpr size_t  slab_max_alignment  = 64;                  // slots start on a cache line
+        constexpr size_t  slab_span_size      = 256 * 1024;          // a span serves a single size class
+        constexpr size_t  slab_region_size    = size_t(64) << 30;    // address space reserved up front, committed a span at a time
+        constexpr size_t  slab_class_count    = 40;                  // 16 - 128 in steps of 16, then 4 classes per power of two
+        constexpr size_t  slab_batch_bytes    = 16 * 1024;           // bytes moved per refill/flush between a thread and the central pool
+        constexpr uint8_t slab_tag_free       = 0xFF;                // tag of a free slot, catches double-frees
+
+        // size of each class
+        constexpr array<uint32_t, slab_class_count> slab_class_sizes = []()
+        {
+            array<uint32_t, slab_class_count> sizes = {};
+
+            uint32_t index = 0;
+            for (uint32_t size = 16; size <= 128; size += 16)
+            {
+                sizes[index++] = size;
+            }
+
+            for (uint32_t shift = 7; shift < 15; shift++)
+            {
+                for (uint32_t step = 1; step <= 4; step++)
+                {
+                    sizes[index++] = (1u << shift) + step * (1u << (shift - 2));
+                }
+            }
+
+            return sizes;
+        }();
+        static_assert(slab_class_sizes[slab_class_count - 1] == slab_max_size, "the last size class must match the slab limit");
+
+        // slots moved per refill/flush, so that small classes move many and large classes move few
+        constexpr array<uint32_t, slab_class_count> slab_batch_sizes = []()
+        {
+            array<uint32_t, slab_class_count> sizes = {};
+            for (size_t i = 0; i < slab_class_count; i++)
+            {
+                sizes[i] = clamp(static_cast<uint32_t>(slab_batch_bytes / slab_class_sizes[i]), 2u, 64u);
+            }
+
+            return sizes;
+        }();
 
         // global counters
-        atomic<size_t> bytes_allocated      = 0;
-        atomic<size_t> bytes_allocated_peak = 0;
-        atomic<size_t> allocation_count     = 0;
+        // signed since slab threads publish their deltas in batches, so a free can be published before its allocation
+        atomic<int64_t> bytes_allocated      = 0;
+        atomic<int64_t> bytes_allocated_peak = 0;
+        atomic<int64_t> allocation_count     = 0;
 
         // per-tag counters
-        atomic<size_t> bytes_by_tag[static_cast<size_t>(MemoryTag::Count)] = {};
+        atomic<int64_t> bytes_by_tag[static_cast<size_t>(MemoryTag::Count)] = {};
 
-        // header stores allocation metadata
+        // header stores allocation metadata (large allocations only)
         struct allocation_header
         {
             uint32_t  magic;  // magic number for corruption/double-free detection
@@ -74,72 +118,10 @@ namespace spartan
             uint8_t   padding[7]; // pad to maintain alignment
         };
 
-        // thread-local cache entry
-        struct cache_entry
-        {
-            void*  ptr;
-            size_t size;
-        };
-
-        // thread-local free list for small allocations
-        struct thread_cache
-        {
-            cache_entry entries[cache_size_classes][cache_max_entries];
-            size_t      count[cache_size_classes] = {};
-        };
-
-        thread_local thread_cache tl_cache = {};
-
-        // get size class index (0-7 for sizes 1-256)
-        size_t get_size_class(size_t size)
-        {
-            if (size == 0)
-                return 0;
-            return min((size - 1) / cache_size_granularity, cache_size_classes - 1);
-        }
-
-        // get actual size for a size class
-        size_t get_size_for_class(size_t size_class)
-        {
-            return (size_class + 1) * cache_size_granularity;
-        }
-
-        // try to get from thread-local cache
-        void* cache_try_get(size_t size)
-        {
-            if (size > cache_max_size)
-                return nullptr;
-
-            size_t size_class = get_size_class(size);
-            if (tl_cache.count[size_class] > 0)
-            {
-                tl_cache.count[size_class]--;
-                return tl_cache.entries[size_class][tl_cache.count[size_class]].ptr;
-            }
-            return nullptr;
-        }
-
-        // try to put into thread-local cache, returns true if cached
-        bool cache_try_put(void* ptr, size_t size)
-        {
-            if (size > cache_max_size)
-                return false;
-
-            size_t size_class = get_size_class(size);
-            if (tl_cache.count[size_class] < cache_max_entries)
-            {
-                tl_cache.entries[size_class][tl_cache.count[size_class]].ptr  = ptr;
-                tl_cache.entries[size_class][tl_cache.count[size_class]].size = size;
-                tl_cache.count[size_class]++;
-                return true;
-            }
-            return false;
-        }
-
         // atomically update peak if current value is higher
-        void update_peak(size_t current)
+        void update_peak(int64_t current)
         {
-            size_t peak = bytes_allocated_peak.load(memory_order_relaxed);
+            int64_t peak = bytes_allocated_peak.load(memory_order_relaxed);
             while (current > peak && !bytes_allocated_peak.compare_exchange_weak(peak, current, memory_order_relaxed, memory_order_relaxed))
             {
                 // peak is updated by compare_exchange_weak on failure
@@ -152,7 +134,7 @@ namespace spartan
             return (value + alignment - 1) & ~(alignment - 1);
         }
 
-        // perform the actual allocation (bypassing cache)
+        // perform a large allocation, directly from the os
         void* allocate_internal(size_t size, size_t alignment, MemoryTag tag)
         {
             // ensure minimum alignment for our header
@@ -190,15 +172,15 @@ namespace spartan
 #endif
 
             // update counters
-            size_t current = bytes_allocated.fetch_add(size, memory_order_relaxed) + size;
-            update_peak(current);
+            const int64_t size_signed = static_cast<int64_t>(size);
+            update_peak(bytes_allocated.fetch_add(size_signed, memory_order_relaxed) + size_signed);
             allocation_count.fetch_add(1, memory_order_relaxed);
-            bytes_by_tag[static_cast<size_t>(tag)].fetch_add(size, memory_order_relaxed);
+            bytes_by_tag[static_cast<size_t>(tag)].fetch_add(size_signed, memory_order_relaxed);
 
             return user_ptr;
         }
 
-        // perform the actual free (bypassing cache)
+        // perform a large free
         void free_internal(void* ptr)
         {
             const size_t header_size = sizeof(allocation_header);
@@ -238,9 +220,10 @@ namespace spartan
             void* raw = static_cast<char*>(ptr) - offset;
 
             // update counters
-            bytes_allocated.fetch_sub(size, memory_order_relaxed);
+            const int64_t size_signed = static_cast<int64_t>(size);
+            bytes_allocated.fetch_sub(size_signed, memory_order_relaxed);
             allocation_count.fetch_sub(1, memory_order_relaxed);
-            bytes_by_tag[static_cast<size_t>(tag)].fetch_sub(size, memory_order_relaxed);
+            bytes_by_tag[static_cast<size_t>(tag)].fetch_sub(size_signed, memory_order_relaxed);
 
 #if defined(_MSC_VER)
             _aligned_free(raw);
@@ -248,86 +231,660 @@ namespace spartan
             free(raw);
 #endif
         }
-    }
 
-    void* Allocator::Allocate(size_t size, size_t alignment, MemoryTag tag)
-    {
-        // try thread-local cache first for small allocations with default alignment
-        if (alignment <= alignof(allocation_header) && size <= cache_max_size)
+        // the allocator can't use a mutex that might allocate, and its critical sections are a handful of pointer swaps
+        struct spin_lock
         {
-            size_t size_class   = get_size_class(size);
-            size_t padded_size  = get_size_for_class(size_class);
-            void*  cached       = cache_try_get(padded_size);
-            if (cached)
+            atomic_flag flag;
+
+            void lock()
             {
-                // update header with new tag (size stays the same since it's from same size class)
-                const size_t header_size  = sizeof(allocation_header);
-                allocation_header* header = reinterpret_cast<allocation_header*>(static_cast<char*>(cached) - header_size);
-                
-                // re-activate the allocation
-                header->magic = allocation_magic_active;
-                header->tag   = tag;
+                while (flag.test_and_set(memory_order_acquire))
+                {
+                    while (flag.test(memory_order_relaxed))
+                    {
+                        this_thread::yield();
+                    }
+                }
+            }
 
-                // update tag counter (size is already counted from original allocation)
-                bytes_by_tag[static_cast<size_t>(tag)].fetch_add(header->size, memory_order_relaxed);
+            void unlock()
+            {
+                flag.clear(memory_order_release);
+            }
+        };
 
-#if defined(_DEBUG) || defined(DEBUG)
-                memset(cached, poison_allocated, header->size);
+        // virtual memory
+        void* os_reserve(size_t size)
+        {
+#if defined(_WIN32)
+            return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#elif defined(__linux__)
+            void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (ptr == MAP_FAILED)
+                return nullptr;
+
+        #if defined(MADV_HUGEPAGE)
+            // let transparent huge pages back the slabs
+            madvise(ptr, size, MADV_HUGEPAGE);
+        #endif
+            return ptr;
+#else
+            return nullptr; // unsupported platform, everything goes through the large path
+#endif
+        }
+
+        void os_release(void* ptr, size_t size)
+        {
+#if defined(_WIN32)
+            VirtualFree(ptr, 0, MEM_RELEASE);
+#elif defined(__linux__)
+            munmap(ptr, size);
 #endif
-                return cached;
+        }
+
+        bool os_commit(void* ptr, size_t size)
+        {
+#if defined(_WIN32)
+            return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#elif defined(__linux__)
+            return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#else
+            return false;
+#endif
+        }
+
+        // the slab region, spans are aligned to their size so a slot finds its span with a mask
+        atomic<uint8_t*> region_base   = nullptr;
+        atomic<size_t>   region_used   = 0;
+        atomic<bool>     region_failed = false;
+
+        uint8_t* region_get()
+        {
+            uint8_t* base = region_base.load(memory_order_acquire);
+            if (base || region_failed.load(memory_order_relaxed))
+                return base;
+
+            const size_t reserve_size = slab_region_size + slab_span_size;
+            uint8_t* reserved         = static_cast<uint8_t*>(os_reserve(reserve_size));
+            if (!reserved)
+            {
+                region_failed.store(true, memory_order_relaxed);
+                return nullptr;
+            }
+
+            // racing threads release their reservation and use the winner's
+            uint8_t* aligned  = reinterpret_cast<uint8_t*>(align_up(reinterpret_cast<uintptr_t>(reserved), slab_span_size));
+            uint8_t* expected = nullptr;
+            if (!region_base.compare_exchange_strong(expected, aligned, memory_order_acq_rel, memory_order_acquire))
+            {
+                os_release(reserved, reserve_size);
+                return expected;
             }
-            // cache miss - allocate with padded size for future caching
-            return allocate_internal(padded_size, alignment, tag);
+
+            return aligned;
         }
 
-        return allocate_internal(size, alignment, tag);
-    }
+        bool region_contains(const void* ptr)
+        {
+            const uint8_t* base = region_base.load(memory_order_acquire);
+            const uint8_t* p    = static_cast<const uint8_t*>(ptr);
+            return base && p >= base && p < base + slab_region_size;
+        }
 
-    void Allocator::Free(void* ptr)
-    {
-        if (!ptr)
-            return;
+        // commits the next span, spans are never returned to the os, their slots are recycled instead
+        uint8_t* region_allocate_span()
+        {
+            uint8_t* base = region_get();
+            if (!base)
+                return nullptr;
+
+            const size_t offset = region_used.fetch_add(slab_span_size, memory_order_relaxed);
+            if (offset + slab_span_size > slab_region_size)
+                return nullptr;
+
+            uint8_t* span = base + offset;
+            return os_commit(span, slab_span_size) ? span : nullptr;
+        }
+
+        // a free slot, next_batch is only used by the first slot of a batch in the central pool
+        struct free_node
+        {
+            free_node* next;
+            free_node* next_batch;
+        };
+        static_assert(sizeof(free_node) <= slab_min_size, "a free slot must fit in the smallest size class");
 
-        const size_t header_size = sizeof(allocation_header);
-        allocation_header* header = reinterpret_cast<allocation_header*>(static_cast<char*>(ptr) - header_size);
+        struct thread_heap;
 
-        // validate before accessing other fields
-        if (header->magic == allocation_magic_freed)
+        // lives at the start of every span, followed by one tag per slot and then the slots
+        struct span_header
         {
-            SP_LOG_ERROR("Double-free detected at address %p", ptr);
-            SP_ASSERT(false && "double-free detected");
-            return;
+            thread_heap* owner;        // heap that carved the span, frees from other threads are queued back to it
+            uint8_t*     slots;        // first slot, cache line aligned
+            uint64_t     reciprocal;   // ceil(2^40 / slot_size), turns the slot index lookup into a multiply
+            uint32_t     size_class;
+            uint32_t     slot_size;
+            uint32_t     slot_count;
+            uint32_t     carved;       // slots handed out so far, the rest have never been touched
+
+            uint8_t* GetTags()
+            {
+                return reinterpret_cast<uint8_t*>(this + 1);
+            }
+
+            uint32_t GetSlotIndex(const void* ptr) const
+            {
+                return static_cast<uint32_t>((static_cast<uint64_t>(static_cast<const uint8_t*>(ptr) - slots) * reciprocal) >> 40);
+            }
+        };
+
+        span_header* span_of(const void* ptr)
+        {
+            return reinterpret_cast<span_header*>(reinterpret_cast<uintptr_t>(ptr) & ~(slab_span_size - 1));
         }
-        if (header->magic != allocation_magic_active)
+
+        span_header* span_create(uint32_t size_class, thread_heap* owner)
         {
-            SP_LOG_ERROR("Memory corruption detected at address %p (magic: 0x%08X)", ptr, header->magic);
-            SP_ASSERT(false && "memory corruption detected");
-            return;
+            uint8_t* memory = region_allocate_span();
+            if (!memory)
+                return nullptr;
+
+            const uint32_t slot_size  = slab_class_sizes[size_class];
+            const uint32_t slot_count = static_cast<uint32_t>((slab_span_size - sizeof(span_header) - slab_max_alignment) / (slot_size + 1));
+
+            span_header* span = new (memory) span_header();
+            span->owner       = owner;
+            span->slots       = reinterpret_cast<uint8_t*>(align_up(reinterpret_cast<uintptr_t>(span->GetTags() + slot_count), slab_max_alignment));
+            span->reciprocal  = ((uint64_t(1) << 40) + slot_size - 1) / slot_size;
+            span->size_class  = size_class;
+            span->slot_size   = slot_size;
+            span->slot_count  = slot_count;
+            span->carved      = 0;
+            memset(span->GetTags(), slab_tag_free, slot_count);
+
+            return span;
         }
 
-        size_t size = header->size;
+        // central pool, exchanges whole batches with the thread heaps
+        struct central_pool
+        {
+            spin_lock  lock;
+            free_node* batches     = nullptr; // full batches, linked through next_batch
+            free_node* loose       = nullptr; // single slots, from exited threads and frees without a heap
+            uint32_t   loose_count = 0;
+        };
 
-        // update tag counter before potential caching
-        bytes_by_tag[static_cast<size_t>(header->tag)].fetch_sub(size, memory_order_relaxed);
+        central_pool central_pools[slab_class_count];
 
-        // try to cache small allocations
-        if (size <= cache_max_size)
+        // expects the pool to be locked
+        void central_push_loose(central_pool& pool, uint32_t size_class, free_node* node)
         {
-            // mark as freed but keep in cache
-            header->magic = allocation_magic_freed;
+            node->next  = pool.loose;
+            pool.loose  = node;
+            pool.loose_count++;
+
+            // promote to a batch once there are enough
+            if (pool.loose_count == slab_batch_sizes[size_class])
+            {
+                pool.loose->next_batch = pool.batches;
+                pool.batches           = pool.loose;
+                pool.loose             = nullptr;
+                pool.loose_count       = 0;
+            }
+        }
+
+        // per thread cache of free slots
+        struct thread_heap
+        {
+            free_node*         free_lists[slab_class_count]  = {};
+            uint32_t           free_counts[slab_class_count] = {};
+            span_header*       carving[slab_class_count]     = {};      // span fresh slots are carved from
+            atomic<free_node*> remote_frees                  = nullptr; // slots of our spans freed by other threads
+            atomic<bool>       orphaned                      = false;   // owning thread exited, frees go to the central pool
+            thread_heap*       next_orphan                   = nullptr;
+
+            // counters are published to the globals on refill/flush, keeping atomics off the hot path
+            int64_t bytes_delta                                      = 0;
+            int64_t count_delta                                      = 0;
+            int64_t tag_delta[static_cast<size_t>(MemoryTag::Count)] = {};
+        };
+
+        spin_lock    heap_lock;
+        thread_heap* heap_orphans      = nullptr;
+        uint8_t*     heap_storage      = nullptr;
+        size_t       heap_storage_left = 0;
+
+        thread_local thread_heap* tl_heap          = nullptr;
+        thread_local bool         tl_heap_released = false;
+
+        void heap_publish_counters(thread_heap* heap)
+        {
+            if (heap->bytes_delta != 0)
+            {
+                const int64_t current = bytes_allocated.fetch_add(heap->bytes_delta, memory_order_relaxed) + heap->bytes_delta;
+                if (heap->bytes_delta > 0)
+                {
+                    update_peak(current);
+                }
+                heap->bytes_delta = 0;
+            }
+
+            if (heap->count_delta != 0)
+            {
+                allocation_count.fetch_add(heap->count_delta, memory_order_relaxed);
+                heap->count_delta = 0;
+            }
+
+            for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++)
+            {
+                if (heap->tag_delta[i] != 0)
+                {
+                    bytes_by_tag[i].fetch_add(heap->tag_delta[i], memory_order_relaxed);
+                    heap->tag_delta[i] = 0;
+                }
+            }
+        }
+
+        // hands a full batch from the front of a free list to the central pool
+        void heap_flush(thread_heap* heap, uint32_t size_class)
+        {
+            const uint32_t batch_size = slab_batch_sizes[size_class];
+
+            free_node* head = heap->free_lists[size_class];
+            free_node* tail = head;
+            for (uint32_t i = 1; i < batch_size; i++)
+            {
+                tail = tail->next;
+            }
+            heap->free_lists[size_class]   = tail->next;
+            heap->free_counts[size_class] -= batch_size;
+            tail->next                     = nullptr;
+
+            central_pool& pool = central_pools[size_class];
+            {
+                lock_guard<spin_lock> lock(pool.lock);
+                head->next_batch = pool.batches;
+                pool.batches     = head;
+            }
+
+            heap_publish_counters(heap);
+        }
+
+        void heap_push(thread_heap* heap, uint32_t size_class, free_node* node)
+        {
+            node->next                   = heap->free_lists[size_class];
+            heap->free_lists[size_class] = node;
+
+            if (++heap->free_counts[size_class] > slab_batch_sizes[size_class] * 2)
+            {
+                heap_flush(heap, size_class);
+            }
+        }
+
+        // moves the slots other threads freed back into our free lists
+        void heap_drain_remote(thread_heap* heap)
+        {
+            free_node* node = heap->remote_frees.exchange(nullptr, memory_order_acquire);
+            while (node)
+            {
+                free_node* next = node->next;
+                heap_push(heap, span_of(node)->size_class, node);
+                node = next;
+            }
+        }
+
+        void heap_push_remote(thread_heap* owner, free_node* node)
+        {
+            free_node* head = owner->remote_frees.load(memory_order_relaxed);
+            do
+            {
+                node->next = head;
+            } while (!owner->remote_frees.compare_exchange_weak(head, node, memory_order_release, memory_order_relaxed));
+        }
+
+        // refills an empty free list: a batch from the central pool, otherwise fresh slots from our own span
+        bool heap_refill(thread_heap* heap, uint32_t size_class)
+        {
+            central_pool& pool = central_pools[size_class];
+            {
+                lock_guard<spin_lock> lock(pool.lock);
+                if (pool.batches)
+                {
+                    heap->free_lists[size_class]  = pool.batches;
+                    heap->free_counts[size_class] = slab_batch_sizes[size_class];
+                    pool.batches                  = pool.batches->next_batch;
+                    return true;
+                }
+
+                if (pool.loose)
+                {
+                    heap->free_lists[size_class]  = pool.loose;
+                    heap->free_counts[size_class] = pool.loose_count;
+                    pool.loose                    = nullptr;
+                    pool.loose_count              = 0;
+                    return true;
+                }
+            }
+
+            span_header* span = heap->carving[size_class];
+            if (!span || span->carved == span->slot_count)
+            {
+                span = span_create(size_class, heap);
+                if (!span)
+                    return false;
+
+                heap->carving[size_class] = span;
+            }
+
+            // carve back to front so the list hands out ascending addresses
+            const uint32_t count = min(slab_batch_sizes[size_class], span->slot_count - span->carved);
+            free_node* head      = nullptr;
+            for (uint32_t i = count; i > 0; i--)
+            {
+                free_node* node = reinterpret_cast<free_node*>(span->slots + static_cast<size_t>(span->carved + i - 1) * span->slot_size);
+                node->next      = head;
+                head            = node;
+            }
+            span->carved += count;
+
+            heap->free_lists[size_class]  = head;
+            heap->free_counts[size_class] = count;
+
+            heap_publish_counters(heap);
+            return true;
+        }
+
+        // runs when a thread exits, its cached slots go to the central pool and the heap waits to be adopted
+        void heap_release()
+        {
+            thread_heap* heap = tl_heap;
+            tl_heap           = nullptr;
+            tl_heap_released  = true;
+            if (!heap)
+                return;
+
+            heap->orphaned.store(true, memory_order_release);
+            heap_drain_remote(heap);
+
+            for (uint32_t size_class = 0; size_class < slab_class_count; size_class++)
+            {
+                while (heap->free_counts[size_class] >= slab_batch_sizes[size_class])
+                {
+                    heap_flush(heap, size_class);
+                }
+
+                central_pool& pool = central_pools[size_class];
+                lock_guard<spin_lock> lock(pool.lock);
+                while (free_node* node = heap->free_lists[size_class])
+                {
+                    heap->free_lists[size_class] = node->next;
+                    central_push_loose(pool, size_class, node);
+                }
+                heap->free_counts[size_class] = 0;
+            }
+
+            heap_publish_counters(heap);
+
+            lock_guard<spin_lock> lock(heap_lock);
+            heap->next_orphan = heap_orphans;
+            heap_orphans      = heap;
+        }
+
+        struct heap_release_guard
+        {
+            bool active = false;
+
+            ~heap_release_guard()
+            {
+                if (active)
+                {
+                    heap_release();
+                }
+            }
+        };
+
+        thread_local heap_release_guard tl_heap_guard;
+
+        // returns the calling thread's heap, adopting an orphan or creating one on first use
+        thread_heap* heap_get()
+        {
+            if (tl_heap || tl_heap_released)
+                return tl_heap;
+
+            thread_heap* heap = nullptr;
+            {
+                lock_guard<spin_lock> lock(heap_lock);
+                if (heap_orphans)
+                {
+                    heap         = heap_orphans;
+                    heap_orphans = heap->next_orphan;
+                }
+                else
+                {
+                    const size_t heap_size = align_up(sizeof(thread_heap), slab_max_alignment);
+                    if (heap_storage_left < heap_size)
+                    {
+                        heap_storage      = region_allocate_span();
+                        heap_storage_left = heap_storage ? slab_span_size : 0;
+                    }
+
+                    if (heap_storage)
+                    {
+                        heap               = new (heap_storage) thread_heap();
+                        heap_storage      += heap_size;
+                        heap_storage_left -= heap_size;
+                    }
+                }
+            }
+
+            if (!heap)
+                return nullptr;
+
+            heap->orphaned.store(false, memory_order_release);
+            heap->next_orphan    = nullptr;
+            tl_heap              = heap;
+            tl_heap_guard.active = true;
+            heap_drain_remote(heap);
+
+            return heap;
+        }
+
+        // returns the size class an allocation fits in, or slab_class_count if it doesn't fit in any
+        uint32_t slab_class_of(size_t size, size_t alignment)
+        {
+            size = align_up(max(size, slab_min_size), alignment);
+            if (size > slab_max_size || alignment > slab_max_alignment)
+                return static_cast<uint32_t>(slab_class_count);
+
+            uint32_t size_class = 0;
+            if (size <= 128)
+            {
+                size_class = static_cast<uint32_t>((size + 15) / 16 - 1);
+            }
+            else
+            {
+                const uint32_t shift = static_cast<uint32_t>(bit_width(size - 1)) - 1;
+                const uint32_t step  = static_cast<uint32_t>((size - 1 - (size_t(1) << shift)) >> (shift - 2));
+                size_class           = 8 + (shift - 7) * 4 + step;
+            }
+
+            // slots are laid out from a cache line aligned start, so a class only satisfies alignments that divide its size
+            while (size_class < slab_class_count && (slab_class_sizes[size_class] & (alignment - 1)) != 0)
+            {
+                size_class++;
+            }
+
+            return size_class;
+        }
+
+        void* slab_allocate(uint32_t size_class, MemoryTag tag)
+        {
+            thread_heap* heap = heap_get();
+            if (!heap)
+                return nullptr;
+
+            if (!heap->free_lists[size_class])
+            {
+                heap_drain_remote(heap);
+                if (!heap->free_lists[size_class] && !heap_refill(heap, size_class))
+                    return nullptr;
+            }
+
+            free_node* node              = heap->free_lists[size_class];
+            heap->free_lists[size_class] = node->next;
+            heap->free_counts[size_class]--;
+
+            span_header* span                           = span_of(node);
+            span->GetTags()[span->GetSlotIndex(node)] = static_cast<uint8_t>(tag);
+
+            const int64_t size = span->slot_size;
+            heap->bytes_delta += size;
+            heap->count_delta++;
+            heap->tag_delta[static_cast<size_t>(tag)] += size;
 
 #if defined(_DEBUG) || defined(DEBUG)
-            memset(ptr, poison_freed, size);
+            memset(node, poison_allocated, span->slot_size);
+#endif
+
+            return node;
+        }
+
+        void slab_free(void* ptr)
+        {
+            span_header* span   = span_of(ptr);
+            const uint32_t slot = span->GetSlotIndex(ptr);
+
+            // validate, the slot must be the start of a live allocation
+            if (ptr < span->slots || slot >= span->slot_count || span->slots + static_cast<size_t>(slot) * span->slot_size != ptr)
+            {
+                SP_LOG_ERROR("Memory corruption detected at address %p (not a slab allocation)", ptr);
+                SP_ASSERT(false && "memory corruption detected");
+                return;
+            }
+
+            uint8_t& tag = span->GetTags()[slot];
+            if (tag == slab_tag_free)
+            {
+                SP_LOG_ERROR("Double-free detected at address %p", ptr);
+                SP_ASSERT(false && "double-free detected");
+                return;
+            }
+
+            const size_t tag_index = tag;
+            tag                    = slab_tag_free;
+
+#if defined(_DEBUG) || defined(DEBUG)
+            // poison freed memory in debug builds to catch use-after-free
+            memset(ptr, poison_freed, span->slot_size);
 #endif
 
-            if (cache_try_put(ptr, size))
+            free_node* node    = static_cast<free_node*>(ptr);
+            const int64_t size = span->slot_size;
+            thread_heap* heap  = heap_get();
+            if (heap)
+            {
+                heap->bytes_delta -= size;
+                heap->count_delta--;
+                heap->tag_delta[tag_index] -= size;
+            }
+            else
+            {
+                bytes_allocated.fetch_sub(size, memory_order_relaxed);
+                allocation_count.fetch_sub(1, memory_order_relaxed);
+                bytes_by_tag[tag_index].fetch_sub(size, memory_order_relaxed);
+            }
+
+            // our own slot, straight back to the free list
+            if (heap && span->owner == heap)
+            {
+                heap_push(heap, span->size_class, node);
+                return;
+            }
+
+            // another thread's slot, queue it back to its owner
+            if (!span->owner->orphaned.load(memory_order_acquire))
             {
-                // successfully cached - don't actually free
-                // note: counters stay as-is since memory is still "allocated" from system perspective
+                heap_push_remote(span->owner, node);
                 return;
             }
-            // cache full - restore magic and fall through to actual free
-            header->magic = allocation_magic_active;
+
+            // the owner exited
+            central_pool& pool = central_pools[span->size_class];
+            lock_guard<spin_lock> lock(pool.lock);
+            central_push_loose(pool, span->size_class, node);
+        }
+
+        // frame allocator
+        constexpr uint32_t frame_count              = 3;
+        constexpr size_t   frame_reserve_size       = size_t(256) << 20; // address space per frame
+        constexpr size_t   frame_commit_granularity = size_t(1) << 20;   // committed on demand, and kept across frames
+
+        struct frame_arena
+        {
+            uint8_t*        base      = nullptr;
+            atomic<size_t>  used      = 0;
+            atomic<size_t>  committed = 0;
+            spin_lock       commit_lock;
+            atomic<int64_t> bytes_by_tag[static_cast<size_t>(MemoryTag::Count)] = {};
+        };
+
+        frame_arena      frame_arenas[frame_count];
+        atomic<uint32_t> frame_index       = 0;
+        atomic<bool>     frame_initialized = false;
+        spin_lock        frame_init_lock;
+        atomic<int64_t>  frame_high_water_by_tag[static_cast<size_t>(MemoryTag::Count)] = {};
+
+        bool frame_initialize()
+        {
+            if (frame_initialized.load(memory_order_acquire))
+                return true;
+
+            lock_guard<spin_lock> lock(frame_init_lock);
+            if (frame_initialized.load(memory_order_relaxed))
+                return true;
+
+            for (frame_arena& arena : frame_arenas)
+            {
+                if (!arena.base)
+                {
+                    arena.base = static_cast<uint8_t*>(os_reserve(frame_reserve_size));
+                }
+
+                if (!arena.base)
+                {
+                    SP_LOG_ERROR("Failed to reserve %zu MB for the frame allocator", frame_reserve_size >> 20);
+                    return false;
+                }
+            }
+
+            frame_initialized.store(true, memory_order_release);
+            return true;
+        }
+    }
+
+    void* Allocator::Allocate(size_t size, size_t alignment, MemoryTag tag)
+    {
+        // small allocations go to the slabs
+        const uint32_t size_class = slab_class_of(size, alignment);
+        if (size_class < slab_class_count)
+        {
+            if (void* ptr = slab_allocate(size_class, tag))
+                return ptr;
+        }
+
+        return allocate_internal(size, alignment, tag);
+    }
+
+    void Allocator::Free(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        if (region_contains(ptr))
+        {
+            slab_free(ptr);
+            return;
         }
 
         free_internal(ptr);
@@ -335,6 +892,14 @@ namespace spartan
 
     void Allocator::Tick()
     {
+        FrameAllocator::Tick();
+
+        // publish the calling thread's pending slab counters so the readings below are current
+        if (tl_heap)
+        {
+            heap_publish_counters(tl_heap);
+        }
+
         static bool has_warned                    = false; // only warn once per threshold crossing
         constexpr float warning_threshold_percent = 90.0f; // 90%
     
@@ -363,7 +928,7 @@ namespace spartan
 
     float Allocator::GetMemoryAllocatedMb()
     {
-         return static_cast<float>(bytes_allocated) / (1024.0f * 1024.0f);
+         return static_cast<float>(max<int64_t>(bytes_allocated.load(memory_order_relaxed), 0)) / (1024.0f * 1024.0f);
     }
 
     float Allocator::GetMemoryProcessUsedMb()
@@ -433,7 +998,7 @@ namespace spartan
 
     float Allocator::GetMemoryAllocatedPeakMb()
     {
-        return static_cast<float>(bytes_allocated_peak) / (1024.0f * 1024.0f);
+        return static_cast<float>(bytes_allocated_peak.load(memory_order_relaxed)) / (1024.0f * 1024.0f);
     }
 
     float Allocator::GetMemoryAllocatedByTagMb(MemoryTag tag)
@@ -441,7 +1006,7 @@ namespace spartan
         size_t index = static_cast<size_t>(tag);
         if (index >= static_cast<size_t>(MemoryTag::Count))
             return 0.0f;
-        return static_cast<float>(bytes_by_tag[index].load(memory_order_relaxed)) / (1024.0f * 1024.0f);
+        return static_cast<float>(max<int64_t>(bytes_by_tag[index].load(memory_order_relaxed), 0)) / (1024.0f * 1024.0f);
     }
 
     const char* Allocator::GetTagName(MemoryTag tag)
@@ -463,4 +1028,90 @@ namespace spartan
             return "Unknown";
         return tag_names[index];
     }
+
+    void* FrameAllocator::Allocate(size_t size, size_t alignment, MemoryTag tag)
+    {
+        if (!frame_initialize())
+            return nullptr;
+
+        frame_arena& arena = frame_arenas[frame_index.load(memory_order_acquire)];
+
+        // bump
+        size_t offset = arena.used.load(memory_order_relaxed);
+        size_t start  = 0;
+        size_t end    = 0;
+        do
+        {
+            start = align_up(offset, alignment);
+            end   = start + size;
+            if (end > frame_reserve_size)
+            {
+                SP_LOG_ERROR("Frame allocator exhausted, failed to allocate %zu bytes", size);
+                return nullptr;
+            }
+        } while (!arena.used.compare_exchange_weak(offset, end, memory_order_relaxed, memory_order_relaxed));
+
+        // commit more pages if needed
+        if (end > arena.committed.load(memory_order_acquire))
+        {
+            lock_guard<spin_lock> lock(arena.commit_lock);
+            const size_t committed = arena.committed.load(memory_order_relaxed);
+            if (end > committed)
+            {
+                const size_t target = min(align_up(end, frame_commit_granularity), frame_reserve_size);
+                if (!os_commit(arena.base + committed, target - committed))
+                {
+                    SP_LOG_ERROR("Failed to commit memory for the frame allocator");
+                    return nullptr;
+                }
+                arena.committed.store(target, memory_order_release);
+            }
+        }
+
+        arena.bytes_by_tag[static_cast<size_t>(tag)].fetch_add(static_cast<int64_t>(size), memory_order_relaxed);
+
+        return arena.base + start;
+    }
+
+    void FrameAllocator::Tick()
+    {
+        if (!frame_initialized.load(memory_order_acquire))
+            return;
+
+        // the oldest frame is the next one, its allocations are done so record its high-water marks and recycle it
+        const uint32_t next = (frame_index.load(memory_order_relaxed) + 1) % frame_count;
+        frame_arena& arena  = frame_arenas[next];
+        for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); i++)
+        {
+            const int64_t bytes = arena.bytes_by_tag[i].exchange(0, memory_order_relaxed);
+            if (bytes > frame_high_water_by_tag[i].load(memory_order_relaxed))
+            {
+                frame_high_water_by_tag[i].store(bytes, memory_order_relaxed);
+            }
+        }
+
+#if defined(_DEBUG) || defined(DEBUG)
+        // poison recycled memory in debug builds to catch frame allocations used past their lifetime
+        memset(arena.base, poison_freed, min(arena.used.load(memory_order_relaxed), arena.committed.load(memory_order_relaxed)));
+#endif
+
+        arena.used.store(0, memory_order_relaxed);
+        frame_index.store(next, memory_order_release);
+    }
+
+    float FrameAllocator::GetMemoryAllocatedMb()
+    {
+        if (!frame_initialized.load(memory_order_acquire))
+            return 0.0f;
+
+        return static_cast<float>(frame_arenas[frame_index.load(memory_order_acquire)].used.load(memory_order_relaxed)) / (1024.0f * 1024.0f);
+    }
+
+    float FrameAllocator::GetMemoryHighWaterMarkMb(MemoryTag tag)
+    {
+        size_t index = static_cast<size_t>(tag);
+        if (index >= static_cast<size_t>(MemoryTag::Count))
+            return 0.0f;
+        return static_cast<float>(frame_high_water_by_tag[index].load(memory_order_relaxed)) / (1024.0f * 1024.0f);
+    }
 }
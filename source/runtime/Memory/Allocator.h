@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====
 #include <cstddef>
 #include <cstdint>
+#include <new>
+#include <vector>
 //================
 
 namespace spartan
@@ -69,10 +71,64 @@ namespace spartan
         // total physical system memory
         static float GetMemoryTotalMb();
 
-        // memory allocated by a specific tag/subsystem
+        // memory currently allocated by a specific tag/subsystem, the frame allocator reports its high-water marks separately
         static float GetMemoryAllocatedByTagMb(MemoryTag tag);
 
         // get tag name as string
         static const char* GetTagName(MemoryTag tag);
     };
+
+    // per-frame linear allocator
+    // allocations are a pointer bump and are never freed individually, the frames are triple buffered
+    // so memory stays valid for the frame it was allocated in and the two after it
+    class FrameAllocator
+    {
+    public:
+        // thread-safe, returns nullptr if the frame ran out of reserved space
+        static void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t), MemoryTag tag = MemoryTag::Untagged);
+
+        // recycles the oldest frame, called once per frame by Allocator::Tick()
+        static void Tick();
+
+        // memory allocated so far in the current frame
+        static float GetMemoryAllocatedMb();
+
+        // highest amount of memory a tag has allocated in a single frame
+        static float GetMemoryHighWaterMarkMb(MemoryTag tag);
+    };
+
+    // stl compatible adaptor, deallocation is a no-op
+    template <typename T>
+    class FrameStlAllocator
+    {
+    public:
+        using value_type = T;
+
+        FrameStlAllocator(MemoryTag tag = MemoryTag::Untagged) noexcept : m_tag(tag) {}
+        template <typename U>
+        FrameStlAllocator(const FrameStlAllocator<U>& other) noexcept : m_tag(other.GetTag()) {}
+
+        T* allocate(std::size_t count)
+        {
+            void* ptr = FrameAllocator::Allocate(count * sizeof(T), alignof(T), m_tag);
+            if (!ptr)
+                throw std::bad_alloc();
+
+            return static_cast<T*>(ptr);
+        }
+
+        void deallocate(T*, std::size_t) noexcept {} // released in bulk when the frame is recycled
+
+        MemoryTag GetTag() const { return m_tag; }
+
+        template <typename U>
+        bool operator==(const FrameStlAllocator<U>&) const noexcept { return true; }
+
+    private:
+        MemoryTag m_tag = MemoryTag::Untagged;
+    };
+
+    // a vector that lives for the current frame, reserve up front when the size is known since growth doesn't reclaim memory
+    template <typename T>
+    using FrameVector = std::vector<T, FrameStlAllocator<T>>;
 }
@@ -29,6 +29,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World/Components/Camera.h"
 #include "../World/Components/Physics.h"
 #include "../World/World.h"
+#include "../World/Entity.h"
+#include "../Core/ThreadPool.h"
 SP_WARNINGS_OFF
 #ifdef DEBUG
     #define _DEBUG 1
@@ -191,14 +193,93 @@ namespace spartan
         }
     };
 
+    // runs physx tasks on the engine's thread pool instead of a pool of physx's own, so the two don't fight over cores
+    class ThreadPoolDispatcher : public PxCpuDispatcher
+    {
+    public:
+        void submitTask(PxBaseTask& task) override
+        {
+            // the main thread blocks in fetchResults() until these are done, so they go ahead of everything else
+            ThreadPool::AddTask([&task]()
+            {
+                task.run();
+                task.release();
+            }, m_pending, TaskPriority::High);
+        }
+
+        // physx splits its work into about this many tasks, read every step so the console variable applies right away
+        uint32_t getWorkerCount() const override
+        {
+            const uint32_t thread_count = max(ThreadPool::GetThreadCount(), 1u);
+            const uint32_t requested    = static_cast<uint32_t>(max(cvar_physics_threads.GetValue(), 0.0f));
+            return requested == 0 ? thread_count : min(requested, thread_count);
+        }
+
+        void Flush() { ThreadPool::Wait(m_pending); }
+
+    private:
+        JobCounter m_pending;
+    };
+
     namespace
     {
         static PxDefaultAllocator allocator;
         static PhysXLogging logger;
-        static PxFoundation* foundation           = nullptr;
-        static PxPhysics* physics                 = nullptr;
-        static PxScene* scene                     = nullptr;
-        static PxDefaultCpuDispatcher* dispatcher = nullptr;
+        static PxFoundation* foundation          = nullptr;
+        static PxPhysics* physics                = nullptr;
+        static PxScene* scene                    = nullptr;
+        static ThreadPoolDispatcher* dispatcher = nullptr;
+    }
+
+    namespace stepping
+    {
+        float accumulated_time = 0.0f;
+        float alpha            = 1.0f;  // how far past the last completed step the frame is, in steps
+        bool step_due          = false; // async mode, the last step of the frame waits for PostTick()
+        bool simulating        = false; // a step is in flight, guarded by scene_mutex
+        uint64_t step_index    = 0;     // the last step taken
+
+        // async mode, the poses of the dynamic bodies before a step are what the interpolation blends from
+        // they are kept by the physics components, tagged with the step they precede, so a pose from an older step is never used
+        vector<PxActor*> actors;
+
+        void capture_poses()
+        {
+            actors.resize(scene->getNbActors(PxActorTypeFlag::eRIGID_DYNAMIC));
+            scene->getActors(PxActorTypeFlag::eRIGID_DYNAMIC, actors.data(), static_cast<PxU32>(actors.size()));
+
+            for (PxActor* actor : actors)
+            {
+                PxRigidActor* rigid_actor = static_cast<PxRigidActor*>(actor);
+                Entity* entity            = static_cast<Entity*>(rigid_actor->userData);
+                if (Physics* physics = entity ? entity->GetComponent<Physics>() : nullptr)
+                {
+                    const PxTransform pose = rigid_actor->getGlobalPose();
+                    physics->SetPosePrevious(rigid_actor, Vector3(pose.p.x, pose.p.y, pose.p.z), Quaternion(pose.q.x, pose.q.y, pose.q.z, pose.q.w), step_index + 1);
+                }
+            }
+        }
+
+        // the scene can't be written to while a step is in flight, so anything that does lands it first (scene_mutex held)
+        void fetch()
+        {
+            if (!simulating)
+                return;
+
+            SP_PROFILE_CPU_START("physics_fetch_results");
+            scene->fetchResults(true); // block
+            SP_PROFILE_CPU_END();
+            simulating = false;
+        }
+
+        void simulate(const float time_step)
+        {
+            SP_PROFILE_CPU_START("physics_simulate");
+            scene->simulate(time_step);
+            SP_PROFILE_CPU_END();
+            simulating = true;
+            step_index++;
+        }
     }
 
     void PhysicsWorld::Initialize()
@@ -215,17 +296,15 @@ namespace spartan
         SP_ASSERT(physics);
 
         // scene
+        dispatcher = new ThreadPoolDispatcher();
         PxSceneDesc scene_desc(physics->getTolerancesScale());
         scene_desc.gravity        = PxVec3(0.0f, settings::gravity, 0.0f);
-        scene_desc.cpuDispatcher  = PxDefaultCpuDispatcherCreate(2);
+        scene_desc.cpuDispatcher  = dispatcher;
         scene_desc.filterShader   = PxDefaultSimulationFilterShader;
         scene_desc.flags         |= PxSceneFlag::eENABLE_CCD; // enable continuous collision detection to reduce tunneling
         scene                     = physics->createScene(scene_desc);
         SP_ASSERT(scene);
 
-        // store dispatcher
-        dispatcher = static_cast<PxDefaultCpuDispatcher*>(scene_desc.cpuDispatcher);
-
         // enable all debug visualization parameters
         scene->setVisualizationParameter(PxVisualizationParameter::eSCALE, 1.0f);
         scene->setVisualizationParameter(PxVisualizationParameter::eWORLD_AXES, 1.0f);
@@ -244,6 +323,12 @@ namespace spartan
 
     void PhysicsWorld::Shutdown()
     {
+        // land a step in flight first, everything below writes to the scene
+        {
+            lock_guard<mutex> lock(scene_mutex);
+            stepping::fetch();
+        }
+
         // cleanup picking
         picking::UnpickBody();
 
@@ -251,8 +336,14 @@ namespace spartan
         Physics::Shutdown();
 
         // release physx resources
+        // tasks still in flight release themselves into the scene, so they drain before it goes
+        if (dispatcher)
+        {
+            dispatcher->Flush();
+        }
         PX_RELEASE(scene);
-        PX_RELEASE(dispatcher);
+        delete dispatcher;
+        dispatcher = nullptr;
         PX_RELEASE(physics);
         PX_RELEASE(foundation);
     }
@@ -261,6 +352,13 @@ namespace spartan
     {
         SP_PROFILE_CPU();
 
+        // land the step left running last frame before anything reads or writes the scene
+        {
+            lock_guard<mutex> lock(scene_mutex);
+            stepping::fetch();
+        }
+        stepping::step_due = false;
+
         // skip if loading
         if (ProgressTracker::IsLoading())
             return;
@@ -269,20 +367,38 @@ namespace spartan
         {
             // simulation
             {
-                const float fixed_time_step   = 1.0f / settings::hz;
-                static float accumulated_time = 0.0f;
+                const float fixed_time_step = 1.0f / settings::hz;
+                const bool async            = cvar_physics_async.GetValueAs<bool>();
 
                 // accumulate delta time
-                accumulated_time += static_cast<float>(Timer::GetDeltaTimeSec());
+                stepping::accumulated_time += static_cast<float>(Timer::GetDeltaTimeSec());
 
                 // perform simulation steps
-                while (accumulated_time >= fixed_time_step)
+                lock_guard<mutex> lock(scene_mutex);
+                while (stepping::accumulated_time >= fixed_time_step)
                 {
+                    stepping::accumulated_time -= fixed_time_step;
+
+                    // async mode leaves the last step of the frame to PostTick()
+                    const bool step_last = stepping::accumulated_time < fixed_time_step;
+                    if (async && step_last)
+                    {
+                        stepping::step_due = true;
+                        break;
+                    }
+
+                    // the poses before the last completed step are what gets blended from, a step taken
+                    // here (a slow frame) may be that step if PostTick() doesn't get to kick another one
+                    if (async)
+                    {
+                        stepping::capture_poses();
+                    }
+
                     // simulate one fixed time step
-                    scene->simulate(fixed_time_step);
-                    scene->fetchResults(true); // block
-                    accumulated_time -= fixed_time_step;
+                    stepping::simulate(fixed_time_step);
+                    stepping::fetch();
                 }
+                stepping::alpha = stepping::accumulated_time / fixed_time_step;
             }
             // object picking
             {
@@ -316,11 +432,46 @@ namespace spartan
         }
     }
 
+    void PhysicsWorld::PostTick()
+    {
+        if (!stepping::step_due)
+            return;
+        stepping::step_due = false;
+
+        lock_guard<mutex> lock(scene_mutex);
+        stepping::capture_poses();
+        stepping::simulate(1.0f / settings::hz);
+    }
+
+    void PhysicsWorld::GetInterpolatedPose(PxRigidActor* actor, Vector3& position, Quaternion& rotation)
+    {
+        const PxTransform pose_current = actor->getGlobalPose();
+        Vector3 position_current(pose_current.p.x, pose_current.p.y, pose_current.p.z);
+        Quaternion rotation_current(pose_current.q.x, pose_current.q.y, pose_current.q.z, pose_current.q.w);
+
+        // only the async mode blends, it's what hides the step in flight, in sync mode the last step is what's shown
+        Vector3 position_previous;
+        Quaternion rotation_previous;
+        Entity* entity   = static_cast<Entity*>(actor->userData);
+        Physics* physics = entity ? entity->GetComponent<Physics>() : nullptr;
+        if (!cvar_physics_async.GetValueAs<bool>() || !physics || !physics->GetPosePrevious(actor, stepping::step_index, position_previous, rotation_previous))
+        {
+            position = position_current;
+            rotation = rotation_current;
+            return;
+        }
+
+        const float alpha = min(stepping::alpha, 1.0f);
+        position = Vector3::Lerp(position_previous, position_current, alpha);
+        rotation = Quaternion::Lerp(rotation_previous, rotation_current, alpha);
+    }
+
     void PhysicsWorld::AddActor(PxRigidActor* actor)
     {
         if (actor && scene && !actor->getScene())
         {
             lock_guard<mutex> lock(scene_mutex);
+            stepping::fetch();
             scene->addActor(*actor);
         }
     }
@@ -330,10 +481,22 @@ namespace spartan
         if (actor && scene && actor->getScene() == scene)
         {
             lock_guard<mutex> lock(scene_mutex);
+            stepping::fetch();
             scene->removeActor(*actor);
         }
     }
 
+    void PhysicsWorld::ReleaseController(PxController* controller)
+    {
+        if (!controller)
+            return;
+
+        // the controller's actor lives in the scene
+        lock_guard<mutex> lock(scene_mutex);
+        stepping::fetch();
+        controller->release();
+    }
+
     Vector3 PhysicsWorld::GetGravity()
     {
         PxVec3 g = scene->getGravity();
@@ -21,14 +21,16 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ===============
+//= INCLUDES ===================
 #include <vector>
 #include "../Math/Vector3.h"
-//==========================
+#include "../Math/Quaternion.h"
+//==============================
 
 namespace physx
 {
     class PxRigidActor;
+    class PxController;
 }
 
 namespace spartan
@@ -40,8 +42,17 @@ namespace spartan
         static void Shutdown();
         static void Tick();
 
+        // with r.physics_async, the last fixed step of the frame is kicked off here, once the world has written its inputs,
+        // and runs alongside the renderer until the next Tick() fetches it
+        static void PostTick();
+
+        // with r.physics_async, simulated bodies are shown blended between the last two fixed steps, which hides the step in flight
+        // otherwise they are shown as the last step left them
+        static void GetInterpolatedPose(physx::PxRigidActor* actor, math::Vector3& position, math::Quaternion& rotation);
+
         static void AddActor(physx::PxRigidActor* actor);
         static void RemoveActor(physx::PxRigidActor* actor);
+        static void ReleaseController(physx::PxController* controller);
 
         static math::Vector3 GetGravity();
         static void* GetScene();
@@ -46,7 +46,7 @@ namespace spartan
 
     }
 
-    void RHI_AccelerationStructure::BuildTopLevel(RHI_CommandList* cmd_list, const vector<RHI_AccelerationStructureInstance>& instances)
+    void RHI_AccelerationStructure::BuildTopLevel(RHI_CommandList* cmd_list, const RHI_AccelerationStructureInstance* instances, uint32_t instance_count)
     {
 
     }
@@ -65,7 +65,7 @@ namespace spartan
         ~RHI_AccelerationStructure();
 
         void BuildBottomLevel(RHI_CommandList* cmd_list, const std::vector<RHI_AccelerationStructureGeometry>& geometries, const std::vector<uint32_t>& primitive_counts);
-        void BuildTopLevel(RHI_CommandList* cmd_list, const std::vector<RHI_AccelerationStructureInstance>& instances);
+        void BuildTopLevel(RHI_CommandList* cmd_list, const RHI_AccelerationStructureInstance* instances, uint32_t instance_count);
 
         // misc
         uint64_t GetDeviceAddress();
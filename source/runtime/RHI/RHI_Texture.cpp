@@ -553,12 +553,11 @@ namespace spartan
 
     void RHI_Texture::PrepareForGpu()
     {
-        // skip if already prepared or currently preparing
-        if (m_resource_state != ResourceState::Max)
+        // skip if already prepared or currently preparing, claimed atomically since materials sharing a texture prepare it from their own tasks
+        ResourceState expected = ResourceState::Max;
+        if (!m_resource_state.compare_exchange_strong(expected, ResourceState::PreparingForGpu))
             return;
 
-        m_resource_state = ResourceState::PreparingForGpu;
-
         // skip textures with invalid dimensions (failed to load)
         if (m_width == 0 || m_height == 0)
         {
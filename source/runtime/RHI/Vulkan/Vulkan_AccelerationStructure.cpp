@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_Device.h"
 #include "../RHI_Implementation.h"
 #include "../RHI_CommandList.h"
+#include "../../Memory/Allocator.h"
 //=======================================
 
 //= NAMESPACES =====
@@ -203,14 +204,14 @@ namespace spartan
         RHI_Device::DeletionQueueAdd(RHI_Resource_Type::Buffer, scratch_buffer);
     }
 
-    void RHI_AccelerationStructure::BuildTopLevel(RHI_CommandList* cmd_list, const vector<RHI_AccelerationStructureInstance>& instances)
+    void RHI_AccelerationStructure::BuildTopLevel(RHI_CommandList* cmd_list, const RHI_AccelerationStructureInstance* instances, uint32_t instance_count)
     {
         SP_ASSERT(m_type == RHI_AccelerationStructureType::Top);
-        SP_ASSERT(!instances.empty());
+        SP_ASSERT(instances && instance_count > 0);
     
         // define instances
-        vector<VkAccelerationStructureInstanceKHR> vk_instances(instances.size());
-        for (size_t i = 0; i < instances.size(); ++i)
+        FrameVector<VkAccelerationStructureInstanceKHR> vk_instances(instance_count, FrameStlAllocator<VkAccelerationStructureInstanceKHR>(MemoryTag::Rendering));
+        for (uint32_t i = 0; i < instance_count; ++i)
         {
             const RHI_AccelerationStructureInstance& instance = instances[i];
             auto& vk_inst                                     = vk_instances[i];
@@ -280,7 +281,7 @@ namespace spartan
     
         // determine mode
         bool do_update                      = m_rhi_resource != nullptr;
-        uint32_t primitive_count            = static_cast<uint32_t>(instances.size());
+        uint32_t primitive_count            = instance_count;
         build_info.mode                     = do_update ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
         build_info.srcAccelerationStructure = do_update ? static_cast<VkAccelerationStructureKHR>(m_rhi_resource) : VK_NULL_HANDLE;
         build_info.dstAccelerationStructure = do_update ? static_cast<VkAccelerationStructureKHR>(m_rhi_resource) : VK_NULL_HANDLE;
@@ -75,18 +75,11 @@ namespace spartan
 
         void SetMatrix(const math::Matrix& matrix)
         {
-            // pack position
-            math::Vector3 position = matrix.GetTranslation();
-            position_x             = float_to_half(position.x);
-            position_y             = float_to_half(position.y);
-            position_z             = float_to_half(position.z);
-
-            // pack normal
+            // normal, where the rotation takes the up axis
             math::Quaternion quat = matrix.GetRotation();
             math::Vector3 normal  = quat * math::Vector3::Up;
-            normal_oct            = encode_octahedral(normal);
 
-            // pack yaw
+            // yaw, what's left of the rotation once the normal is aligned
             math::Vector3 up    = math::Vector3::Up;
             float up_dot_normal = up.Dot(normal);
             math::Quaternion quat_align;
@@ -100,17 +93,35 @@ namespace spartan
                 math::Vector3 cross_prod = up.Cross(normal) / s;
                 quat_align               = math::Quaternion(cross_prod.x, cross_prod.y, cross_prod.z, s * 0.5f);
             }
-            math::Quaternion quat_yaw  = quat_align.Conjugate() * quat;
-            float half_angle           = std::atan2(-quat_yaw.y, quat_yaw.w);
-            float yaw                  = half_angle * 2.0f;
-            if (yaw < 0.0f) yaw       += math::pi_2;
-            yaw_packed                 = static_cast<uint8_t>((yaw / math::pi_2) * 255.0f);
+            math::Quaternion quat_yaw = quat_align.Conjugate() * quat;
+            float half_angle          = std::atan2(-quat_yaw.y, quat_yaw.w);
 
-            // pack scale
+            // scale
             float scale_avg = (matrix.GetScale().x + matrix.GetScale().y + matrix.GetScale().z) / 3.0f;
-            scale_avg       = std::max(0.01f, std::min(100.0f, scale_avg));
-            float t         = (std::log(scale_avg) - std::log(0.01f)) / (std::log(100.0f) - std::log(0.01f));
-            scale_packed    = static_cast<uint8_t>(t * 255.0f);
+
+            Set(matrix.GetTranslation(), normal, half_angle * 2.0f, scale_avg);
+        }
+
+        // packs without going through a matrix, the yaw is in radians and turns the way GetMatrix() applies it
+        void Set(const math::Vector3& position, const math::Vector3& normal, float yaw, const float scale)
+        {
+            // pack position
+            position_x = float_to_half(position.x);
+            position_y = float_to_half(position.y);
+            position_z = float_to_half(position.z);
+
+            // pack normal
+            normal_oct = encode_octahedral(normal);
+
+            // pack yaw
+            yaw = std::fmod(yaw, math::pi_2);
+            if (yaw < 0.0f) yaw += math::pi_2;
+            yaw_packed = static_cast<uint8_t>((yaw / math::pi_2) * 255.0f);
+
+            // pack scale
+            float scale_clamped = std::max(0.01f, std::min(100.0f, scale));
+            float t             = (std::log(scale_clamped) - std::log(0.01f)) / (std::log(100.0f) - std::log(0.01f));
+            scale_packed        = static_cast<uint8_t>(t * 255.0f);
         }
 
         static Instance GetIdentity()
@@ -558,6 +558,11 @@ namespace spartan
         }
     }
 
+    namespace
+    {
+        atomic<uint32_t> materials_with_pending_textures = 0;
+    }
+
     Material::Material() : IResource(ResourceType::Material)
     {
         m_textures.fill(nullptr);
@@ -581,6 +586,14 @@ namespace spartan
         SetResourceFilePath(file_path);
     }
 
+    Material::~Material()
+    {
+        if (!m_pending_textures.empty())
+        {
+            materials_with_pending_textures--;
+        }
+    }
+
     void Material::LoadFromFile(const string& file_path)
     {
         pugi::xml_document doc;
@@ -602,6 +615,8 @@ namespace spartan
     
         // load textures
         pugi::xml_node textures_node = node_material.child("textures");
+        vector<pair<uint32_t, RHI_Texture*>> loaded;
+        vector<PendingTexture> pending;
         for (uint32_t type = 0; type < static_cast<uint32_t>(MaterialTextureType::Max); ++type)
         {
             for (uint32_t slot = 0; slot < slots_per_texture; ++slot)
@@ -616,19 +631,39 @@ namespace spartan
                 string tex_path = node_texture.attribute("texture_path").as_string();
     
                 // if the texture is already loaded, get a reference to it
-                auto texture = ResourceCache::GetByName<RHI_Texture>(tex_name);
+                if (auto texture = ResourceCache::GetByName<RHI_Texture>(tex_name))
+                {
+                    loaded.emplace_back(index, texture.get());
+                }
+                // if the texture is not loaded yet, start loading it in the background, it's attached once it's done
+                // and the renderables using this material move it to a more urgent lane while they are visible
+                else if (!tex_path.empty())
+                {
+                    pending.push_back({ index, tex_path, TaskPriority::Low, ResourceCache::LoadAsync<RHI_Texture>(tex_path, TaskPriority::Low) });
+                }
+            }
+        }
 
-                // if the texture is not loaded yet, load it
-                if (!texture && !tex_path.empty())
+        {
+            lock_guard<mutex> lock(m_mutex_pending);
+            if (m_pending_textures.empty() != pending.empty())
+            {
+                if (pending.empty())
                 {
-                    texture = ResourceCache::Load<RHI_Texture>(tex_path);
+                    materials_with_pending_textures--;
                 }
-    
-                if (texture)
+                else
                 {
-                    SetTexture(static_cast<MaterialTextureType>(type), texture.get(), slot, false);
+                    materials_with_pending_textures++;
                 }
             }
+            m_pending_textures = move(pending);
+        }
+
+        // set after the pending list so the save on change keeps the paths of the textures which are still loading
+        for (const auto& [index, texture] : loaded)
+        {
+            SetTexture(static_cast<MaterialTextureType>(index / slots_per_texture), texture, index % slots_per_texture, false);
         }
     
         m_object_size = sizeof(*this);
@@ -647,6 +682,16 @@ namespace spartan
             material_node.append_child(attribute_name).text().set(m_properties[i]);
         }
     
+        // textures which are still loading are saved by path, so they are requested again on the next load
+        array<string, static_cast<uint32_t>(MaterialTextureType::Max) * slots_per_texture> pending_paths;
+        {
+            lock_guard<mutex> lock(m_mutex_pending);
+            for (const PendingTexture& pending : m_pending_textures)
+            {
+                pending_paths[pending.index] = pending.path;
+            }
+        }
+
         // save textures
         pugi::xml_node textures_node = material_node.append_child("textures");
         textures_node.append_attribute("count").set_value(static_cast<uint32_t>(m_textures.size()));
@@ -660,7 +705,7 @@ namespace spartan
                 texture_node.append_attribute("texture_type").set_value(type);
                 texture_node.append_attribute("texture_slot").set_value(slot);
                 texture_node.append_attribute("texture_name").set_value(m_textures[index] ? m_textures[index]->GetObjectName().c_str() : "");
-                texture_node.append_attribute("texture_path").set_value(m_textures[index] ? m_textures[index]->GetResourceFilePath().c_str() : "");
+                texture_node.append_attribute("texture_path").set_value(m_textures[index] ? m_textures[index]->GetResourceFilePath().c_str() : pending_paths[index].c_str());
             }
         }
     
@@ -775,6 +820,56 @@ namespace spartan
         return paths;
     }
 
+    bool Material::UpdatePendingTextures(const TaskPriority priority)
+    {
+        vector<PendingTexture> loaded;
+        {
+            lock_guard<mutex> lock(m_mutex_pending);
+            if (m_pending_textures.empty())
+                return false;
+
+            for (auto it = m_pending_textures.begin(); it != m_pending_textures.end();)
+            {
+                if (it->future.wait_for(chrono::seconds(0)) == future_status::ready)
+                {
+                    loaded.push_back(move(*it));
+                    it = m_pending_textures.erase(it);
+                    continue;
+                }
+
+                // only a more urgent lane queues the load again
+                if (priority < it->priority)
+                {
+                    it->priority = priority;
+                    ResourceCache::LoadAsync<RHI_Texture>(it->path, priority);
+                }
+
+                ++it;
+            }
+
+            if (m_pending_textures.empty())
+            {
+                materials_with_pending_textures--;
+            }
+        }
+
+        // attached outside of the lock since setting a texture saves the material
+        for (PendingTexture& pending : loaded)
+        {
+            if (shared_ptr<RHI_Texture> texture = pending.future.get())
+            {
+                SetTexture(static_cast<MaterialTextureType>(pending.index / slots_per_texture), texture.get(), pending.index % slots_per_texture, false);
+            }
+        }
+
+        return true;
+    }
+
+    bool Material::AnyPendingTextures()
+    {
+        return materials_with_pending_textures.load(memory_order_relaxed) != 0;
+    }
+
     RHI_Texture* Material::GetTexture(const MaterialTextureType texture_type, const uint8_t slot)
     {
         return m_textures[(static_cast<uint32_t>(texture_type) * slots_per_texture) + slot];
@@ -861,6 +956,8 @@ namespace spartan
         if (m_properties[static_cast<uint32_t>(property_type)] == value)
             return;
 
+        const float cull_mode_previous = m_properties[static_cast<uint32_t>(MaterialProperty::CullMode)];
+
         if (property_type == MaterialProperty::ColorA)
         {
             // if an object switches from opaque to transparent or vice versa, make the world update so that the renderer
@@ -878,6 +975,12 @@ namespace spartan
 
         m_properties[static_cast<uint32_t>(property_type)] = value;
 
+        // entities using this material have to be drawn in another mode
+        if (m_properties[static_cast<uint32_t>(MaterialProperty::CullMode)] != cull_mode_previous)
+        {
+            World::MarkEntityChanged(nullptr, EntityChange::CullMode);
+        }
+
         // save on change
         SaveToFile(GetResourceFilePath());
     }
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <array>
+#include <future>
 #include "../Resource/IResource.h"
 #include "Color.h"
 //================================
@@ -31,6 +32,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace spartan
 {
     class RHI_Texture;
+    enum class TaskPriority : uint8_t;
 
     enum class MaterialTextureType
     {
@@ -115,7 +117,7 @@ namespace spartan
     {
     public:
         Material();
-        ~Material() = default;
+        ~Material();
 
         static const uint32_t slots_per_texture = 4;
 
@@ -131,6 +133,11 @@ namespace spartan
         bool HasTextureOfType(const MaterialTextureType texture_type) const;
         std::string GetTexturePathByType(const MaterialTextureType texture_type, const uint8_t slot = 0);
         std::vector<std::string> GetTexturePaths();
+
+        // textures which LoadFromFile() requested but which are still loading, attaches the ones that finished
+        // and moves the rest to the given lane, returns false once nothing is pending (main thread)
+        bool UpdatePendingTextures(const TaskPriority priority);
+        static bool AnyPendingTextures();
         RHI_Texture* GetTexture(const MaterialTextureType texture_type, const uint8_t slot = 0);
         const std::array<RHI_Texture*, static_cast<uint32_t>(MaterialTextureType::Max) * slots_per_texture>& GetTextures() const { return m_textures; }
 
@@ -155,10 +162,20 @@ namespace spartan
     private:
         bool IsPackableTextureType(MaterialTextureType type) const;
 
+        struct PendingTexture
+        {
+            uint32_t index = 0;
+            std::string path;
+            TaskPriority priority;
+            std::shared_future<std::shared_ptr<RHI_Texture>> future;
+        };
+
         std::array<RHI_Texture*, static_cast<uint32_t>(MaterialTextureType::Max) * slots_per_texture> m_textures;
         std::array<float, static_cast<uint32_t>(MaterialProperty::Max)> m_properties;
         uint32_t m_index        = 0;
         bool m_needs_repack     = true; // starts true so first PrepareForGpu() packs textures
         std::mutex m_mutex;
+        std::vector<PendingTexture> m_pending_textures;
+        std::mutex m_mutex_pending; // separate from m_mutex since packing saves the material while holding that one
     };
 }
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pch.h"
 #include "Renderer.h"
 #include "Material.h"
+#include "ShadowAtlas.h"
 #include "ThreadPool.h"
 #include "../Profiling/RenderDoc.h"
 #include "../Profiling/Profiler.h"
@@ -47,6 +48,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Resource/Import/ImageImporter.h"
 #include "../Commands/Console/ConsoleCommands.h"
 #include "../Core/Breadcrumbs.h"
+#include "../Memory/Allocator.h"
 //===========================================
 
 //= NAMESPACES ===============
@@ -72,7 +74,6 @@ namespace spartan
     bool Renderer::m_transparents_present          = false;
     bool Renderer::m_bindless_samplers_dirty       = true;
     RHI_CommandList* Renderer::m_cmd_list_present  = nullptr;
-    vector<ShadowSlice> Renderer::m_shadow_slices;
     array<RHI_Texture*, rhi_max_array_size> Renderer::m_bindless_textures;
     array<Sb_Light, rhi_max_array_size> Renderer::m_bindless_lights;
     array<Sb_Aabb, rhi_max_array_size> Renderer::m_bindless_aabbs;
@@ -178,6 +179,8 @@ namespace spartan
     TConsoleVar<float> cvar_audio_sources                  ("r.audio_sources",                  1.0f,  "draw audio source icons");
     TConsoleVar<float> cvar_performance_metrics            ("r.performance_metrics",            1.0f,  "show performance metrics", on_performance_metrics_change);
     TConsoleVar<float> cvar_physics                        ("r.physics",                        0.0f,  "draw physics debug");
+    TConsoleVar<float> cvar_physics_threads                ("r.physics_threads",                0.0f,  "physx worker threads, 0 for one per thread pool worker");
+    TConsoleVar<float> cvar_physics_async                  ("r.physics_async",                  0.0f,  "run the last physics step of the frame alongside the renderer");
     TConsoleVar<float> cvar_wireframe                      ("r.wireframe",                      0.0f,  "render in wireframe mode");
     // post-processing                                     
     TConsoleVar<float> cvar_bloom                          ("r.bloom",                          1.0f,  "bloom intensity, 0 to disable");
@@ -253,6 +256,137 @@ namespace spartan
                 ConsoleRegistry::Get().SetValueFromString("r.resolution_scale", to_string(screen_percentage));
             }
         }
+
+        // camera culling, world aabbs are kept as structure of arrays so the frustum test can run on several boxes at once
+        // the renderable list is snapshotted with the lanes, so everything indexed by them this frame (draw calls, shadow casters)
+        // sees the same list, even if the world's list is rebuilt or appended to in between
+        struct culling_lanes
+        {
+            vector<Renderable*> renderables;
+            vector<float> center_x;
+            vector<float> center_y;
+            vector<float> center_z;
+            vector<float> extent_x;
+            vector<float> extent_y;
+            vector<float> extent_z;
+            vector<float> max_distance_squared;
+            vector<float> distance_squared;
+            vector<uint8_t> visible;
+            vector<uint32_t> draw_call_index; // position in m_draw_calls this frame, max if it isn't drawn
+
+            void Resize(const uint32_t count)
+            {
+                center_x.resize(count);
+                center_y.resize(count);
+                center_z.resize(count);
+                extent_x.resize(count);
+                extent_y.resize(count);
+                extent_z.resize(count);
+                max_distance_squared.resize(count);
+                distance_squared.resize(count);
+                visible.resize(count);
+                draw_call_index.resize(count);
+            }
+        };
+        culling_lanes culling;
+
+        // shadow casters, cached per light slice so the shadow pass doesn't frustum test every renderable against every slice each frame
+        // a light's lists are rebuilt when the light changes, all lists are rebuilt when the entity set or the set of moving casters changes
+        // moving casters are kept out of the cached lists and tested every frame, so a single moving object doesn't invalidate every light
+        // a caster counts as moving while its transform changed recently, or on any frame its bounding box or instance count changed
+        constexpr float shadow_caster_moving_time     = 0.1f;  // seconds since the last transform change, same window lights use for themselves
+        constexpr float shadow_caster_cascade_padding = 0.1f;  // directional cascades are culled this much larger (fraction of their extent)
+                                                               // and rebuilt once the camera has moved half of that, instead of on every camera move
+
+        struct shadow_caster_cache
+        {
+            array<vector<uint32_t>, 6> casters_static; // renderable indices, cached, excludes moving casters
+            array<vector<uint32_t>, 6> casters;        // m_draw_calls indices of the cached plus the visible moving casters, in draw order
+            array<Vector3, 6> origins;                 // camera position the directional cascades were culled around
+            Vector3 direction = Vector3::Zero;         // light direction the directional cascades were culled for
+            bool dirty        = true;
+        };
+        unordered_map<const Light*, shadow_caster_cache> shadow_casters;
+        vector<uint8_t> shadow_caster_moving;            // per renderable, 1 if it moved recently
+        vector<float> shadow_caster_bounds;              // per renderable, last frame's box as center and extent
+        vector<uint32_t> shadow_caster_instances;        // per renderable, last frame's instance count
+        vector<uint32_t> shadow_casters_moving;          // renderable indices of the moving casters
+        vector<uint32_t> shadow_casters_moving_previous;
+        uint64_t shadow_casters_entities_version = numeric_limits<uint64_t>::max();
+        const vector<uint32_t> shadow_casters_empty;
+
+        // shadow atlas, persists across frames so slices keep their cells
+        ShadowAtlas shadow_atlas;
+
+        // draw call sort keys
+        // g-buffer: [63] transparent | [62:32] material | [31:0] depth, front-to-back for opaque and back-to-front for transparent
+        // prepass:  [32] alpha tested | [31:0] depth, front-to-back
+        // non-negative floats order like their bit patterns, so the depth is quantized to its 32 bits as is
+        constexpr uint64_t draw_call_key_transparent   = uint64_t(1) << 63;
+        constexpr uint64_t draw_call_key_alpha_tested  = uint64_t(1) << 32;
+        constexpr uint32_t draw_call_key_material_mask = 0x3FFFFFFF;                     // bit 62 stays clear, so a valid key never equals the invalid one
+        constexpr uint64_t draw_call_key_invalid       = numeric_limits<uint64_t>::max(); // sorts after every valid key
+
+        uint32_t draw_call_key_depth(const float distance_squared)
+        {
+            return bit_cast<uint32_t>(max(distance_squared, 0.0f));
+        }
+
+        // lsd radix sort of key/index pairs, 8 bits per pass, passes where all keys share the same digit are skipped
+        void radix_sort(uint64_t* keys, uint32_t* indices, uint64_t* keys_scratch, uint32_t* indices_scratch, const uint32_t count)
+        {
+            if (count < 2)
+                return;
+
+            uint32_t histograms[8][256] = {};
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const uint64_t key = keys[i];
+                for (uint32_t pass = 0; pass < 8; pass++)
+                {
+                    histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+                }
+            }
+
+            uint64_t* keys_source      = keys;
+            uint32_t* indices_source   = indices;
+            uint64_t* keys_target      = keys_scratch;
+            uint32_t* indices_target   = indices_scratch;
+            for (uint32_t pass = 0; pass < 8; pass++)
+            {
+                const uint32_t shift = pass * 8;
+                uint32_t* histogram  = histograms[pass];
+                if (histogram[(keys_source[0] >> shift) & 0xFF] == count)
+                    continue;
+
+                // histogram to offsets
+                uint32_t offset = 0;
+                for (uint32_t digit = 0; digit < 256; digit++)
+                {
+                    const uint32_t digit_count = histogram[digit];
+                    histogram[digit]           = offset;
+                    offset                    += digit_count;
+                }
+
+                // scatter
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    const uint32_t target  = histogram[(keys_source[i] >> shift) & 0xFF]++;
+                    keys_target[target]    = keys_source[i];
+                    indices_target[target] = indices_source[i];
+                }
+
+                swap(keys_source, keys_target);
+                swap(indices_source, indices_target);
+            }
+
+            // an odd number of passes leaves the result in the scratch buffers
+            if (keys_source != keys)
+            {
+                memcpy(keys, keys_source, count * sizeof(uint64_t));
+                memcpy(indices, indices_source, count * sizeof(uint32_t));
+            }
+        }
     }
 
     void Renderer::Initialize()
@@ -432,6 +566,9 @@ namespace spartan
             // fill draw call list and determine ideal occluders
             UpdateDrawCalls(m_cmd_list_present);
 
+            // refresh the cached shadow caster lists, relies on the culling data from the draw calls
+            UpdateShadowCasters();
+
             // update tlas
             UpdateAccelerationStructures(m_cmd_list_present);
     
@@ -931,19 +1068,13 @@ namespace spartan
     
         auto update_entities = [update_material]()
         {
-            for (Entity* entity : World::GetEntities())
+            World::ForEach<Renderable>([&update_material](Entity*, Renderable* renderable)
             {
-                if (entity->GetActive())
+                if (Material* material = renderable->GetMaterial())
                 {
-                    if (Renderable* renderable = entity->GetComponent<Renderable>())
-                    {
-                        if (Material* material = renderable->GetMaterial())
-                        {
-                            update_material(material);
-                        }
-                    }
+                    update_material(material);
                 }
-            }
+            });
         };
     
         // cpu
@@ -1120,6 +1251,96 @@ namespace spartan
         buffer->Update(cmd_list, &m_bindless_aabbs[0], buffer->GetStride() * count);
     }
 
+    void Renderer::UpdateCulling()
+    {
+        const vector<Component*>& components = World::GetComponents<Renderable>();
+        const uint32_t renderable_count      = static_cast<uint32_t>(components.size());
+        culling.renderables.resize(renderable_count);
+        for (uint32_t i = 0; i < renderable_count; i++)
+        {
+            culling.renderables[i] = static_cast<Renderable*>(components[i]);
+        }
+        culling.Resize(renderable_count);
+        if (renderable_count == 0)
+            return;
+
+        const vector<Renderable*>& renderables = culling.renderables;
+
+        Camera* camera                = World::GetCamera();
+        const Vector3 camera_position = camera ? camera->GetEntity()->GetPosition() : Vector3::Zero;
+
+        ThreadPool::ParallelLoop([&](uint32_t work_index_start, uint32_t work_index_end)
+        {
+            // gather
+            for (uint32_t i = work_index_start; i < work_index_end; i++)
+            {
+                Renderable* renderable = renderables[i];
+                if (!renderable->GetEntity()->GetActive())
+                {
+                    // never drawn, zero size keeps the lanes well defined
+                    culling.center_x[i]             = culling.center_y[i] = culling.center_z[i] = 0.0f;
+                    culling.extent_x[i]             = culling.extent_y[i] = culling.extent_z[i] = 0.0f;
+                    culling.max_distance_squared[i] = 0.0f;
+                    continue;
+                }
+
+                const BoundingBox& box          = renderable->GetBoundingBox();
+                const Vector3 center            = box.GetCenter();
+                const Vector3 extent            = box.GetExtents();
+                const float max_distance        = renderable->GetMaxRenderDistance();
+                culling.center_x[i]             = center.x;
+                culling.center_y[i]             = center.y;
+                culling.center_z[i]             = center.z;
+                culling.extent_x[i]             = extent.x;
+                culling.extent_y[i]             = extent.y;
+                culling.extent_z[i]             = extent.z;
+                culling.max_distance_squared[i] = max_distance * max_distance;
+            }
+
+            // frustum
+            const uint32_t count = work_index_end - work_index_start;
+            if (camera)
+            {
+                camera->GetFrustum().AreVisible(
+                    &culling.center_x[work_index_start], &culling.center_y[work_index_start], &culling.center_z[work_index_start],
+                    &culling.extent_x[work_index_start], &culling.extent_y[work_index_start], &culling.extent_z[work_index_start],
+                    count, &culling.visible[work_index_start]
+                );
+            }
+            else
+            {
+                memset(&culling.visible[work_index_start], 1, count);
+            }
+
+            // distance to the closest point of each box, and render distance
+            for (uint32_t i = work_index_start; i < work_index_end; i++)
+            {
+                float distance_squared = 0.0f;
+                if (camera)
+                {
+                    const float dx   = max(fabs(culling.center_x[i] - camera_position.x) - culling.extent_x[i], 0.0f);
+                    const float dy   = max(fabs(culling.center_y[i] - camera_position.y) - culling.extent_y[i], 0.0f);
+                    const float dz   = max(fabs(culling.center_z[i] - camera_position.z) - culling.extent_z[i], 0.0f);
+                    distance_squared = dx * dx + dy * dy + dz * dz;
+                }
+
+                culling.distance_squared[i] = distance_squared;
+                culling.visible[i]         &= distance_squared <= culling.max_distance_squared[i] ? 1 : 0;
+            }
+
+            // keep the renderables in sync for consumers outside of the draw call lists (shadows, editor, debug drawing)
+            for (uint32_t i = work_index_start; i < work_index_end; i++)
+            {
+                Renderable* renderable = renderables[i];
+                if (renderable->GetEntity()->GetActive())
+                {
+                    renderable->SetDistanceSquared(culling.distance_squared[i]);
+                    renderable->SetVisible(culling.visible[i] != 0);
+                }
+            }
+        }, renderable_count);
+    }
+
     void Renderer::UpdateDrawCalls(RHI_CommandList* cmd_list)
     {
         m_draw_call_count          = 0;
@@ -1128,88 +1349,108 @@ namespace spartan
         if (ProgressTracker::IsLoading())
             return;
 
+        UpdateCulling();
+
         // build draw calls and sort them for g-buffer (transparency -> material -> depth)
+        const vector<Renderable*>& renderables = culling.renderables;
+        const uint32_t renderable_count        = static_cast<uint32_t>(renderables.size());
+        if (renderable_count == 0)
+            return;
+
+        // one slot per renderable, the second half of the key/index buffers is radix sort scratch
+        FrameVector<Renderer_DrawCall> draw_calls(renderable_count, FrameStlAllocator<Renderer_DrawCall>(MemoryTag::Rendering));
+        FrameVector<uint64_t> keys(renderable_count * 2, FrameStlAllocator<uint64_t>(MemoryTag::Rendering));
+        FrameVector<uint32_t> indices(renderable_count * 2, FrameStlAllocator<uint32_t>(MemoryTag::Rendering));
+        FrameVector<uint8_t> alpha_tested(renderable_count, FrameStlAllocator<uint8_t>(MemoryTag::Rendering));
         {
-            for (Entity* entity : World::GetEntities())
+            // material state is read once per draw call here, instead of once per comparison while sorting
+            atomic<uint32_t> valid_count = 0;
+            ThreadPool::ParallelLoop([&](uint32_t work_index_start, uint32_t work_index_end)
             {
-                if (!entity->GetActive())
-                    continue;
-
-                if (Renderable* renderable = entity->GetComponent<Renderable>())
+                uint32_t count = 0;
+                for (uint32_t i = work_index_start; i < work_index_end; i++)
                 {
-                    // skip renderables with no material, can happen when loading a world and the material is not yet loaded
-                    if (!renderable->GetMaterial())
+                    keys[i]                    = draw_call_key_invalid;
+                    indices[i]                 = i;
+                    culling.draw_call_index[i] = numeric_limits<uint32_t>::max();
+
+                    Renderable* renderable = renderables[i];
+                    if (!renderable->GetEntity()->GetActive())
                         continue;
 
-                    if (renderable->GetMaterial()->IsTransparent())
-                    {
-                        m_transparents_present = true;
-                    }
+                    // skip renderables with no material, can happen when loading a world and the material is not yet loaded
+                    Material* material = renderable->GetMaterial();
+                    if (!material)
+                        continue;
 
-                    Renderer_DrawCall& draw_call = m_draw_calls[m_draw_call_count++];
+                    Renderer_DrawCall& draw_call = draw_calls[i];
                     draw_call.renderable         = renderable;
-                    draw_call.distance_squared   = renderable->GetDistanceSquared();
+                    draw_call.distance_squared   = culling.distance_squared[i];
                     draw_call.lod_index          = renderable->GetLodIndex();
                     draw_call.is_occluder        = false;
-                    draw_call.camera_visible     = renderable->IsVisible();
+                    draw_call.camera_visible     = culling.visible[i] != 0;
                     draw_call.instance_index     = 0;
                     draw_call.instance_count     = renderable->GetInstanceCount();
+
+                    // the material index is its bindless base, divide out the texture slots for a dense id
+                    const bool is_transparent  = material->IsTransparent();
+                    const uint32_t material_id = (material->GetIndex() / (static_cast<uint32_t>(MaterialTextureType::Max) * Material::slots_per_texture)) & draw_call_key_material_mask;
+                    const uint32_t depth       = draw_call_key_depth(draw_call.distance_squared);
+                    keys[i]                    = (is_transparent ? draw_call_key_transparent : 0) | (static_cast<uint64_t>(material_id) << 32) | (is_transparent ? ~depth : depth);
+                    alpha_tested[i]            = material->IsAlphaTested() ? 1 : 0;
+                    count++;
                 }
-            }
 
-            // sort by transparency, material id, and distance (front-to-back for opaque, back-to-front for transparent)
-            sort(m_draw_calls.begin(), m_draw_calls.begin() + m_draw_call_count, [](const Renderer_DrawCall& a, const Renderer_DrawCall& b)
+                valid_count.fetch_add(count, memory_order_relaxed);
+            }, renderable_count);
+
+            radix_sort(keys.data(), indices.data(), keys.data() + renderable_count, indices.data() + renderable_count, renderable_count);
+
+            uint32_t count = valid_count.load(memory_order_relaxed);
+            // the excess is not carried over, whatever sorts past the limit (transparents first) is not drawn this frame
+            if (count > renderer_max_draw_calls)
             {
-                // step 1: sort by transparency (opaque before transparent)
-                bool a_transparent = a.renderable->GetMaterial()->IsTransparent();
-                bool b_transparent = b.renderable->GetMaterial()->IsTransparent();
-                if (a_transparent != b_transparent)
+                static bool warned = false;
+                if (!warned)
                 {
-                    return !a_transparent; // false (opaque) before true (transparent)
+                    SP_LOG_WARNING("Draw call limit of %u reached, %u draw calls were dropped this frame (transparent ones first)", renderer_max_draw_calls, count - renderer_max_draw_calls);
+                    warned = true;
                 }
+                count = renderer_max_draw_calls;
+            }
 
-                // step 2: sort by material id within each transparency group
-                uint64_t a_material_id = a.renderable->GetMaterial()->GetObjectId();
-                uint64_t b_material_id = b.renderable->GetMaterial()->GetObjectId();
-                if (a_material_id != b_material_id)
-                {
-                    return a_material_id < b_material_id; // lower material ids first
-                }
+            // transparents sort last, so checking the last key is enough
+            m_transparents_present = count > 0 && (keys[count - 1] & draw_call_key_transparent) != 0;
 
-                // step 3: sort by distance within each material group
-                if (!a_transparent) // both are opaque
-                {
-                    return a.distance_squared < b.distance_squared; // front-to-back
-                }
-                else // both are transparent
+            // gather, and key the prepass calls into the scratch half: opaques only, sorted by alpha test (non-alpha first), then depth front-to-back
+            uint64_t* prepass_keys    = keys.data() + renderable_count;
+            uint32_t* prepass_indices = indices.data() + renderable_count;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t renderable_index = indices[i];
+                const Renderer_DrawCall& dc = draw_calls[renderable_index];
+                m_draw_calls[i]             = dc;
+                culling.draw_call_index[renderable_index] = i;
+
+                if ((keys[i] & draw_call_key_transparent) == 0 && dc.camera_visible)
                 {
-                    return a.distance_squared > b.distance_squared; // back-to-front
+                    prepass_keys[m_draw_calls_prepass_count]    = (alpha_tested[renderable_index] ? draw_call_key_alpha_tested : 0) | draw_call_key_depth(dc.distance_squared);
+                    prepass_indices[m_draw_calls_prepass_count] = i;
+                    m_draw_calls_prepass_count++;
                 }
-            });
+            }
+            m_draw_call_count = count;
         }
 
-        // build prepass calls: opaques only, sorted by alpha test (non-alpha first), then depth front-to-back
+        // sort the prepass, the g-buffer half of the buffers is free to act as scratch
         {
-            for (uint32_t i = 0; i < m_draw_call_count; ++i)
-            {
-                const Renderer_DrawCall& dc = m_draw_calls[i];
-                if (!dc.renderable->GetMaterial()->IsTransparent() && dc.camera_visible)
-                {
-                    m_draw_calls_prepass[m_draw_calls_prepass_count++] = dc;
-                }
-            }
+            radix_sort(keys.data() + renderable_count, indices.data() + renderable_count, keys.data(), indices.data(), m_draw_calls_prepass_count);
 
-            // sort prepass by alpha test flag, then distance_squared (front-to-back)
-            sort(m_draw_calls_prepass.begin(), m_draw_calls_prepass.begin() + m_draw_calls_prepass_count, [](const Renderer_DrawCall& a, const Renderer_DrawCall& b)
+            const uint32_t* prepass_indices = indices.data() + renderable_count;
+            for (uint32_t i = 0; i < m_draw_calls_prepass_count; i++)
             {
-                bool a_alpha = a.renderable->GetMaterial()->IsAlphaTested();
-                bool b_alpha = b.renderable->GetMaterial()->IsAlphaTested();
-                if (a_alpha != b_alpha)
-                {
-                    return !a_alpha; // non-alpha before alpha-tested
-                }
-                return a.distance_squared < b.distance_squared;
-            });
+                m_draw_calls_prepass[i] = m_draw_calls[prepass_indices[i]];
+            }
         }
 
         // select occluders by finding the top n largest screen-space bounding boxes
@@ -1275,6 +1516,201 @@ namespace spartan
         }
     }
 
+    void Renderer::UpdateShadowCasters()
+    {
+        // the cached lists index renderables, so drop them whenever the entities can't be trusted
+        if (ProgressTracker::IsLoading() || World::GetEntitiesVersion() != shadow_casters_entities_version)
+        {
+            shadow_casters.clear();
+            shadow_casters_moving_previous.clear();
+            shadow_caster_bounds.clear();
+            shadow_casters_entities_version = ProgressTracker::IsLoading() ? numeric_limits<uint64_t>::max() : World::GetEntitiesVersion();
+        }
+
+        // the culling snapshot, so the indices match the culling lanes and this frame's draw calls
+        const vector<Renderable*>& renderables = culling.renderables;
+        const uint32_t renderable_count        = static_cast<uint32_t>(renderables.size());
+        if (ProgressTracker::IsLoading() || renderable_count == 0)
+            return;
+
+        // nothing to compare against after a reset, every list is rebuilt anyway
+        const bool bounds_known = shadow_caster_bounds.size() == static_cast<size_t>(renderable_count) * 6;
+        shadow_caster_bounds.resize(static_cast<size_t>(renderable_count) * 6);
+        shadow_caster_instances.resize(renderable_count);
+
+        // find the moving casters
+        shadow_caster_moving.resize(renderable_count);
+        ThreadPool::ParallelLoop([&](uint32_t work_index_start, uint32_t work_index_end)
+        {
+            for (uint32_t i = work_index_start; i < work_index_end; i++)
+            {
+                const float bounds[6] =
+                {
+                    culling.center_x[i], culling.center_y[i], culling.center_z[i],
+                    culling.extent_x[i], culling.extent_y[i], culling.extent_z[i]
+                };
+                Renderable* renderable        = renderables[i];
+                const uint32_t instance_count = renderable->GetInstanceCount();
+                float* bounds_previous        = &shadow_caster_bounds[static_cast<size_t>(i) * 6];
+                const bool changed            = bounds_known && (memcmp(bounds_previous, bounds, sizeof(bounds)) != 0 || shadow_caster_instances[i] != instance_count);
+                memcpy(bounds_previous, bounds, sizeof(bounds));
+                shadow_caster_instances[i] = instance_count;
+
+                Entity* entity          = renderable->GetEntity();
+                shadow_caster_moving[i] = entity->GetActive() && (changed || entity->GetTimeSinceLastTransform() <= shadow_caster_moving_time) ? 1 : 0;
+            }
+        }, renderable_count);
+
+        shadow_casters_moving.clear();
+        for (uint32_t i = 0; i < renderable_count; i++)
+        {
+            if (shadow_caster_moving[i])
+            {
+                shadow_casters_moving.push_back(i);
+            }
+        }
+
+        // a caster that started or stopped moving is missing from or stale in every cached list
+        bool rebuild_all = shadow_casters_moving != shadow_casters_moving_previous;
+        swap(shadow_casters_moving, shadow_casters_moving_previous);
+        const vector<uint32_t>& moving = shadow_casters_moving_previous;
+
+        // collect the slices of the lights that cast shadows
+        struct slice_work
+        {
+            const Light* light;
+            shadow_caster_cache* cache;
+            uint32_t slice_index;
+            Frustum frustum; // what a dirty slice is culled against
+        };
+        FrameVector<slice_work> slices(FrameStlAllocator<slice_work>(MemoryTag::Rendering));
+        FrameVector<slice_work> slices_dirty(FrameStlAllocator<slice_work>(MemoryTag::Rendering));
+        Camera* camera                = World::GetCamera();
+        const Vector3 camera_position = camera ? camera->GetEntity()->GetPosition() : Vector3::Zero;
+        for (Entity* entity_light : World::GetEntitiesLights())
+        {
+            Light* light = entity_light->GetComponent<Light>();
+            if (!light->GetFlag(LightFlags::Shadows))
+                continue;
+
+            shadow_caster_cache& cache = shadow_casters[light];
+            const bool directional     = light->GetLightType() == LightType::Directional;
+            bool dirty                 = cache.dirty || rebuild_all;
+            if (directional)
+            {
+                // the cascades follow the camera so the light changes whenever it moves, only the direction invalidates all of them
+                const Vector3 direction = entity_light->GetForward();
+                dirty                  |= direction != cache.direction;
+                cache.direction         = direction;
+            }
+            else
+            {
+                dirty          |= light->HasChangedThisFrame();
+                cache.direction = Vector3::Zero;
+            }
+            cache.dirty = false;
+
+            for (uint32_t slice_index = 0; slice_index < light->GetSliceCount(); slice_index++)
+            {
+                bool slice_dirty = dirty;
+                float padding    = 0.0f;
+                if (directional)
+                {
+                    padding      = light->GetCascadeExtent(slice_index) * shadow_caster_cascade_padding;
+                    slice_dirty |= Vector3::Distance(camera_position, cache.origins[slice_index]) > padding * 0.5f;
+                    if (slice_dirty)
+                    {
+                        cache.origins[slice_index] = camera_position;
+                    }
+                }
+
+                slices.push_back({ light, &cache, slice_index, Frustum() });
+                if (slice_dirty)
+                {
+                    slices_dirty.push_back({ light, &cache, slice_index, light->GetFrustumPadded(slice_index, padding) });
+                }
+            }
+        }
+
+        // rebuild the dirty slices, the culling lanes already hold every world aabb as structure of arrays
+        if (!slices_dirty.empty())
+        {
+            const uint32_t dirty_count = static_cast<uint32_t>(slices_dirty.size());
+            FrameVector<uint8_t> visible(static_cast<size_t>(dirty_count) * renderable_count, FrameStlAllocator<uint8_t>(MemoryTag::Rendering));
+
+            ThreadPool::ParallelLoop([&](uint32_t work_index_start, uint32_t work_index_end)
+            {
+                const uint32_t count = work_index_end - work_index_start;
+                for (uint32_t s = 0; s < dirty_count; s++)
+                {
+                    const slice_work& work  = slices_dirty[s];
+                    const bool ignore_depth = work.light->GetLightType() == LightType::Directional; // orthographic
+                    work.frustum.AreVisible(
+                        &culling.center_x[work_index_start], &culling.center_y[work_index_start], &culling.center_z[work_index_start],
+                        &culling.extent_x[work_index_start], &culling.extent_y[work_index_start], &culling.extent_z[work_index_start],
+                        count, &visible[static_cast<size_t>(s) * renderable_count + work_index_start], ignore_depth
+                    );
+                }
+            }, renderable_count);
+
+            ThreadPool::ParallelLoop([&](uint32_t work_index_start, uint32_t work_index_end)
+            {
+                for (uint32_t s = work_index_start; s < work_index_end; s++)
+                {
+                    const slice_work& work          = slices_dirty[s];
+                    const uint8_t* slice_visible    = &visible[static_cast<size_t>(s) * renderable_count];
+                    vector<uint32_t>& casters       = work.cache->casters_static[work.slice_index];
+                    casters.clear();
+                    for (uint32_t i = 0; i < renderable_count; i++)
+                    {
+                        if (!slice_visible[i] || shadow_caster_moving[i] || !renderables[i]->GetEntity()->GetActive())
+                            continue;
+
+                        casters.push_back(i);
+                    }
+                }
+            }, dirty_count);
+        }
+
+        // final lists, the cached casters plus the moving casters that are visible this frame, mapped to this frame's draw calls
+        // so the shadow pass gets their lod and instance range, and sorted so it draws them in the same order as the g-buffer
+        if (!slices.empty())
+        {
+            ThreadPool::ParallelLoop([&](uint32_t work_index_start, uint32_t work_index_end)
+            {
+                for (uint32_t s = work_index_start; s < work_index_end; s++)
+                {
+                    const slice_work& work    = slices[s];
+                    vector<uint32_t>& casters = work.cache->casters[work.slice_index];
+                    casters.clear();
+                    for (uint32_t i : work.cache->casters_static[work.slice_index])
+                    {
+                        if (culling.draw_call_index[i] != numeric_limits<uint32_t>::max())
+                        {
+                            casters.push_back(culling.draw_call_index[i]);
+                        }
+                    }
+
+                    for (uint32_t i : moving)
+                    {
+                        if (culling.draw_call_index[i] != numeric_limits<uint32_t>::max() && work.light->IsInViewFrustum(renderables[i], work.slice_index))
+                        {
+                            casters.push_back(culling.draw_call_index[i]);
+                        }
+                    }
+
+                    sort(casters.begin(), casters.end());
+                }
+            }, static_cast<uint32_t>(slices.size()));
+        }
+    }
+
+    const vector<uint32_t>& Renderer::GetShadowCasters(const Light* light, const uint32_t slice_index)
+    {
+        auto it = shadow_casters.find(light);
+        return it != shadow_casters.end() ? it->second.casters[slice_index] : shadow_casters_empty;
+    }
+
     void Renderer::UpdateAccelerationStructures(RHI_CommandList* cmd_list)
     {
         // check if any ray tracing feature is enabled
@@ -1293,27 +1729,21 @@ namespace spartan
         {
             uint32_t blas_built   = 0;
             uint32_t blas_skipped = 0;
-            for (Entity* entity : World::GetEntities())
+            World::ForEach<Renderable>([&](Entity*, Renderable* renderable)
             {
-                if (!entity->GetActive())
-                    continue;
-
-                if (Renderable* renderable = entity->GetComponent<Renderable>())
+                if (!renderable->HasAccelerationStructure())
                 {
-                    if (!renderable->HasAccelerationStructure())
+                    renderable->BuildAccelerationStructure(cmd_list);
+                    if (renderable->HasAccelerationStructure())
                     {
-                        renderable->BuildAccelerationStructure(cmd_list);
-                        if (renderable->HasAccelerationStructure())
-                        {
-                            blas_built++;
-                        }
-                        else
-                        { 
-                            blas_skipped++;
-                        }
+                        blas_built++;
+                    }
+                    else
+                    { 
+                        blas_skipped++;
                     }
                 }
-            }
+            });
             
             if (blas_built > 0 || blas_skipped > 0)
             {
@@ -1332,61 +1762,60 @@ namespace spartan
             // temp till we make rhi enum
             constexpr uint32_t RHI_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT = 0x00000002; // matches VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR
 
-            vector<RHI_AccelerationStructureInstance> instances;
-            vector<Sb_GeometryInfo> geometry_infos;
-            for (Entity* entity : World::GetEntities())
+            // rebuilt every frame, so both live in the frame allocator
+            const vector<Component*>& renderables = World::GetComponents<Renderable>();
+            FrameVector<RHI_AccelerationStructureInstance> instances(FrameStlAllocator<RHI_AccelerationStructureInstance>(MemoryTag::Rendering));
+            FrameVector<Sb_GeometryInfo> geometry_infos(FrameStlAllocator<Sb_GeometryInfo>(MemoryTag::Rendering));
+            instances.reserve(renderables.size());
+            geometry_infos.reserve(renderables.size());
+            World::ForEach<Renderable>([&](Entity*, Renderable* renderable)
             {
-                if (!entity->GetActive())
-                    continue;
-    
-               if (Renderable* renderable = entity->GetComponent<Renderable>())
-                {
-                    if (Material* material = renderable->GetMaterial())
-                    {
-                        // skip if blas doesn't exist (mesh might not have sub_meshes yet)
-                        uint64_t device_address = renderable->GetAccelerationStructureDeviceAddress();
-                        if (device_address == 0)
-                            continue;
-
-                        // skip if buffers aren't ready
-                        RHI_Buffer* vertex_buffer = renderable->GetVertexBuffer();
-                        RHI_Buffer* index_buffer  = renderable->GetIndexBuffer();
-                        if (!vertex_buffer || !index_buffer)
-                            continue;
+                Material* material = renderable->GetMaterial();
+                if (!material)
+                    return;
+
+                // skip if blas doesn't exist (mesh might not have sub_meshes yet)
+                uint64_t device_address = renderable->GetAccelerationStructureDeviceAddress();
+                if (device_address == 0)
+                    return;
+
+                // skip if buffers aren't ready
+                RHI_Buffer* vertex_buffer = renderable->GetVertexBuffer();
+                RHI_Buffer* index_buffer  = renderable->GetIndexBuffer();
+                if (!vertex_buffer || !index_buffer)
+                    return;
+
+                RHI_CullMode cull_mode = static_cast<RHI_CullMode>(material->GetProperty(MaterialProperty::CullMode));
+
+                RHI_AccelerationStructureInstance instance           = {};
+                instance.instance_custom_index                       = material->GetIndex(); // for hit shader material lookup
+                instance.mask                                        = 0xFF;                 // visible to all rays
+                instance.instance_shader_binding_table_record_offset = 0;                    // sbt hit group offset
+                instance.flags                                       = cull_mode == RHI_CullMode::None ? RHI_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT : 0;
+                instance.device_address                              = device_address;
+
+                // build row-major 3x4 transform for vulkan
+                // engine uses row vectors (point * matrix), vulkan uses column vectors (matrix * point)
+                // so we need to transpose the 3x3 rotation part
+                // translation stays in the last column
+                const Matrix& m = renderable->GetEntity()->GetMatrix();
+                instance.transform[0]  = m.m00; instance.transform[1]  = m.m10; instance.transform[2]  = m.m20; instance.transform[3]  = m.m30;
+                instance.transform[4]  = m.m01; instance.transform[5]  = m.m11; instance.transform[6]  = m.m21; instance.transform[7]  = m.m31;
+                instance.transform[8]  = m.m02; instance.transform[9]  = m.m12; instance.transform[10] = m.m22; instance.transform[11] = m.m32;
+
+                instances.push_back(instance);
+
+                // build geometry info for vertex/index buffer access in hit shader
+                Sb_GeometryInfo geo_info       = {};
+                geo_info.vertex_buffer_address = vertex_buffer->GetDeviceAddress();
+                geo_info.index_buffer_address  = index_buffer->GetDeviceAddress();
+                geo_info.vertex_offset         = renderable->GetVertexOffset(0);
+                geo_info.index_offset          = renderable->GetIndexOffset(0);
+                geo_info.vertex_count          = renderable->GetVertexCount(0);
+                geo_info.index_count           = renderable->GetIndexCount(0);
+                geometry_infos.push_back(geo_info);
+            });
 
-                        RHI_CullMode cull_mode = static_cast<RHI_CullMode>(material->GetProperty(MaterialProperty::CullMode));
-
-                        RHI_AccelerationStructureInstance instance           = {};
-                        instance.instance_custom_index                       = material->GetIndex(); // for hit shader material lookup
-                        instance.mask                                        = 0xFF;                 // visible to all rays
-                        instance.instance_shader_binding_table_record_offset = 0;                    // sbt hit group offset
-                        instance.flags                                       = cull_mode == RHI_CullMode::None ? RHI_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT : 0;
-                        instance.device_address                              = device_address;
-
-                        // build row-major 3x4 transform for vulkan
-                        // engine uses row vectors (point * matrix), vulkan uses column vectors (matrix * point)
-                        // so we need to transpose the 3x3 rotation part
-                        // translation stays in the last column
-                        const Matrix& m = renderable->GetEntity()->GetMatrix();
-                        instance.transform[0]  = m.m00; instance.transform[1]  = m.m10; instance.transform[2]  = m.m20; instance.transform[3]  = m.m30;
-                        instance.transform[4]  = m.m01; instance.transform[5]  = m.m11; instance.transform[6]  = m.m21; instance.transform[7]  = m.m31;
-                        instance.transform[8]  = m.m02; instance.transform[9]  = m.m12; instance.transform[10] = m.m22; instance.transform[11] = m.m32;
-
-                        instances.push_back(instance);
-
-                        // build geometry info for vertex/index buffer access in hit shader
-                        Sb_GeometryInfo geo_info       = {};
-                        geo_info.vertex_buffer_address = vertex_buffer->GetDeviceAddress();
-                        geo_info.index_buffer_address  = index_buffer->GetDeviceAddress();
-                        geo_info.vertex_offset         = renderable->GetVertexOffset(0);
-                        geo_info.index_offset          = renderable->GetIndexOffset(0);
-                        geo_info.vertex_count          = renderable->GetVertexCount(0);
-                        geo_info.index_count           = renderable->GetIndexCount(0);
-                        geometry_infos.push_back(geo_info);
-                    }
-                }
-            }
-    
             static uint32_t last_instance_count = 0;
             if (!instances.empty())
             {
@@ -1395,7 +1824,7 @@ namespace spartan
                     SP_LOG_INFO("Ray tracing: building TLAS with %zu instances", instances.size());
                     last_instance_count = static_cast<uint32_t>(instances.size());
                 }
-                tlas->BuildTopLevel(cmd_list, instances);
+                tlas->BuildTopLevel(cmd_list, instances.data(), static_cast<uint32_t>(instances.size()));
 
                 // update geometry info buffer for hit shader vertex access
                 GetBuffer(Renderer_Buffer::GeometryInfo)->Update(cmd_list, geometry_infos.data(), static_cast<uint32_t>(geometry_infos.size() * sizeof(Sb_GeometryInfo)));
@@ -1413,133 +1842,40 @@ namespace spartan
 
     void Renderer::UpdateShadowAtlas()
     {
-        const uint32_t resolution_atlas = GetRenderTarget(Renderer_RenderTarget::shadow_atlas)->GetWidth();
-        const uint32_t min_slice_res    = 256;
+        const uint32_t resolution_atlas = GetRenderTarget(Renderer_RenderTarget::shadow_atlas)->GetWidth(); // assume atlas is square, width == height
+        Camera* camera                  = World::GetCamera();
+        const Vector3 camera_position   = camera ? camera->GetEntity()->GetPosition() : Vector3::Zero;
 
-        // assume atlas is square, width == height
-    
-        // collect slices
-        m_shadow_slices.clear();
+        // collect the slices that want atlas space, with the cell size they'd like
+        vector<ShadowSlice> slices;
         for (const auto& entity : World::GetEntitiesLights())
         {
-            Light* light                = entity->GetComponent<Light>();
+            Light* light = entity->GetComponent<Light>();
             light->ClearAtlasRectangles();
-            if (light->GetIndex() == numeric_limits<uint32_t>::max())
+            if (light->GetIndex() == numeric_limits<uint32_t>::max() || !light->GetFlag(LightFlags::Shadows))
                 continue;
+
+            // fraction of the light's range the camera is inside of, 1 when the camera is within range
+            const bool directional = light->GetLightType() == LightType::Directional;
+            const float distance   = Vector3::Distance(camera_position, light->GetEntity()->GetPosition());
+            const float coverage   = light->GetRange() / max(distance, 0.001f);
+
             for (uint32_t i = 0; i < light->GetSliceCount(); ++i)
             {
-                m_shadow_slices.emplace_back(light, i, 0, math::Rectangle::Zero);
+                const uint32_t cell = ShadowAtlas::GetCellSize(directional, coverage, resolution_atlas, shadow_atlas.GetCellRequested(light, i));
+                slices.push_back({ light, i, cell, math::Rectangle::Zero, cell, directional });
             }
         }
-        if (m_shadow_slices.empty())
-            return;
-    
-        // lambda to check if slices of given res can fit with borders
-        uint32_t border  = 8; // pixels between slices, none at edges
-        auto can_fit = [&](uint32_t test_res, uint32_t num_slices) -> bool
-        {
-            if (test_res > resolution_atlas)
-                return false;
-    
-            uint32_t x     = 0;
-            uint32_t y     = 0;
-            uint32_t row_h = 0;
-    
-            for (uint32_t i = 0; i < num_slices; ++i)
-            {
-                uint32_t left_pad = (x == 0) ? 0 : border;
-                uint32_t placed_x = x + left_pad;
-    
-                // wrap to next row if overflow
-                if (placed_x + test_res > resolution_atlas)
-                {
-                    y        += row_h + border;
-                    x         = 0;
-                    row_h     = 0;
-                    placed_x  = 0;
-                }
-    
-                // check if too wide after wrap
-                if (placed_x + test_res > resolution_atlas)
-                    return false;
-    
-                uint32_t placed_y       = y;
-                if (placed_y + test_res > resolution_atlas)
-                    return false;
-    
-                // simulate placement
-                x     = placed_x + test_res;
-                row_h = max(row_h, test_res);
-            }
-    
-            return true;
-        };
-    
-        // binary search for max uniform slice res
-        uint32_t max_slice_res = resolution_atlas;
-        if (m_shadow_slices.size() > 1)
-        {
-            uint32_t low  = min_slice_res;
-            uint32_t high = resolution_atlas;
-            while (low < high)
-            {
-                uint32_t mid = (low + high + 1) / 2;
-                if (can_fit(mid, static_cast<uint32_t>(m_shadow_slices.size())))
-                {
-                    low = mid;
-                }
-                else
-                {
-                    high = mid - 1;
-                }
-            }
-            max_slice_res = low;
-        }
-        max_slice_res = max(max_slice_res, min_slice_res); // clamp to min
-    
-        // assign res to all slices (uniform)
-        for (auto& slice : m_shadow_slices)
+
+        shadow_atlas.Update(resolution_atlas, move(slices));
+
+        // assign rects back to lights
+        for (const ShadowSlice& slice : shadow_atlas.GetSlices())
         {
-            slice.res = max_slice_res;
-        }
-    
-        // pack slices in scanline order
-        uint32_t x     = 0;
-        uint32_t y     = 0;
-        uint32_t row_h = 0;
-        for (auto& slice : m_shadow_slices)
-        {
-            uint32_t left_pad = (x == 0) ? 0 : border;
-            uint32_t placed_x = x + left_pad;
-    
-            // wrap to next row if needed
-            if (placed_x + slice.res > resolution_atlas)
+            if (slice.rect.IsDefined())
             {
-                y        += row_h + border;
-                x         = 0;
-                row_h     = 0;
-                placed_x  = 0;
+                slice.light->SetAtlasRectangle(slice.slice_index, slice.rect);
             }
-    
-            // no overflow checks here, as can_fit validated
-            // assert(placed_x + slice.res <= resolution_atlas && y + slice.res <= resolution_atlas);
-    
-            slice.rect = math::Rectangle(
-                static_cast<float>(placed_x),
-                static_cast<float>(y),
-                static_cast<float>(slice.res),
-                static_cast<float>(slice.res)
-            );
-    
-            // advance
-            x     = placed_x + slice.res;
-            row_h = max(row_h, slice.res);
-        }
-    
-        // assign rects back to lights
-        for (const auto& slice : m_shadow_slices)
-        {
-            slice.light->SetAtlasRectangle(slice.slice_index, slice.rect);
         }
     }
 
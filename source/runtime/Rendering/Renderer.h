@@ -58,6 +58,8 @@ namespace spartan
     extern TConsoleVar<float> cvar_audio_sources;
     extern TConsoleVar<float> cvar_performance_metrics;
     extern TConsoleVar<float> cvar_physics;
+    extern TConsoleVar<float> cvar_physics_threads;
+    extern TConsoleVar<float> cvar_physics_async;
     extern TConsoleVar<float> cvar_wireframe;
     extern TConsoleVar<float> cvar_bloom;
     extern TConsoleVar<float> cvar_fog;
@@ -94,14 +96,6 @@ namespace spartan
     extern TConsoleVar<float> cvar_cloud_darkness;
     extern TConsoleVar<float> cvar_cloud_seed;
 
-    struct ShadowSlice
-    {
-        Light* light;
-        uint32_t slice_index;
-        uint32_t res;
-        math::Rectangle rect;
-    };
-
     struct PersistentLine
     {
         math::Vector3 from;
@@ -260,7 +254,10 @@ namespace spartan
         static void SetCommonTextures(RHI_CommandList* cmd_list);
         static void DestroyResources();
         static void UpdateShadowAtlas();
+        static void UpdateCulling();
         static void UpdateDrawCalls(RHI_CommandList* cmd_list);
+        static void UpdateShadowCasters();
+        static const std::vector<uint32_t>& GetShadowCasters(const Light* light, const uint32_t slice_index);
         static void UpdateAccelerationStructures(RHI_CommandList* cmd_list);
 
         // draw calls
@@ -287,7 +284,6 @@ namespace spartan
         static std::mutex m_mutex_renderables;
         static bool m_transparents_present;
         static RHI_CommandList* m_cmd_list_present;
-        static std::vector<ShadowSlice> m_shadow_slices;
         static std::unique_ptr<RHI_Buffer> m_std_reflections; // it temporarily lives here
         static std::unique_ptr<RHI_Buffer> m_std_shadows;     // shader binding table for ray traced shadows
         static std::unique_ptr<RHI_Buffer> m_std_restir;      // shader binding table for restir path tracing
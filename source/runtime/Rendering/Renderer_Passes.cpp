@@ -322,20 +322,16 @@ namespace spartan
                     cmd_list->SetViewport(viewport);
                     cmd_list->SetScissorRectangle(rect);
 
-                    // render cached renderables
-                    for (uint32_t i = 0; i < m_draw_call_count; i++)
+                    // render the cached casters of this slice
+                    for (uint32_t draw_call_index : GetShadowCasters(light, array_index))
                     {
-                        const Renderer_DrawCall& draw_call = m_draw_calls[i];
+                        const Renderer_DrawCall& draw_call = m_draw_calls[draw_call_index];
                         Renderable* renderable             = draw_call.renderable;
                         Material* material                 = renderable->GetMaterial();
                         const float shadow_distance        = renderable->GetMaxShadowDistance();
                         if (!material || material->IsTransparent() || !renderable->HasFlag(RenderableFlags::CastsShadows) || draw_call.distance_squared > shadow_distance * shadow_distance)
                             continue;
 
-                        // todo: this needs to be recalculate only when the light or the renderable moves, not every frame
-                        if (!light->IsInViewFrustum(renderable, array_index))
-                            continue;
-
                         // pixel shader
                         {
                             bool is_first_cascade = array_index == 0 && light->GetLightType() == LightType::Directional;
@@ -367,7 +363,7 @@ namespace spartan
                             cmd_list->SetBufferIndex(renderable->GetIndexBuffer());
 
                             // compute lod index
-                            bool close_to_shadow      = renderable->GetDistanceSquared() < 100.0f * 100.0f;                                   // anything within 100 meters of the shadow caster
+                            bool close_to_shadow      = draw_call.distance_squared < 100.0f * 100.0f;                                         // anything within 100 meters of the shadow caster
                             uint32_t lod_index_bias   = light->GetLightType() == LightType::Directional ? 1 : 0;                              // bias for directional lights
                             uint32_t lod_index_shadow = clamp(renderable->GetLodIndex() + lod_index_bias, 0u, renderable->GetLodCount() - 1); // lod index biased towards lower quality lod
                             uint32_t lod_index        = close_to_shadow ? draw_call.lod_index : lod_index_shadow;                             // use normal lod if close to shadow caster, otherwise use light specific lod
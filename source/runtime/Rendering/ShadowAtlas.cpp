@@ -0,0 +1,264 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========
+#include "pch.h"
+#include "ShadowAtlas.h"
+#include <bit>
+//===================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan::math;
+//============================
+
+namespace spartan
+{
+    uint32_t ShadowAtlas::GetCellSize(const bool directional, const float coverage, const uint32_t resolution, const uint32_t cell_previous)
+    {
+        if (directional)
+            return resolution / 2;
+
+        const float target = max(static_cast<float>(resolution / 4) * clamp(coverage, 0.0f, 1.0f), static_cast<float>(cell_min));
+
+        // hysteresis, only grow past 25% over the next size up and only shrink below 75% of the current size
+        if (cell_previous != 0 && target < static_cast<float>(cell_previous) * 2.5f && target >= static_cast<float>(cell_previous) * 0.75f)
+            return cell_previous;
+
+        return max(bit_floor(static_cast<uint32_t>(target)), cell_min);
+    }
+
+    uint32_t ShadowAtlas::GetCellRequested(const Light* light, const uint32_t slice_index) const
+    {
+        auto it = find_if(m_slices.begin(), m_slices.end(), [&](const ShadowSlice& slice) { return slice.light == light && slice.slice_index == slice_index; });
+        return it != m_slices.end() ? it->res_requested : 0;
+    }
+
+    void ShadowAtlas::Update(const uint32_t resolution, vector<ShadowSlice>&& slices)
+    {
+        // a new atlas starts from scratch
+        bool repack = resolution != m_resolution;
+        if (repack)
+        {
+            m_resolution = resolution;
+            m_slices.clear();
+        }
+
+        // incremental update: slices that are gone or changed size give their space back, the rest keep their rectangles
+        if (!repack)
+        {
+            bool freed_space = false;
+            bool has_shrunk  = false;
+            for (const ShadowSlice& slice_previous : m_slices)
+            {
+                auto it = find_if(slices.begin(), slices.end(), [&](const ShadowSlice& slice) { return slice.light == slice_previous.light && slice.slice_index == slice_previous.slice_index; });
+                if (it != slices.end() && it->res_requested == slice_previous.res_requested && slice_previous.rect.IsDefined())
+                {
+                    it->res     = slice_previous.res;
+                    it->rect    = slice_previous.rect;
+                    has_shrunk |= it->res < it->res_requested;
+                }
+                else if (slice_previous.rect.IsDefined())
+                {
+                    Free({ static_cast<uint32_t>(slice_previous.rect.x), static_cast<uint32_t>(slice_previous.rect.y), slice_previous.res, slice_previous.res });
+                    freed_space = true;
+                }
+            }
+
+            // slices that were shrunk to fit get a chance to grow back once space frees up
+            repack = freed_space && has_shrunk;
+        }
+
+        // place the new slices, largest first
+        if (!repack)
+        {
+            vector<ShadowSlice*> pending;
+            for (ShadowSlice& slice : slices)
+            {
+                if (!slice.rect.IsDefined())
+                {
+                    pending.push_back(&slice);
+                }
+            }
+            sort(pending.begin(), pending.end(), [](const ShadowSlice* a, const ShadowSlice* b) { return a->res > b->res; });
+
+            for (ShadowSlice* slice : pending)
+            {
+                if (!Place(*slice))
+                {
+                    // fragmented or full, start over
+                    repack = true;
+                    break;
+                }
+            }
+        }
+
+        // full repack, halving the largest cells until everything fits
+        if (repack)
+        {
+            while (true)
+            {
+                Reset(resolution);
+                sort(slices.begin(), slices.end(), [](const ShadowSlice& a, const ShadowSlice& b) { return a.res > b.res; });
+
+                bool fits = true;
+                for (ShadowSlice& slice : slices)
+                {
+                    slice.rect = math::Rectangle::Zero;
+                    fits      &= Place(slice);
+                }
+                if (fits)
+                    break;
+
+                // find the largest cells, local lights shrink before directional cascades
+                bool shrink_directional = false;
+                uint32_t shrink_res     = 0;
+                for (const ShadowSlice& slice : slices)
+                {
+                    if (slice.res <= cell_min)
+                        continue;
+
+                    if (shrink_res == 0 || (shrink_directional && !slice.directional) || (shrink_directional == slice.directional && slice.res > shrink_res))
+                    {
+                        shrink_directional = slice.directional;
+                        shrink_res         = slice.res;
+                    }
+                }
+
+                // everything is at the minimum, the slices that didn't fit are left without a rectangle
+                if (shrink_res == 0)
+                    break;
+
+                for (ShadowSlice& slice : slices)
+                {
+                    if (slice.res == shrink_res && slice.directional == shrink_directional)
+                    {
+                        slice.res /= 2;
+                    }
+                }
+            }
+        }
+
+        m_slices   = move(slices);
+        m_repacked = repack;
+    }
+
+    void ShadowAtlas::Reset(const uint32_t size)
+    {
+        m_free.clear();
+        m_free.push_back({ 0, 0, size, size });
+    }
+
+    bool ShadowAtlas::Allocate(const uint32_t size, Cell& out)
+    {
+        // best short side fit, ties go to the smaller rectangle
+        uint32_t best_index = numeric_limits<uint32_t>::max();
+        uint32_t best_fit   = numeric_limits<uint32_t>::max();
+        uint64_t best_area  = numeric_limits<uint64_t>::max();
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_free.size()); i++)
+        {
+            const Cell& rect = m_free[i];
+            if (rect.width < size || rect.height < size)
+                continue;
+
+            const uint32_t fit  = min(rect.width - size, rect.height - size);
+            const uint64_t area = static_cast<uint64_t>(rect.width) * rect.height;
+            if (fit < best_fit || (fit == best_fit && area < best_area))
+            {
+                best_index = i;
+                best_fit   = fit;
+                best_area  = area;
+            }
+        }
+
+        if (best_index == numeric_limits<uint32_t>::max())
+            return false;
+
+        const Cell rect    = m_free[best_index];
+        m_free[best_index] = m_free.back();
+        m_free.pop_back();
+        out = { rect.x, rect.y, size, size };
+
+        const uint32_t right  = rect.width - size;
+        const uint32_t bottom = rect.height - size;
+        if (right < bottom)
+        {
+            if (right > 0)  m_free.push_back({ rect.x + size, rect.y, right, size });
+            if (bottom > 0) m_free.push_back({ rect.x, rect.y + size, rect.width, bottom });
+        }
+        else
+        {
+            if (right > 0)  m_free.push_back({ rect.x + size, rect.y, right, rect.height });
+            if (bottom > 0) m_free.push_back({ rect.x, rect.y + size, size, bottom });
+        }
+
+        return true;
+    }
+
+    void ShadowAtlas::Free(const Cell& cell)
+    {
+        m_free.push_back(cell);
+
+        // merge until no pair shares a full edge
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (uint32_t i = 0; i < m_free.size() && !merged; i++)
+            {
+                for (uint32_t j = i + 1; j < m_free.size() && !merged; j++)
+                {
+                    Cell& a       = m_free[i];
+                    const Cell& b = m_free[j];
+                    if (a.y == b.y && a.height == b.height && (a.x + a.width == b.x || b.x + b.width == a.x))
+                    {
+                        a.x      = min(a.x, b.x);
+                        a.width += b.width;
+                        merged   = true;
+                    }
+                    else if (a.x == b.x && a.width == b.width && (a.y + a.height == b.y || b.y + b.height == a.y))
+                    {
+                        a.y       = min(a.y, b.y);
+                        a.height += b.height;
+                        merged    = true;
+                    }
+
+                    if (merged)
+                    {
+                        m_free[j] = m_free.back();
+                        m_free.pop_back();
+                    }
+                }
+            }
+        }
+    }
+
+    bool ShadowAtlas::Place(ShadowSlice& slice)
+    {
+        Cell cell;
+        if (!Allocate(slice.res, cell))
+            return false;
+
+        const float size = static_cast<float>(slice.res - border);
+        slice.rect       = math::Rectangle(static_cast<float>(cell.x), static_cast<float>(cell.y), size, size);
+        return true;
+    }
+}
@@ -0,0 +1,86 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <vector>
+#include "../Math/Rectangle.h"
+//=========================
+
+namespace spartan
+{
+    class Light;
+
+    struct ShadowSlice
+    {
+        Light* light;           // together with slice_index identifies the slice, the atlas never dereferences it
+        uint32_t slice_index;
+        uint32_t res;
+        math::Rectangle rect;
+        uint32_t res_requested; // res can end up lower when the atlas is oversubscribed
+        bool directional;       // directional cascades are the last to shrink
+    };
+
+    // every slice gets a power of two cell which it renders into minus a border, so neighbouring slices don't bleed into each other when filtered
+    // directional cascades get the largest cells, local lights get cells proportional to how much of the screen they can cover
+    class ShadowAtlas
+    {
+    public:
+        static constexpr uint32_t cell_min = 256;
+        static constexpr uint32_t border   = 8;
+
+        // the cell a slice asks for, coverage is the fraction of a local light's range the camera is inside of
+        // cell_previous is what the slice asked for last time (0 if new), it keeps small coverage changes from resizing the cell
+        static uint32_t GetCellSize(bool directional, float coverage, uint32_t resolution, uint32_t cell_previous);
+
+        // what a slice asked for in the last update, 0 if it wasn't in it
+        uint32_t GetCellRequested(const Light* light, uint32_t slice_index) const;
+
+        // places the slices, those which kept their requested cell keep their rectangle, the rest are placed incrementally
+        // falls back to a full repack when placement fails or when shrunk slices can grow back, slices that don't fit even at cell_min get no rectangle
+        void Update(uint32_t resolution, std::vector<ShadowSlice>&& slices);
+
+        const std::vector<ShadowSlice>& GetSlices() const { return m_slices; }
+        bool WasRepacked() const                          { return m_repacked; }
+
+    private:
+        // guillotine allocator, a placed square splits its free rectangle in two along the shorter leftover axis
+        // freed rectangles merge back with neighbours that share a full edge, so slices can come and go without moving the others
+        struct Cell
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+            uint32_t height;
+        };
+
+        void Reset(uint32_t size);
+        bool Allocate(uint32_t size, Cell& out);
+        void Free(const Cell& cell);
+        bool Place(ShadowSlice& slice);
+
+        std::vector<Cell> m_free;
+        std::vector<ShadowSlice> m_slices;
+        uint32_t m_resolution = 0;
+        bool m_repacked       = false;
+    };
+}
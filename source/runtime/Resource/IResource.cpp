@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Rendering/Animation.h"
 #include "../Geometry/Mesh.h"
 #include "../Rendering/Material.h"
+#include "ResourceCache.h"
 //=================================
 
 //= NAMESPACES ==========
@@ -39,6 +40,22 @@ IResource::IResource(const ResourceType type)
     m_resource_type = type;
 }
 
+void IResource::SetResourceFilePath(const string& path)
+{
+    m_resource_file_path = FileSystem::GetRelativePath(path);
+    m_object_name        = FileSystem::GetFileNameWithoutExtensionFromFilePath(m_resource_file_path);
+
+    ResourceCache::Reindex(this);
+}
+
+void IResource::SetResourceName(const string& name)
+{
+    m_object_name        = name;
+    m_resource_file_path = FileSystem::GetDirectoryFromFilePath(m_resource_file_path) + name;
+
+    ResourceCache::Reindex(this);
+}
+
 template <typename T>
 ResourceType IResource::TypeToEnum() { return ResourceType::Unknown; }
 
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ========================
 #include <atomic>
+#include <limits>
 #include "../FileSystem/FileSystem.h"
 #include "../Core/SpartanObject.h"
 //===================================
@@ -57,17 +58,8 @@ namespace spartan
         IResource(ResourceType type);
         virtual ~IResource() = default;
 
-        void SetResourceFilePath(const std::string& path)
-        {
-            m_resource_file_path = FileSystem::GetRelativePath(path);
-            m_object_name        = FileSystem::GetFileNameWithoutExtensionFromFilePath(m_resource_file_path);
-        }
-
-        void SetResourceName(const std::string& name)
-        {
-            m_object_name        = name;
-            m_resource_file_path = FileSystem::GetDirectoryFromFilePath(m_resource_file_path) + name;
-        }
+        void SetResourceFilePath(const std::string& path);
+        void SetResourceName(const std::string& name);
         
         ResourceType GetResourceType()           const { return m_resource_type; }
         const char* GetResourceTypeCstr()        const { return typeid(*this).name(); }
@@ -105,6 +97,9 @@ namespace spartan
         uint32_t m_flags                            = 0;
 
     private:
+        friend class ResourceCache;
+
         std::string m_resource_file_path;
+        uint32_t m_resource_cache_slot = std::numeric_limits<uint32_t>::max(); // position in the resource cache, owned by it
     };
 }
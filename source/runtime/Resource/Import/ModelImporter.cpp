@@ -51,16 +51,47 @@ namespace spartan
 {
     struct ImportContext
     {
+        // a mesh found while walking the nodes, its geometry is built on the thread pool
+        struct MeshJob
+        {
+            const aiMesh* mesh = nullptr;
+            Entity* entity     = nullptr;
+            vector<MeshLodGeometry> lods;
+        };
+
         string file_path;
         string model_name;
         string model_directory;
         Mesh* mesh           = nullptr;
         const aiScene* scene = nullptr;
+        vector<MeshJob> mesh_jobs;
+        vector<shared_ptr<Material>> materials; // one per assimp material, shared by every mesh using it
     };
 
     namespace
     {
-        mutex mutex_import;
+        // imports overlap everywhere but in the merge, setting materials packs textures which other imports can share
+        mutex mutex_merge;
+
+        struct texture_slot
+        {
+            MaterialTextureType type;
+            aiTextureType type_assimp_pbr;
+            aiTextureType type_assimp_legacy;
+        };
+
+        // note: gltf uses aiTextureType_GLTF_METALLIC_ROUGHNESS for combined metallic-roughness texture
+        const array<texture_slot, 8> texture_slots =
+        {{
+            { MaterialTextureType::Color,     aiTextureType_BASE_COLOR,              aiTextureType_DIFFUSE           },
+            { MaterialTextureType::Roughness, aiTextureType_GLTF_METALLIC_ROUGHNESS, aiTextureType_DIFFUSE_ROUGHNESS },
+            { MaterialTextureType::Metalness, aiTextureType_GLTF_METALLIC_ROUGHNESS, aiTextureType_METALNESS         },
+            { MaterialTextureType::Normal,    aiTextureType_NORMAL_CAMERA,           aiTextureType_NORMALS           },
+            { MaterialTextureType::Occlusion, aiTextureType_AMBIENT_OCCLUSION,       aiTextureType_LIGHTMAP          },
+            { MaterialTextureType::Emission,  aiTextureType_EMISSION_COLOR,          aiTextureType_EMISSIVE          },
+            { MaterialTextureType::Height,    aiTextureType_HEIGHT,                  aiTextureType_NONE              },
+            { MaterialTextureType::AlphaMask, aiTextureType_OPACITY,                 aiTextureType_NONE              }
+        }};
 
         Matrix to_matrix(const aiMatrix4x4& transform)
         {
@@ -134,7 +165,7 @@ namespace spartan
                 if (current_step == 0)
                 {
                     ProgressTracker::GetProgress(ProgressType::ModelImporter).JobDone();
-                    ProgressTracker::GetProgress(ProgressType::ModelImporter).Start(number_of_steps, "Post-processing model...");
+                    ProgressTracker::GetProgress(ProgressType::ModelImporter).AddJobs(number_of_steps, "Post-processing model...");
                 }
                 else
                 {
@@ -182,20 +213,15 @@ namespace spartan
             return "";
         }
 
-        // load texture synchronously (original working behavior)
-        bool load_material_texture(
-            const string& model_directory,
-            shared_ptr<Material> material,
-            const aiMaterial* material_assimp,
-            const MaterialTextureType texture_type,
-            const aiTextureType texture_type_assimp_pbr,
-            const aiTextureType texture_type_assimp_legacy
-        )
+        // returns false if the material references a texture that can't be used, an empty path means there is no texture
+        bool get_texture_path(const string& model_directory, const aiMaterial* material_assimp, const texture_slot& slot, aiTextureType& type_assimp, string& resolved_path)
         {
+            resolved_path.clear();
+
             // determine texture type (prefer pbr)
-            aiTextureType type_assimp = aiTextureType_NONE;
-            type_assimp = material_assimp->GetTextureCount(texture_type_assimp_pbr) > 0 ? texture_type_assimp_pbr : type_assimp;
-            type_assimp = (type_assimp == aiTextureType_NONE) ? (material_assimp->GetTextureCount(texture_type_assimp_legacy) > 0 ? texture_type_assimp_legacy : type_assimp) : type_assimp;
+            type_assimp = aiTextureType_NONE;
+            type_assimp = material_assimp->GetTextureCount(slot.type_assimp_pbr) > 0 ? slot.type_assimp_pbr : type_assimp;
+            type_assimp = (type_assimp == aiTextureType_NONE) ? (material_assimp->GetTextureCount(slot.type_assimp_legacy) > 0 ? slot.type_assimp_legacy : type_assimp) : type_assimp;
 
             // check if the material has any textures
             if (material_assimp->GetTextureCount(type_assimp) == 0)
@@ -207,10 +233,58 @@ namespace spartan
                 return false;
 
             // resolve actual file path
-            const string resolved_path = resolve_texture_path(texture_path.data, model_directory);
-            if (!FileSystem::IsSupportedImageFile(resolved_path))
+            resolved_path = resolve_texture_path(texture_path.data, model_directory);
+            return FileSystem::IsSupportedImageFile(resolved_path);
+        }
+
+        // starts loading every texture the used materials reference, each path once, so the reads and decodes
+        // overlap with the geometry processing instead of happening one after the other while materials are built
+        void prefetch_textures(const ImportContext& ctx, const vector<bool>& material_used)
+        {
+            unordered_set<string> paths;
+            for (uint32_t i = 0; i < ctx.scene->mNumMaterials; i++)
+            {
+                if (!material_used[i])
+                    continue;
+
+                for (const texture_slot& slot : texture_slots)
+                {
+                    aiTextureType type_assimp;
+                    string resolved_path;
+                    if (!get_texture_path(ctx.model_directory, ctx.scene->mMaterials[i], slot, type_assimp, resolved_path) || resolved_path.empty())
+                        continue;
+
+                    // textures which are cached by name are picked up from the cache when the material is built
+                    if (ResourceCache::GetByName<RHI_Texture>(FileSystem::GetFileNameWithoutExtensionFromFilePath(resolved_path)))
+                        continue;
+
+                    if (paths.insert(resolved_path).second)
+                    {
+                        // same flags as Material::SetTexture(), so the load is shared with the one the material makes
+                        ResourceCache::LoadAsync<RHI_Texture>(resolved_path, TaskPriority::Normal, RHI_Texture_Srv);
+                    }
+                }
+            }
+        }
+
+        // the texture is loaded synchronously, if it was prefetched this joins or picks up that load
+        bool load_material_texture(
+            const string& model_directory,
+            shared_ptr<Material> material,
+            const aiMaterial* material_assimp,
+            const texture_slot& slot
+        )
+        {
+            const MaterialTextureType texture_type = slot.type;
+
+            aiTextureType type_assimp;
+            string resolved_path;
+            if (!get_texture_path(model_directory, material_assimp, slot, type_assimp, resolved_path))
                 return false;
 
+            if (resolved_path.empty())
+                return true;
+
             // load the texture and set it to the material
             {
                 const string tex_name = FileSystem::GetFileNameWithoutExtensionFromFilePath(resolved_path);
@@ -255,21 +329,16 @@ namespace spartan
             return true;
         }
 
-        shared_ptr<Material> load_material(ImportContext& ctx, const aiMaterial* material_assimp)
+        shared_ptr<Material> load_material(const ImportContext& ctx, const aiMaterial* material_assimp)
         {
             SP_ASSERT(material_assimp != nullptr);
             shared_ptr<Material> material = make_shared<Material>();
 
-            // synchronous texture loading (async was causing race conditions with texture packing)
-            // note: gltf uses aiTextureType_GLTF_METALLIC_ROUGHNESS for combined metallic-roughness texture
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::Color,     aiTextureType_BASE_COLOR,              aiTextureType_DIFFUSE);
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::Roughness, aiTextureType_GLTF_METALLIC_ROUGHNESS, aiTextureType_DIFFUSE_ROUGHNESS);
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::Metalness, aiTextureType_GLTF_METALLIC_ROUGHNESS, aiTextureType_METALNESS);
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::Normal,    aiTextureType_NORMAL_CAMERA,           aiTextureType_NORMALS);
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::Occlusion, aiTextureType_AMBIENT_OCCLUSION,       aiTextureType_LIGHTMAP);
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::Emission,  aiTextureType_EMISSION_COLOR,          aiTextureType_EMISSIVE);
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::Height,    aiTextureType_HEIGHT,                  aiTextureType_NONE);
-            load_material_texture(ctx.model_directory, material, material_assimp, MaterialTextureType::AlphaMask, aiTextureType_OPACITY,                 aiTextureType_NONE);
+            // textures are fully loaded before they are set, packing reads them as soon as the material is prepared for the gpu
+            for (const texture_slot& slot : texture_slots)
+            {
+                load_material_texture(ctx.model_directory, material, material_assimp, slot);
+            }
 
             // gltf detection (including .glb binary format)
             const string extension = FileSystem::GetExtensionFromFilePath(ctx.file_path);
@@ -516,8 +585,6 @@ namespace spartan
             return;
         }
 
-        lock_guard<mutex> guard(mutex_import);
-
         // initialize import context
         ImportContext ctx;
         ctx.file_path       = file_path;
@@ -575,7 +642,7 @@ namespace spartan
             }
         }
 
-        ProgressTracker::GetProgress(ProgressType::ModelImporter).Start(1, "Loading model from drive...");
+        ProgressTracker::GetProgress(ProgressType::ModelImporter).AddJobs(1, "Loading model from drive...");
 
         // read the 3d model file from drive
         ctx.scene = importer.ReadFile(file_path, import_flags);
@@ -583,22 +650,84 @@ namespace spartan
         {
             // update progress tracking
             const uint32_t job_count = compute_node_count(ctx.scene->mRootNode);
-            ProgressTracker::GetProgress(ProgressType::ModelImporter).Start(job_count, "Parsing model...");
+            ProgressTracker::GetProgress(ProgressType::ModelImporter).AddJobs(job_count, "Parsing model...");
 
-            // recursively parse nodes
+            // recursively parse nodes, this creates the entities and collects the meshes
             ParseNode(ctx, ctx.scene->mRootNode);
 
-            // update model geometry
+            const uint32_t mesh_count = static_cast<uint32_t>(ctx.mesh_jobs.size());
+            ProgressTracker::GetProgress(ProgressType::ModelImporter).AddJobs(mesh_count, "Processing meshes...");
+
+            // materials used by the meshes
+            vector<bool> material_used(ctx.scene->mNumMaterials, false);
+            if (ctx.scene->HasMaterials())
+            {
+                for (const ImportContext::MeshJob& job : ctx.mesh_jobs)
+                {
+                    material_used[job.mesh->mMaterialIndex] = true;
+                }
+            }
+            ctx.materials.resize(ctx.scene->mNumMaterials);
+
+            // textures load on the thread pool while materials and geometry are processed
+            prefetch_textures(ctx, material_used);
+
+            // materials, each is built once no matter how many meshes use it
+            JobCounter materials_done;
+            for (uint32_t i = 0; i < ctx.scene->mNumMaterials; i++)
+            {
+                if (!material_used[i])
+                    continue;
+
+                ThreadPool::AddTask([&ctx, i]()
+                {
+                    shared_ptr<Material> material = load_material(ctx, ctx.scene->mMaterials[i]);
+
+                    // create a file path for this material
+                    const string spartan_asset_path = ctx.model_directory + material->GetObjectName() + EXTENSION_MATERIAL;
+                    material->SetResourceFilePath(spartan_asset_path);
+
+                    ctx.materials[i] = material;
+                }, materials_done);
+            }
+
+            // geometry, every mesh is converted, optimized and simplified independently
+            if (mesh_count > 0)
             {
-                while (ProgressTracker::GetProgress(ProgressType::ModelImporter).GetFraction() != 1.0f)
+                ThreadPool::ParallelLoop([&ctx](uint32_t start, uint32_t end)
                 {
-                    SP_LOG_INFO("Waiting for node processing threads to finish before creating GPU buffers...");
-                    this_thread::sleep_for(chrono::milliseconds(16));
+                    for (uint32_t i = start; i < end; i++)
+                    {
+                        ParseMesh(ctx, i);
+                    }
+                }, mesh_count);
+            }
+
+            ThreadPool::Wait(materials_done);
+
+            // merge in node order, so sub-mesh indices and buffer layout don't depend on which job finished first
+            lock_guard<mutex> lock(mutex_merge);
+            for (ImportContext::MeshJob& job : ctx.mesh_jobs)
+            {
+                uint32_t sub_mesh_index = 0;
+                ctx.mesh->AddGeometry(job.lods, &sub_mesh_index);
+                job.lods = {};
+
+                // set the geometry
+                job.entity->AddComponent<Renderable>()->SetMesh(ctx.mesh, sub_mesh_index);
+
+                // add a renderable and set the material to it
+                if (ctx.scene->HasMaterials())
+                {
+                    job.entity->AddComponent<Renderable>()->SetMaterial(ctx.materials[job.mesh->mMaterialIndex]);
                 }
 
-                ctx.mesh->CreateGpuBuffers();
+                ProgressTracker::GetProgress(ProgressType::ModelImporter).JobDone();
             }
 
+            // update model geometry
+            ctx.mesh->CreateGpuBuffers();
+
             // make the root entity active since it's now thread-safe
             ctx.mesh->GetRootEntity()->SetActive(true);
         }
@@ -678,7 +807,7 @@ namespace spartan
             }
 
             entity->SetObjectName(node_name);
-            ParseMesh(ctx, node_mesh, entity);
+            ctx.mesh_jobs.push_back({ node_mesh, entity, {} });
         }
     }
 
@@ -723,37 +852,20 @@ namespace spartan
         }
     }
 
-    void ModelImporter::ParseMesh(ImportContext& ctx, aiMesh* assimp_mesh, Entity* entity_parent)
+    void ModelImporter::ParseMesh(ImportContext& ctx, const uint32_t job_index)
     {
-        SP_ASSERT(assimp_mesh != nullptr);
-        SP_ASSERT(entity_parent != nullptr);
+        ImportContext::MeshJob& job = ctx.mesh_jobs[job_index];
+        SP_ASSERT(job.mesh != nullptr);
+        SP_ASSERT(job.entity != nullptr);
 
         // process vertices and indices (parallel for large meshes)
         vector<RHI_Vertex_PosTexNorTan> vertices;
         vector<uint32_t> indices;
 
-        process_vertices_parallel(assimp_mesh, vertices);
-        process_indices_parallel(assimp_mesh, indices);
-
-        // add vertex and index data to the mesh
-        uint32_t sub_mesh_index = 0;
-        ctx.mesh->AddGeometry(vertices, indices, true, &sub_mesh_index);
-
-        // set the geometry
-        entity_parent->AddComponent<Renderable>()->SetMesh(ctx.mesh, sub_mesh_index);
+        process_vertices_parallel(job.mesh, vertices);
+        process_indices_parallel(job.mesh, indices);
 
-        // material
-        if (ctx.scene->HasMaterials())
-        {
-            const aiMaterial* assimp_material = ctx.scene->mMaterials[assimp_mesh->mMaterialIndex];
-            shared_ptr<Material> material = load_material(ctx, assimp_material);
-
-            // create a file path for this material
-            const string spartan_asset_path = ctx.model_directory + material->GetObjectName() + EXTENSION_MATERIAL;
-            material->SetResourceFilePath(spartan_asset_path);
-
-            // add a renderable and set the material to it
-            entity_parent->AddComponent<Renderable>()->SetMaterial(material);
-        }
+        // optimize and generate lods, the mesh itself is only touched when the results are merged
+        ctx.mesh->BuildLods(vertices, indices, true, job.lods);
     }
 }
@@ -27,7 +27,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 struct aiNode;
 struct aiScene;
-struct aiMesh;
 
 namespace spartan
 {
@@ -47,6 +46,6 @@ namespace spartan
         static void ParseNode(ImportContext& ctx, const aiNode* node, Entity* parent_entity = nullptr);
         static void ParseNodeMeshes(ImportContext& ctx, const aiNode* node, Entity* new_entity);
         static void ParseNodeLight(ImportContext& ctx, const aiNode* node, Entity* new_entity);
-        static void ParseMesh(ImportContext& ctx, aiMesh* mesh, Entity* entity_parent);
+        static void ParseMesh(ImportContext& ctx, const uint32_t job_index);
     };
 }
@@ -42,6 +42,100 @@ namespace spartan
         char m_project_directory[256] = {};
         vector<shared_ptr<IResource>> m_resources;
         mutex m_mutex;
+
+        // lookup index, maintained under m_mutex
+        // keys are hashes of the path and of (name, type), buckets hold slots into m_resources in insertion order
+        constexpr uint32_t slot_invalid = numeric_limits<uint32_t>::max();
+        struct resource_keys
+        {
+            uint64_t path = 0;
+            uint64_t name = 0;
+        };
+        vector<resource_keys> m_resource_keys; // the keys each slot was indexed under, parallel to m_resources
+        unordered_map<uint64_t, vector<uint32_t>> m_index_path;
+        unordered_map<uint64_t, vector<uint32_t>> m_index_name;
+
+        // loads in flight, keyed by path and type, values are ResourceCache::PendingLoad<T>
+        mutex m_mutex_pending_loads;
+        unordered_map<string, shared_ptr<void>> m_pending_loads;
+
+        string pending_load_key(const string& file_path, const ResourceType type)
+        {
+            return file_path + '|' + to_string(static_cast<uint32_t>(type));
+        }
+
+        uint64_t hash_path(const string& path)
+        {
+            return static_cast<uint64_t>(hash<string>{}(path));
+        }
+
+        uint64_t hash_name(const string& name, const ResourceType type)
+        {
+            uint64_t key = static_cast<uint64_t>(hash<string>{}(name));
+            return key ^ ((static_cast<uint64_t>(type) + 1) * 0x9E3779B97F4A7C15ull);
+        }
+
+        void index_add(unordered_map<uint64_t, vector<uint32_t>>& index, const uint64_t key, const uint32_t slot)
+        {
+            index[key].emplace_back(slot);
+        }
+
+        void index_remove(unordered_map<uint64_t, vector<uint32_t>>& index, const uint64_t key, const uint32_t slot)
+        {
+            auto it = index.find(key);
+            if (it == index.end())
+                return;
+
+            vector<uint32_t>& slots = it->second;
+            slots.erase(remove(slots.begin(), slots.end(), slot), slots.end());
+            if (slots.empty())
+            {
+                index.erase(it);
+            }
+        }
+
+        void index_move(unordered_map<uint64_t, vector<uint32_t>>& index, const uint64_t key, const uint32_t slot_from, const uint32_t slot_to)
+        {
+            auto it = index.find(key);
+            if (it == index.end())
+                return;
+
+            replace(it->second.begin(), it->second.end(), slot_from, slot_to);
+        }
+
+        void index_insert(IResource* resource, const uint32_t slot)
+        {
+            resource_keys& keys = m_resource_keys[slot];
+            keys.path           = hash_path(resource->GetResourceFilePath());
+            keys.name           = hash_name(resource->GetObjectName(), resource->GetResourceType());
+
+            index_add(m_index_path, keys.path, slot);
+            index_add(m_index_name, keys.name, slot);
+        }
+
+        void index_erase(const uint32_t slot)
+        {
+            const resource_keys& keys = m_resource_keys[slot];
+            index_remove(m_index_path, keys.path, slot);
+            index_remove(m_index_name, keys.name, slot);
+        }
+
+        shared_ptr<IResource> find_by_path(const string& path)
+        {
+            auto it = m_index_path.find(hash_path(path));
+            if (it != m_index_path.end())
+            {
+                for (uint32_t slot : it->second)
+                {
+                    // guard against hash collisions
+                    if (m_resources[slot]->GetResourceFilePath() == path)
+                        return m_resources[slot];
+                }
+            }
+
+            return nullptr;
+        }
+
         bool use_root_shader_directory = false;
         unordered_map<IconType, shared_ptr<RHI_Texture>> m_default_icons;
     }
@@ -63,8 +157,17 @@ namespace spartan
 
     void ResourceCache::Shutdown()
     {
+        lock_guard<mutex> guard(m_mutex);
+
         uint32_t resource_count = static_cast<uint32_t>(m_resources.size());
+        for (shared_ptr<IResource>& resource : m_resources)
+        {
+            resource->m_resource_cache_slot = slot_invalid;
+        }
         m_resources.clear();
+        m_resource_keys.clear();
+        m_index_path.clear();
+        m_index_name.clear();
         if (resource_count != 0)
         {
             SP_LOG_INFO("%d resources have been cleared", resource_count);
@@ -128,15 +231,106 @@ namespace spartan
     shared_ptr<IResource>& ResourceCache::GetByName(const string& name, const ResourceType type)
     {
         lock_guard<mutex> guard(m_mutex);
-        for (shared_ptr<IResource>& resource : m_resources)
+
+        auto it = m_index_name.find(hash_name(name, type));
+        if (it != m_index_name.end())
         {
-            if (name == resource->GetObjectName())
-                return resource;
+            for (uint32_t slot : it->second)
+            {
+                shared_ptr<IResource>& resource = m_resources[slot];
+                if (resource->GetResourceType() == type && name == resource->GetObjectName())
+                    return resource;
+            }
         }
+
         static shared_ptr<IResource> empty;
         return empty;
     }
 
+    shared_ptr<IResource> ResourceCache::GetByPath(const string& path)
+    {
+        lock_guard<mutex> guard(m_mutex);
+        return find_by_path(path);
+    }
+
+    shared_ptr<IResource> ResourceCache::Cache(const shared_ptr<IResource>& resource)
+    {
+        if (!resource)
+            return nullptr;
+
+        if (resource->GetResourceFilePath().empty())
+        {
+            SP_LOG_ERROR("Resource \"%s\" has an empty file path and cannot be cached.", resource->GetObjectName().c_str());
+            return nullptr;
+        }
+
+        // the lookup and the insertion happen under the same lock, so concurrent callers can't cache duplicates
+        lock_guard<mutex> guard(m_mutex);
+
+        if (resource->m_resource_cache_slot != slot_invalid)
+            return resource;
+
+        // return cached resource if it already exists
+        if (shared_ptr<IResource> existing = find_by_path(resource->GetResourceFilePath()))
+            return existing;
+
+        // if not, cache it and return the cached resource
+        const uint32_t slot = static_cast<uint32_t>(m_resources.size());
+        m_resources.emplace_back(resource);
+        m_resource_keys.emplace_back();
+        resource->m_resource_cache_slot = slot;
+        index_insert(resource.get(), slot);
+
+        return resource;
+    }
+
+    void ResourceCache::Remove(IResource* resource)
+    {
+        if (!resource)
+            return;
+
+        // keeps the resource alive until the lock is released, in case the cache holds the last reference
+        shared_ptr<IResource> removed;
+
+        lock_guard<mutex> guard(m_mutex);
+
+        const uint32_t slot = resource->m_resource_cache_slot;
+        if (slot == slot_invalid || slot >= m_resources.size() || m_resources[slot].get() != resource)
+            return;
+
+        removed = m_resources[slot];
+        index_erase(slot);
+
+        // swap with the last resource and pop, so removal doesn't shift the whole vector
+        const uint32_t slot_last = static_cast<uint32_t>(m_resources.size() - 1);
+        if (slot != slot_last)
+        {
+            const resource_keys& keys_last = m_resource_keys[slot_last];
+            index_move(m_index_path, keys_last.path, slot_last, slot);
+            index_move(m_index_name, keys_last.name, slot_last, slot);
+
+            m_resources[slot]                        = std::move(m_resources[slot_last]);
+            m_resource_keys[slot]                    = keys_last;
+            m_resources[slot]->m_resource_cache_slot = slot;
+        }
+
+        resource->m_resource_cache_slot = slot_invalid;
+        m_resources.pop_back();
+        m_resource_keys.pop_back();
+    }
+
+    void ResourceCache::Reindex(IResource* resource)
+    {
+        lock_guard<mutex> guard(m_mutex);
+
+        const uint32_t slot = resource->m_resource_cache_slot;
+        if (slot == slot_invalid || slot >= m_resources.size() || m_resources[slot].get() != resource)
+            return;
+
+        index_erase(slot);
+        index_insert(resource, slot);
+    }
+
     vector<shared_ptr<IResource>> ResourceCache::GetByType(const ResourceType type /*= ResourceType::Unknown*/)
     {
         lock_guard<mutex> guard(m_mutex);
@@ -237,6 +431,26 @@ namespace spartan
         use_root_shader_directory = _use_root_shader_directory;
     }
 
+    shared_ptr<void> ResourceCache::AcquirePendingLoad(const string& file_path, const ResourceType type, shared_ptr<void>(*create)(), bool& created)
+    {
+        lock_guard<mutex> guard(m_mutex_pending_loads);
+
+        shared_ptr<void>& pending = m_pending_loads[pending_load_key(file_path, type)];
+        created = !pending;
+        if (created)
+        {
+            pending = create();
+        }
+
+        return pending;
+    }
+
+    void ResourceCache::ReleasePendingLoad(const string& file_path, const ResourceType type)
+    {
+        lock_guard<mutex> guard(m_mutex_pending_loads);
+        m_pending_loads.erase(pending_load_key(file_path, type));
+    }
+
     RHI_Texture* ResourceCache::GetIcon(IconType type)
     {
         auto it = m_default_icons.find(type);
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "IResource.h"
 #include "../Logging/Log.h"
 #include <mutex>
+#include "../Core/ThreadPool.h"
 #include "../Rendering/Material.h"
 #include "../RHI/RHI_Texture.h"
 //================================
@@ -105,41 +106,23 @@ namespace spartan
         static std::vector<std::shared_ptr<IResource>> GetByType(ResourceType type = ResourceType::Max);
 
         // get by path
+        static std::shared_ptr<IResource> GetByPath(const std::string& path);
         template <class T>
         static std::shared_ptr<T> GetByPath(const std::string& path)
         {
-            for (std::shared_ptr<IResource>& resource : GetResources())
-            {
-                if (path == resource->GetResourceFilePath())
-                    return std::static_pointer_cast<T>(resource);
-            }
-            return nullptr;
+            return std::static_pointer_cast<T>(GetByPath(path));
         }
 
         // caches resource, or replaces with existing cached resource
+        static std::shared_ptr<IResource> Cache(const std::shared_ptr<IResource>& resource);
         template <class T>
         static std::shared_ptr<T> Cache(const std::shared_ptr<T> resource)
         {
-            if (!resource)
-                return nullptr;
-
-            if (resource->GetResourceFilePath().empty())
-            {
-                SP_LOG_ERROR("Resource \"%s\" has an empty file path and cannot be cached.", resource->GetObjectName().c_str());
-                return nullptr;
-            }
-
-            // return cached resource if it already exists
-            std::shared_ptr<T> existing = GetByPath<T>(resource->GetResourceFilePath());
-            if (existing.get() != nullptr)
-                return existing;
-
-            // if not, cache it and return the cached resource
-            std::lock_guard<std::mutex> guard(GetMutex());
-            return std::static_pointer_cast<T>(GetResources().emplace_back(resource));
+            return std::static_pointer_cast<T>(Cache(std::static_pointer_cast<IResource>(resource)));
         }
 
         // loads a resource and adds it to the resource cache
+        // if the same resource is already being loaded, the load is joined instead of repeated
         template <class T>
         static std::shared_ptr<T> Load(const std::string& file_path, uint32_t flags = 0)
         {
@@ -150,39 +133,67 @@ namespace spartan
             }
 
             // return cached resource if it already exists
-            const std::string name = FileSystem::GetFileNameWithoutExtensionFromFilePath(file_path);
             std::shared_ptr<T> existing = GetByPath<T>(file_path);
             if (existing.get() != nullptr)
                 return existing;
 
-            // create new resource
-            std::shared_ptr<T> resource = std::make_shared<T>();
-            if (flags != 0)
+            // run the load here if nobody has started it yet, otherwise wait for the thread that did
+            bool created = false;
+            std::shared_ptr<PendingLoad<T>> pending = AcquirePendingLoad<T>(file_path, created);
+            if (pending->Claim())
+                return ExecutePendingLoad<T>(file_path, flags, *pending);
+
+            return pending->future.get();
+        }
+
+        // loads a resource on the thread pool, concurrent requests for the same resource share a single load
+        // calling Load() for a resource which is still queued runs it immediately on the calling thread
+        // requesting a queued resource with a more urgent priority queues it again on that lane, the first claim to run loads it
+        template <class T>
+        static std::shared_future<std::shared_ptr<T>> LoadAsync(const std::string& file_path, TaskPriority priority = TaskPriority::Normal, uint32_t flags = 0)
+        {
+            std::shared_ptr<T> existing = nullptr;
+            if (!FileSystem::Exists(file_path))
+            {
+                SP_LOG_ERROR("\"%s\" doesn't exist.", file_path.c_str());
+            }
+            else
             {
-                resource->SetFlags(flags);
+                existing = GetByPath<T>(file_path);
+                if (!existing)
+                {
+                    bool created = false;
+                    std::shared_ptr<PendingLoad<T>> pending = AcquirePendingLoad<T>(file_path, created);
+                    if (pending->Queue(priority))
+                    {
+                        ThreadPool::AddTask([file_path, flags, pending]()
+                        {
+                            if (pending->Claim())
+                            {
+                                ExecutePendingLoad<T>(file_path, flags, *pending);
+                            }
+                        }, priority);
+                    }
+
+                    return pending->future;
+                }
             }
-            resource->SetResourceFilePath(file_path);
-            resource->LoadFromFile(file_path);
-            return Cache<T>(resource); // cache and return
+
+            std::promise<std::shared_ptr<T>> ready;
+            ready.set_value(existing);
+            return ready.get_future().share();
         }
 
+        static void Remove(IResource* resource);
         template <class T>
         static void Remove(std::shared_ptr<T>& resource)
         {
-            if (!resource)
-                return;
-            GetResources().erase
-            (
-                std::remove_if
-                (
-                    GetResources().begin(),
-                    GetResources().end(),
-                    [](std::shared_ptr<IResource> resource) { return dynamic_cast<SpartanObject*>(resource.get())->GetObjectId() == resource->GetObjectId(); }
-                ),
-                GetResources().end()
-            );
+            Remove(static_cast<IResource*>(resource.get()));
         }
 
+        // keeps the lookup index in sync when a cached resource changes its path or name
+        static void Reindex(IResource* resource);
+
         // memory
         static uint64_t GetMemoryUsage(ResourceType type = ResourceType::Max);
         static uint32_t GetResourceCount(ResourceType type = ResourceType::Max);
@@ -201,5 +212,65 @@ namespace spartan
         static bool GetUseRootShaderDirectory();
         static void SetUseRootShaderDirectory(const bool use_root_shader_directory);
         static RHI_Texture* GetIcon(IconType type);
+
+    private:
+        // a load which is in flight, shared by every request for the same path and type
+        template <class T>
+        struct PendingLoad
+        {
+            bool Claim() { return !claimed.exchange(true); }
+
+            // lowers the best lane this load is queued on, returns false if it's already queued there or higher
+            bool Queue(const TaskPriority priority)
+            {
+                TaskPriority current = queued.load();
+                while (priority < current)
+                {
+                    if (queued.compare_exchange_weak(current, priority))
+                        return true;
+                }
+
+                return false;
+            }
+
+            std::atomic<bool> claimed = false;
+            std::atomic<TaskPriority> queued = TaskPriority::Max;
+            std::promise<std::shared_ptr<T>> promise;
+            std::shared_future<std::shared_ptr<T>> future = promise.get_future().share();
+        };
+
+        template <class T>
+        static std::shared_ptr<PendingLoad<T>> AcquirePendingLoad(const std::string& file_path, bool& created)
+        {
+            auto create = []() -> std::shared_ptr<void> { return std::make_shared<PendingLoad<T>>(); };
+            return std::static_pointer_cast<PendingLoad<T>>(AcquirePendingLoad(file_path, IResource::TypeToEnum<T>(), create, created));
+        }
+
+        template <class T>
+        static std::shared_ptr<T> ExecutePendingLoad(const std::string& file_path, const uint32_t flags, PendingLoad<T>& pending)
+        {
+            // another load of the same path may have completed between the cache lookup and the claim
+            std::shared_ptr<T> resource = GetByPath<T>(file_path);
+            if (!resource)
+            {
+                resource = std::make_shared<T>();
+                if (flags != 0)
+                {
+                    resource->SetFlags(flags);
+                }
+                resource->SetResourceFilePath(file_path);
+                resource->LoadFromFile(file_path);
+                resource = Cache<T>(resource);
+            }
+
+            // the resource is cached at this point, so new requests will find it there
+            ReleasePendingLoad(file_path, IResource::TypeToEnum<T>());
+            pending.promise.set_value(resource);
+
+            return resource;
+        }
+
+        static std::shared_ptr<void> AcquirePendingLoad(const std::string& file_path, ResourceType type, std::shared_ptr<void>(*create)(), bool& created);
+        static void ReleasePendingLoad(const std::string& file_path, ResourceType type);
     };
 }
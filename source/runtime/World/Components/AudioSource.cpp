@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "AudioSource.h"
 #include "Camera.h"
 #include "../Entity.h"
+#include "../../Memory/Allocator.h"
+#include "../../IO/Binary.h"
 SP_WARNINGS_OFF
 #include <SDL3/SDL_audio.h>
 #include "../IO/pugixml.hpp"
@@ -274,6 +276,30 @@ namespace spartan
         SetAudioClip(m_file_path);
     }
 
+    void AudioSource::Save(BinaryWriter& writer)
+    {
+        writer.WriteString(m_file_path);
+        writer.Write(m_is_3d);
+        writer.Write(m_mute);
+        writer.Write(m_loop);
+        writer.Write(m_play_on_start);
+        writer.Write(m_volume);
+        writer.Write(m_pitch);
+    }
+
+    void AudioSource::Load(BinaryReader& reader)
+    {
+        m_file_path     = reader.ReadString("N/A");
+        m_is_3d         = reader.Read<bool>(false);
+        m_mute          = reader.Read<bool>(false);
+        m_loop          = reader.Read<bool>(true);
+        m_play_on_start = reader.Read<bool>(true);
+        m_volume        = reader.Read<float>(1.0f);
+        m_pitch         = reader.Read<float>(1.0f);
+
+        SetAudioClip(m_file_path);
+    }
+
     void AudioSource::SetAudioClip(const string& file_path)
     {
         // store the filename from the provided path
@@ -395,7 +421,7 @@ namespace spartan
 
         uint32_t num_samples = bytes_to_add / sizeof(float);
         float* mono_samples  = reinterpret_cast<float*>(m_clip->buffer + m_position);
-        vector<float> stereo_chunk(num_samples * 2);
+        FrameVector<float> stereo_chunk(num_samples * 2, 0.0f, FrameStlAllocator<float>(MemoryTag::Audio));
         float gain           = m_volume * m_attenuation * (m_mute ? 0.0f : 1.0f);
 
         // constant power panning
@@ -49,6 +49,8 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void Save(BinaryWriter& writer) override;
+        void Load(BinaryReader& reader) override;
 
         void SetAudioClip(const std::string& file_path);
         const std::string& GetAudioClipName() const { return m_name; };
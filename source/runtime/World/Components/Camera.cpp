@@ -30,6 +30,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Input/Input.h"
 #include "../../Rendering/Renderer.h"
 #include "../../Display/Display.h"
+#include "../../IO/Binary.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -47,9 +48,6 @@ namespace spartan
         m_entity_ptr->SetPosition(Vector3(0.0f, 3.0f, -5.0f));
         SetFlag(CameraFlags::CanBeControlled, true);
         SetFlag(CameraFlags::PhysicalBodyAnimation, true);
-        m_pick_hits.reserve(256);
-        m_pick_indices.reserve(65536);
-        m_pick_vertices.reserve(65536);
     }
 
     void Camera::Initialize()
@@ -60,6 +58,8 @@ namespace spartan
 
     void Camera::Tick()
     {
+        PruneSelection();
+
         const auto& current_viewport = Renderer::GetViewport();
         if (m_last_known_viewport != current_viewport)
         {
@@ -105,6 +105,32 @@ namespace spartan
         ComputeMatrices();
     }
 
+    void Camera::Save(BinaryWriter& writer)
+    {
+        writer.Write(m_aperture);
+        writer.Write(m_shutter_speed);
+        writer.Write(m_iso);
+        writer.Write(m_fov_horizontal_rad);
+        writer.Write(m_near_plane);
+        writer.Write(m_far_plane);
+        writer.Write(static_cast<int32_t>(m_projection_type));
+        writer.Write(m_flags);
+    }
+
+    void Camera::Load(BinaryReader& reader)
+    {
+        m_aperture           = reader.Read<float>(5.6f);
+        m_shutter_speed      = reader.Read<float>(1.0f / 125.0f);
+        m_iso                = reader.Read<float>(200.0f);
+        m_fov_horizontal_rad = reader.Read<float>(90.0f * math::deg_to_rad);
+        m_near_plane         = reader.Read<float>(0.1f);
+        m_far_plane          = reader.Read<float>(10'000.0f);
+        m_projection_type    = static_cast<ProjectionType>(reader.Read<int32_t>(static_cast<int32_t>(Projection_Perspective)));
+        m_flags              = reader.Read<uint32_t>(0);
+
+        ComputeMatrices();
+    }
+
     void Camera::SetProjection(const ProjectionType projection)
     {
         m_projection_type = projection;
@@ -164,100 +190,14 @@ namespace spartan
             return;
         }
 
-        const Ray& ray = ComputePickingRay();
-        m_pick_hits.clear();
-
-        const vector<Entity*>& entities = World::GetEntities();
-        for (Entity* entity : entities)
-        {
-            if (!entity->GetComponent<Renderable>())
-                continue;
-
-            const BoundingBox& aabb = entity->GetComponent<Renderable>()->GetBoundingBox();
-            float distance          = ray.HitDistance(aabb);
-            if (distance == numeric_limits<float>::infinity())
-                continue;
-
-            m_pick_hits.emplace_back(entity, Vector3::Zero, distance, distance == 0.0f);
-        }
-
-        if (m_pick_hits.empty())
+        // closest triangle under the cursor
+        RayHitResult hit;
+        if (!World::Raycast(ComputePickingRay(), &hit))
         {
             ClearSelection();
             return;
         }
-
-        Vector2 cursor         = Input::GetMousePosition();
-        float best_screen_dist = numeric_limits<float>::max();
-        float best_depth       = numeric_limits<float>::max();
-        Entity* best_entity    = nullptr;
-        for (RayHitResult& broad_hit : m_pick_hits)
-        {
-            Renderable* renderable = broad_hit.m_entity->GetComponent<Renderable>();
-
-            // query mesh size first to reserve exact capacity and avoid allocations
-            uint32_t index_count  = renderable->GetIndexCount();
-            uint32_t vertex_count = renderable->GetVertexCount();
-            
-            // reserve exact capacity needed to avoid heap allocations in GetGeometry::resize()
-            // only reserve if current capacity is insufficient
-            if (m_pick_indices.capacity() < index_count)
-            {
-                m_pick_indices.reserve(index_count);
-            }
-            if (m_pick_vertices.capacity() < vertex_count)
-            {
-                m_pick_vertices.reserve(vertex_count);
-            }
-            
-            // clear and reuse pre-allocated buffers 
-            m_pick_indices.clear();
-            m_pick_vertices.clear();
-
-            renderable->GetGeometry(&m_pick_indices, &m_pick_vertices);
-            if (m_pick_indices.empty() || m_pick_vertices.empty())
-                continue;
-
-            const Matrix& transform = broad_hit.m_entity->GetMatrix();
-
-            for (uint32_t i = 0; i < m_pick_indices.size(); i += 3)
-            {
-                Vector3 p1(m_pick_vertices[m_pick_indices[i]].pos);
-                Vector3 p2(m_pick_vertices[m_pick_indices[i + 1]].pos);
-                Vector3 p3(m_pick_vertices[m_pick_indices[i + 2]].pos);
-
-                p1 = p1 * transform;
-                p2 = p2 * transform;
-                p3 = p3 * transform;
-
-                float distance = ray.HitDistance(p1, p2, p3);
-                if (distance == numeric_limits<float>::infinity())
-                    continue;
-
-                Vector3 world_hit = ray.GetStart() + ray.GetDirection() * distance;
-
-                // project to clip space
-                Vector4 clip = Vector4(world_hit, 1.0f) * GetViewProjectionMatrix();
-                if (clip.w == 0.0f)
-                    continue;
-
-                // ndc → screen
-                Vector2 screen_pos(
-                    (clip.x / clip.w * 0.5f + 0.5f) * Renderer::GetViewport().width,
-                    (clip.y / clip.w * 0.5f + 0.5f) * Renderer::GetViewport().height
-                );
-
-                float screen_dist = (screen_pos - cursor).Length();
-
-                // prefer smallest screen distance, then depth
-                if (screen_dist < best_screen_dist || (screen_dist == best_screen_dist && distance < best_depth))
-                {
-                    best_screen_dist = screen_dist;
-                    best_depth       = distance;
-                    best_entity      = broad_hit.m_entity;
-                }
-            }
-        }
+        Entity* best_entity = hit.m_entity;
 
         // handle ctrl for multi-select
         if (best_entity)
@@ -282,30 +222,26 @@ namespace spartan
     
     void Camera::SetSelectedEntity(Entity* entity)
     {
-        m_selected_entities.clear();
-        if (entity)
-        {
-            m_selected_entities.push_back(entity);
-        }
+        ClearSelection();
+        AddToSelection(entity);
     }
     
     Entity* Camera::GetSelectedEntity()
     {
-        return m_selected_entities.empty() ? nullptr : m_selected_entities[0];
+        return m_selected_handles.empty() ? nullptr : World::GetEntity(m_selected_handles[0]);
     }
     
     void Camera::AddToSelection(Entity* entity)
     {
-        if (!entity)
+        if (!entity || IsSelected(entity))
             return;
-        
-        // check if already selected
-        for (Entity* e : m_selected_entities)
-        {
-            if (e && e->GetObjectId() == entity->GetObjectId())
-                return;
-        }
-        
+
+        // only entities which are in the world can be selected, they are the ones a handle can track
+        const EntityHandle handle = World::GetEntityHandle(entity);
+        if (!handle.IsValid())
+            return;
+
+        m_selected_handles.push_back(handle);
         m_selected_entities.push_back(entity);
     }
     
@@ -313,12 +249,17 @@ namespace spartan
     {
         if (!entity)
             return;
-        
-        m_selected_entities.erase(
-            remove_if(m_selected_entities.begin(), m_selected_entities.end(),
-                [entity](Entity* e) { return e && e->GetObjectId() == entity->GetObjectId(); }),
-            m_selected_entities.end()
-        );
+
+        const EntityHandle handle = World::GetEntityHandle(entity);
+        for (size_t i = 0; i < m_selected_handles.size(); i++)
+        {
+            if (m_selected_handles[i] == handle)
+            {
+                m_selected_handles.erase(m_selected_handles.begin() + i);
+                m_selected_entities.erase(m_selected_entities.begin() + i);
+                return;
+            }
+        }
     }
     
     void Camera::ToggleSelection(Entity* entity)
@@ -339,19 +280,32 @@ namespace spartan
     void Camera::ClearSelection()
     {
         m_selected_entities.clear();
+        m_selected_handles.clear();
     }
     
     bool Camera::IsSelected(Entity* entity) const
     {
         if (!entity)
             return false;
-        
-        for (Entity* e : m_selected_entities)
+
+        const EntityHandle handle = World::GetEntityHandle(entity);
+        return handle.IsValid() && find(m_selected_handles.begin(), m_selected_handles.end(), handle) != m_selected_handles.end();
+    }
+
+    void Camera::PruneSelection()
+    {
+        // entities removed from the world since the last frame no longer resolve, drop them before anything reads the pointers
+        for (size_t i = 0; i < m_selected_handles.size();)
         {
-            if (e && e->GetObjectId() == entity->GetObjectId())
-                return true;
+            if (World::GetEntity(m_selected_handles[i]))
+            {
+                i++;
+                continue;
+            }
+
+            m_selected_handles.erase(m_selected_handles.begin() + i);
+            m_selected_entities.erase(m_selected_entities.begin() + i);
         }
-        return false;
     }
 
     void Camera::WorldToScreenCoordinates(const Vector3& position_world, Vector2& position_screen) const
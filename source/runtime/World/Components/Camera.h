@@ -31,6 +31,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Math/Frustum.h"
 #include "../../Math/Vector2.h"
 #include "../../Math/Rectangle.h"
+#include "../World.h"
 //=================================
 
 namespace spartan
@@ -71,6 +72,9 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void Save(BinaryWriter& writer) override;
+        void Load(BinaryReader& reader) override;
+        bool IsLoadThreadSafe() const override { return true; }
 
         // matrices
         const math::Matrix& GetViewMatrix() const           { return m_view; }
@@ -135,6 +139,7 @@ namespace spartan
         // frustum
         bool IsInViewFrustum(const math::BoundingBox& bounding_box) const;
         bool IsInViewFrustum(std::shared_ptr<Renderable> renderable) const;
+        const math::Frustum& GetFrustum() const { return m_frustum; }
 
         // flags
         bool GetFlag(const CameraFlags flag) { return m_flags & flag; }
@@ -161,6 +166,7 @@ namespace spartan
         void FocusOnSelectedEntity();
 
     private:
+        void PruneSelection();
         void ComputeMatrices();
         void ProcessInput();
         void Input_FpsControl();
@@ -198,10 +204,6 @@ namespace spartan
         RHI_Viewport m_last_known_viewport;
         math::Frustum m_frustum;
         std::vector<spartan::Entity*> m_selected_entities;
-        
-        // pre-allocated buffers for picking (to avoid heap allocations)
-        std::vector<math::RayHitResult> m_pick_hits;
-        std::vector<uint32_t> m_pick_indices;
-        std::vector<RHI_Vertex_PosTexNorTan> m_pick_vertices;
+        std::vector<EntityHandle> m_selected_handles; // what the selection holds across frames, the pointers are pruned against it
     };
 }
@@ -37,6 +37,8 @@ namespace spartan
 {
     class Entity;
     class FileStream;
+    class BinaryWriter;
+    class BinaryReader;
 
     // X-Macro: single source of truth for all components
     // Format: X(ClassName, string_name)
@@ -88,12 +90,26 @@ namespace spartan
         // called every frame
         virtual void Tick() {}
 
+        // true if PreTick() and Tick() only write to this component and its own entity, the world then ticks all components of the type in parallel
+        virtual bool IsTickThreadSafe() const { return false; }
+
         // called when the entity is being saved
         virtual void Save(pugi::xml_node& node) {}
 
         // called when the entity is being loaded
         virtual void Load(pugi::xml_node& node) {}
 
+        // binary counterparts of the above, used by the binary world format
+        // fields are read back in the order they were written, so new fields go at the end and older blobs leave them at their defaults
+        virtual void Save(BinaryWriter& writer) {}
+        virtual void Load(BinaryReader& reader) {}
+
+        // bump when the binary layout changes in a way appending fields can't express, the reader reports the version a blob was written with
+        virtual uint32_t GetBinaryVersion() const { return 1; }
+
+        // true if Load() only writes to this component, the binary world loader then deserializes all components of the type in parallel
+        virtual bool IsLoadThreadSafe() const { return false; }
+
         template <typename T>
         static ComponentType TypeToEnum();
 
@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World.h"
 #include "../Entity.h"
 #include "../../Rendering/Renderer.h"
+#include "../../IO/Binary.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -212,6 +213,44 @@ namespace spartan
         UpdateMatrices(); // regenerate view/projection after loading
     }
 
+    void Light::Save(BinaryWriter& writer)
+    {
+        writer.Write(m_flags);
+        writer.Write(static_cast<int32_t>(m_light_type));
+        writer.Write(m_color_rgb.r);
+        writer.Write(m_color_rgb.g);
+        writer.Write(m_color_rgb.b);
+        writer.Write(m_temperature_kelvin);
+        writer.Write(static_cast<int32_t>(m_intensity));
+        writer.Write(m_intensity_lumens_lux);
+        writer.Write(m_range);
+        writer.Write(m_angle_rad);
+        writer.Write(m_index);
+        writer.Write(static_cast<int32_t>(m_preset));
+        writer.Write(m_area_width);
+        writer.Write(m_area_height);
+    }
+
+    void Light::Load(BinaryReader& reader)
+    {
+        m_flags                = reader.Read<uint32_t>(0);
+        m_light_type           = static_cast<LightType>(reader.Read<int32_t>(static_cast<int32_t>(LightType::Max)));
+        m_color_rgb.r          = reader.Read<float>(0.0f);
+        m_color_rgb.g          = reader.Read<float>(0.0f);
+        m_color_rgb.b          = reader.Read<float>(0.0f);
+        m_temperature_kelvin   = reader.Read<float>(0.0f);
+        m_intensity            = static_cast<LightIntensity>(reader.Read<int32_t>(static_cast<int32_t>(LightIntensity::bulb_500_watt)));
+        m_intensity_lumens_lux = reader.Read<float>(2600.0f);
+        m_range                = reader.Read<float>(32.0f);
+        m_angle_rad            = reader.Read<float>(math::deg_to_rad * 30.0f);
+        m_index                = reader.Read<uint32_t>(0);
+        m_preset               = static_cast<LightPreset>(reader.Read<int32_t>(static_cast<int32_t>(LightPreset::custom)));
+        m_area_width           = reader.Read<float>(1.0f);
+        m_area_height          = reader.Read<float>(1.0f);
+
+        UpdateMatrices(); // regenerate view/projection after loading
+    }
+
     void Light::SetFlag(const LightFlags flag, const bool enable)
     {
         bool enabled      = false;
@@ -251,6 +290,7 @@ namespace spartan
             return;
 
         m_light_type = type;
+        World::MarkEntityChanged(GetEntity(), EntityChange::LightType);
 
         SetColor(get_sensible_color(m_light_type));
         SetRange(get_sensible_range(m_light_type));
@@ -734,6 +774,21 @@ namespace spartan
         }
     }
 
+    Frustum Light::GetFrustumPadded(const uint32_t array_index, const float padding) const
+    {
+        if (m_light_type != LightType::Directional)
+            return m_frustums[array_index];
+
+        const float extent      = GetCascadeExtent(array_index) + padding;
+        const Matrix projection = Matrix::CreateOrthoOffCenterLH(-extent, extent, -extent, extent, cascade_depth, 0.0f);
+        return Frustum(m_matrix_view[array_index], projection);
+    }
+
+    float Light::GetCascadeExtent(const uint32_t array_index) const
+    {
+        return array_index == 0 ? cascade_near_extent : cascade_far_extent;
+    }
+
     bool Light::IsInViewFrustum(Renderable* renderable, const uint32_t array_index) const
     {
         const BoundingBox& bounding_box = renderable->GetBoundingBox();
@@ -86,8 +86,12 @@ namespace spartan
         //= COMPONENT ================================
         void PreTick() override;
         void Tick() override;
+        bool IsTickThreadSafe() const override { return false; } // the day night cycle rotates the entity, and setters are main thread only
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void Save(BinaryWriter& writer) override;
+        void Load(BinaryReader& reader) override;
+        bool IsLoadThreadSafe() const override { return true; }
         //============================================
 
         // flags
@@ -134,6 +138,11 @@ namespace spartan
 
         // frustum
         bool IsInViewFrustum(Renderable* renderable, const uint32_t array_index) const;
+        const math::Frustum& GetFrustum(const uint32_t array_index) const { return m_frustums[array_index]; }
+
+        // directional cascades only, the cascade grown by padding world units on each side, other lights return their frustum
+        math::Frustum GetFrustumPadded(const uint32_t array_index, const float padding) const;
+        float GetCascadeExtent(const uint32_t array_index) const;
 
         // index
         void SetIndex(const uint32_t index) { m_index = index; }
@@ -30,6 +30,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Physics/Car.h"
 #include "../../Geometry/GeometryProcessing.h"
 #include "../../Rendering/Renderer.h"
+#include "../../IO/Binary.h"
 SP_WARNINGS_OFF
 #ifdef DEBUG
     #define _DEBUG 1
@@ -96,12 +97,6 @@ namespace spartan
             return PxTransform(PxVec3(pos.x, pos.y, pos.z), PxQuat(rot.x, rot.y, rot.z, rot.w));
         }
 
-        void from_px_transform(const PxTransform& pose, Vector3& pos, Quaternion& rot)
-        {
-            pos = Vector3(pose.p.x, pose.p.y, pose.p.z);
-            rot = Quaternion(pose.q.x, pose.q.y, pose.q.z, pose.q.w);
-        }
-
         Vector3 from_px_vec3(const PxVec3& v)
         {
             return Vector3(v.x, v.y, v.z);
@@ -157,7 +152,7 @@ namespace spartan
         // release controller if it exists
         if (m_controller)
         {
-            static_cast<PxController*>(m_controller)->release();
+            PhysicsWorld::ReleaseController(static_cast<PxController*>(m_controller));
             m_controller = nullptr;
         }
 
@@ -290,7 +285,7 @@ namespace spartan
             // sync physx -> entity
             Vector3 pos;
             Quaternion rot;
-            from_px_transform(actor->getGlobalPose(), pos, rot);
+            PhysicsWorld::GetInterpolatedPose(actor, pos, rot);
             GetEntity()->SetPosition(pos);
             GetEntity()->SetRotation(rot);
 
@@ -353,7 +348,7 @@ namespace spartan
                     {
                         Vector3 pos;
                         Quaternion rot;
-                        from_px_transform(actor->getGlobalPose(), pos, rot);
+                        PhysicsWorld::GetInterpolatedPose(actor, pos, rot);
                         GetEntity()->SetPosition(pos);
                         GetEntity()->SetRotation(rot);
                     }
@@ -464,6 +459,37 @@ namespace spartan
         m_needs_creation = true;
     }
 
+    void Physics::Save(BinaryWriter& writer)
+    {
+        writer.Write(m_mass);
+        writer.Write(m_friction);
+        writer.Write(m_friction_rolling);
+        writer.Write(m_restitution);
+        writer.Write(m_is_static);
+        writer.Write(m_is_kinematic);
+        writer.Write(m_position_lock);
+        writer.Write(m_rotation_lock);
+        writer.Write(m_center_of_mass);
+        writer.Write(static_cast<int32_t>(m_body_type));
+    }
+
+    void Physics::Load(BinaryReader& reader)
+    {
+        m_mass             = reader.Read<float>(0.001f);
+        m_friction         = reader.Read<float>(1.0f);
+        m_friction_rolling = reader.Read<float>(0.002f);
+        m_restitution      = reader.Read<float>(0.2f);
+        m_is_static        = reader.Read<bool>(true);
+        m_is_kinematic     = reader.Read<bool>(false);
+        m_position_lock    = reader.Read<Vector3>(Vector3::Zero);
+        m_rotation_lock    = reader.Read<Vector3>(Vector3::Zero);
+        m_center_of_mass   = reader.Read<Vector3>(Vector3::Zero);
+        m_body_type        = static_cast<BodyType>(reader.Read<int32_t>(static_cast<int32_t>(BodyType::Max)));
+
+        // same as the xml path, creation waits for the tick
+        m_needs_creation = true;
+    }
+
     void Physics::SetMass(float mass)
     {
         // approximate mass from volume
@@ -925,6 +951,9 @@ namespace spartan
 
     void Physics::SetBodyTransform(const Vector3& position, const Quaternion& rotation)
     {
+        // a teleport isn't blended into
+        m_pose_previous_step = 0;
+
         // for vehicles, use the car body directly
         if (m_body_type == BodyType::Vehicle && car::body)
         {
@@ -956,6 +985,27 @@ namespace spartan
         }
     }
 
+    void Physics::SetPosePrevious(void* actor, const Vector3& position, const Quaternion& rotation, const uint64_t step)
+    {
+        if (m_actors.empty() || actor != m_actors[0])
+            return;
+
+        m_pose_previous_position = position;
+        m_pose_previous_rotation = rotation;
+        m_pose_previous_step     = step;
+    }
+
+    bool Physics::GetPosePrevious(void* actor, const uint64_t step, Vector3& position, Quaternion& rotation) const
+    {
+        if (m_actors.empty() || actor != m_actors[0] || m_pose_previous_step != step)
+            return false;
+
+        position = m_pose_previous_position;
+        rotation = m_pose_previous_rotation;
+
+        return true;
+    }
+
     void Physics::SetVehicleThrottle(float value)
     {
         if (m_body_type != BodyType::Vehicle)
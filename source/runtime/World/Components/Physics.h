@@ -25,13 +25,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Component.h"
 #include <vector>
 #include "../../Math/Vector3.h"
+#include "../../Math/Quaternion.h"
 //=============================
 
 namespace spartan
 {
     class Entity;
     class PhysicsWorld;
-    namespace math { class Quaternion; }
 
     enum class PhysicsForce
     {
@@ -75,6 +75,9 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void Save(BinaryWriter& writer) override;
+        void Load(BinaryReader& reader) override;
+        bool IsLoadThreadSafe() const override { return true; }
         
         // static cleanup (call before physics world shutdown)
         static void Shutdown();
@@ -142,6 +145,10 @@ namespace spartan
         void Crouch(const bool crouch);
         void SetBodyTransform(const math::Vector3& position, const math::Quaternion& rotation); // teleport physics body
 
+        // pose of the body before a physics step, captured by the physics world in async mode and blended from, see PhysicsWorld::GetInterpolatedPose()
+        void SetPosePrevious(void* actor, const math::Vector3& position, const math::Quaternion& rotation, const uint64_t step);
+        bool GetPosePrevious(void* actor, const uint64_t step, math::Vector3& position, math::Quaternion& rotation) const;
+
         // vehicle controls (only works when body type is Vehicle)
         void SetVehicleThrottle(float value);   // 0 to 1
         void SetVehicleBrake(float value);      // 0 to 1
@@ -267,6 +274,11 @@ namespace spartan
         std::vector<void*> m_actors      = { nullptr };
         std::vector<bool> m_actors_active; // tracks which actors are currently in the scene (for distance-based activation)
 
+        // pose of the first actor before the step with the given index, 0 when there is none
+        math::Vector3 m_pose_previous_position    = math::Vector3::Zero;
+        math::Quaternion m_pose_previous_rotation = math::Quaternion::Identity;
+        uint64_t m_pose_previous_step             = 0;
+
         // vehicle wheel entities and state
         Entity* m_wheel_entities[static_cast<int>(WheelIndex::Count)] = { nullptr, nullptr, nullptr, nullptr };
         float m_wheel_radius   = 0.35f; // wheel radius for spin calculation (default)
@@ -30,6 +30,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Resource/ResourceCache.h"
 #include "../../Rendering/Renderer.h"
 #include "../../Rendering/Material.h"
+#include "../../IO/Binary.h"
+#include "../../Geometry/Bvh.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -101,10 +103,84 @@ namespace spartan
     }
     
     void Renderable::Load(pugi::xml_node& node)
+    {
+        const string mesh_name     = node.attribute("mesh_name").as_string();
+        m_sub_mesh_index           = node.attribute("sub_mesh_index").as_uint();
+        m_material_default         = node.attribute("material_default").as_bool(true);
+        const string material_name = node.attribute("material_name").as_string();
+        m_flags                    = node.attribute("flags").as_uint();
+        m_max_distance_render      = node.attribute("max_render_distance").as_float(FLT_MAX);
+        m_max_distance_shadow      = node.attribute("max_shadow_distance").as_float(FLT_MAX);
+    
+        // instances
+        m_instances.clear();
+        pugi::xml_node instances_node = node.child("Instances");
+        if (instances_node)
+        {
+            for (pugi::xml_node t_node : instances_node.children("Transform"))
+            {
+                std::stringstream ss(t_node.attribute("matrix").as_string());
+                math::Matrix matrix;
+                float m[16];
+                for (int i = 0; i < 16; ++i)
+                {
+                    ss >> m[i];
+                }
+                if (!ss.fail())
+                {
+                    matrix = math::Matrix(m[0], m[1], m[2], m[3],
+                        m[4], m[5], m[6], m[7],
+                        m[8], m[9], m[10], m[11],
+                        m[12], m[13], m[14], m[15]);
+                    Instance instance;
+                    instance.SetMatrix(matrix);
+                    m_instances.emplace_back(instance);
+                }
+            }
+        }
+
+        OnLoad(mesh_name, material_name);
+    }
+
+    void Renderable::Save(BinaryWriter& writer)
+    {
+        writer.WriteString(m_mesh ? m_mesh->GetObjectName() : "");
+        writer.Write(m_sub_mesh_index);
+        writer.WriteString(m_material && !m_material_default ? m_material->GetObjectName() : "");
+        writer.Write(m_material_default);
+        writer.Write(m_flags);
+        writer.Write(m_max_distance_render);
+        writer.Write(m_max_distance_shadow);
+
+        // instances are already packed, so they are stored as is
+        writer.Write(static_cast<uint32_t>(m_instances.size()));
+        writer.Write(m_instances.data(), m_instances.size() * sizeof(Instance));
+    }
+
+    void Renderable::Load(BinaryReader& reader)
+    {
+        const string mesh_name     = reader.ReadString();
+        m_sub_mesh_index           = reader.Read<uint32_t>(0);
+        const string material_name = reader.ReadString();
+        m_material_default         = reader.Read<bool>(true);
+        m_flags                    = reader.Read<uint32_t>(0);
+        m_max_distance_render      = reader.Read<float>(FLT_MAX);
+        m_max_distance_shadow      = reader.Read<float>(FLT_MAX);
+
+        m_instances.clear();
+        const uint32_t instance_count = reader.Read<uint32_t>(0);
+        if (instance_count <= reader.GetRemaining() / sizeof(Instance))
+        {
+            m_instances.resize(instance_count);
+            reader.Read(m_instances.data(), m_instances.size() * sizeof(Instance));
+        }
+
+        OnLoad(mesh_name, material_name);
+    }
+
+    void Renderable::OnLoad(const string& mesh_name, const string& material_name)
     {
         // mesh
-        const string mesh_name = node.attribute("mesh_name").as_string();
-        m_sub_mesh_index       = node.attribute("sub_mesh_index").as_uint();
         if (!mesh_name.empty())
         {
             // check for standard meshes first (owned by Renderer, not ResourceCache)
@@ -144,8 +220,6 @@ namespace spartan
         }
     
         // material
-        m_material_default         = node.attribute("material_default").as_bool(true);
-        const string material_name = node.attribute("material_name").as_string();
         if (!material_name.empty() && !m_material_default)
         {
             shared_ptr<Material> material = ResourceCache::GetByName<Material>(material_name);
@@ -160,40 +234,6 @@ namespace spartan
             m_needs_default_material = true;
         }
     
-        // flags
-        m_flags = node.attribute("flags").as_uint();
-    
-        // distances
-        m_max_distance_render = node.attribute("max_render_distance").as_float(FLT_MAX);
-        m_max_distance_shadow = node.attribute("max_shadow_distance").as_float(FLT_MAX);
-    
-        // instances
-        m_instances.clear();
-        pugi::xml_node instances_node = node.child("Instances");
-        if (instances_node)
-        {
-            for (pugi::xml_node t_node : instances_node.children("Transform"))
-            {
-                std::stringstream ss(t_node.attribute("matrix").as_string());
-                math::Matrix matrix;
-                float m[16];
-                for (int i = 0; i < 16; ++i)
-                {
-                    ss >> m[i];
-                }
-                if (!ss.fail())
-                {
-                    matrix = math::Matrix(m[0], m[1], m[2], m[3],
-                        m[4], m[5], m[6], m[7],
-                        m[8], m[9], m[10], m[11],
-                        m[12], m[13], m[14], m[15]);
-                    Instance instance;
-                    instance.SetMatrix(matrix);
-                    m_instances.emplace_back(instance);
-                }
-            }
-        }
-    
         // compute mesh bounding box (needed for culling and LOD)
         if (m_mesh)
         {
@@ -221,6 +261,10 @@ namespace spartan
         // deferred default material assignment (renderer may not be ready during load)
         if (m_needs_default_material)
         {
+            // renderables tick in parallel, the material assignment goes through shared state
+            static mutex default_material_mutex;
+            lock_guard<mutex> lock(default_material_mutex);
+
             if (Renderer::GetStandardMaterial())
             {
                 SetDefaultMaterial();
@@ -229,7 +273,6 @@ namespace spartan
         }
 
         UpdateAabb();
-        UpdateFrustumAndDistanceCulling();
         UpdateLodIndices();
     }
 
@@ -253,7 +296,7 @@ namespace spartan
             m_bounding_box_mesh = BoundingBox(vertices.data(), static_cast<uint32_t>(vertices.size()));
         }
 
-        Tick(); // update bounding boxes, frustum and distance culling
+        Tick(); // update bounding boxes and lods
     }
 
     void Renderable::SetMesh(const MeshType type)
@@ -411,8 +454,98 @@ namespace spartan
         return to_world ? m_instances[index].GetMatrix() * GetEntity()->GetMatrix() : m_instances[index].GetMatrix();
     }
 
+    void Renderable::BuildBvh(const bool include_mesh)
+    {
+        if (!m_mesh)
+            return;
+
+        if (include_mesh)
+        {
+            m_mesh->BuildBvh(m_sub_mesh_index);
+        }
+
+        if (m_instances.empty())
+            return;
+
+        lock_guard<mutex> lock(m_instance_bvh_mutex);
+        if (m_instance_bvh)
+            return;
+
+        vector<BoundingBox> boxes(m_instances.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_instances.size()); i++)
+        {
+            boxes[i] = m_bounding_box_mesh * m_instances[i].GetMatrix();
+        }
+
+        m_instance_bvh = make_unique<Bvh>();
+        m_instance_bvh->Build(boxes);
+    }
+
+    float Renderable::Raycast(const Vector3& origin, const Vector3& direction, const float max_distance, Vector3* out_normal)
+    {
+        if (!m_mesh)
+            return numeric_limits<float>::infinity();
+
+        BuildBvh();
+
+        // the ray goes into the space of the vertices rather than the vertices into world space, the direction isn't
+        // renormalized so distances come out in world units
+        const Matrix& to_world        = GetEntity()->GetMatrix();
+        const Matrix to_entity        = to_world.Inverted();
+        const Vector3 origin_local    = origin * to_entity;
+        const Vector3 direction_local = (origin + direction) * to_entity - origin_local;
+
+        Vector3 normal   = Vector3::Zero;
+        float distance   = numeric_limits<float>::infinity();
+        Matrix to_normal = to_world;
+        if (m_instances.empty())
+        {
+            distance = m_mesh->Raycast(m_sub_mesh_index, origin_local, direction_local, max_distance, out_normal ? &normal : nullptr);
+        }
+        else
+        {
+            Bvh* bvh = nullptr;
+            {
+                lock_guard<mutex> lock(m_instance_bvh_mutex);
+                bvh = m_instance_bvh.get();
+            }
+            if (!bvh)
+                return numeric_limits<float>::infinity();
+
+            distance = bvh->Raycast(origin_local, direction_local, max_distance, [&](const uint32_t index, const float limit)
+            {
+                const Matrix to_instance     = m_instances[index].GetMatrix();
+                const Matrix to_mesh         = to_instance.Inverted();
+                const Vector3 origin_mesh    = origin_local * to_mesh;
+                const Vector3 direction_mesh = (origin_local + direction_local) * to_mesh - origin_mesh;
+
+                Vector3 normal_instance = Vector3::Zero;
+                const float d = m_mesh->Raycast(m_sub_mesh_index, origin_mesh, direction_mesh, limit, out_normal ? &normal_instance : nullptr);
+                if (d < limit)
+                {
+                    normal    = normal_instance;
+                    to_normal = to_instance * to_world;
+                }
+                return d;
+            });
+        }
+
+        if (out_normal && distance != numeric_limits<float>::infinity())
+        {
+            // exact for uniform scale, which is what instances and most entities have
+            *out_normal = (normal * to_normal - Vector3::Zero * to_normal).Normalized();
+        }
+
+        return distance;
+    }
+
     void Renderable::SetInstances(const vector<Instance>& instances)
     {
+        {
+            lock_guard<mutex> lock(m_instance_bvh_mutex);
+            m_instance_bvh = nullptr;
+        }
+
         if (instances.empty())
         {
             m_instances.clear();
@@ -433,7 +566,7 @@ namespace spartan
         );
 
         m_bounding_box_dirty = true;
-        Tick(); // update bounding boxes, frustum and distance culling
+        Tick(); // update bounding boxes and lods
     }
 
     void Renderable::SetInstances(const vector<Matrix>& transforms)
@@ -508,34 +641,6 @@ namespace spartan
         }
     }
 
-    void Renderable::UpdateFrustumAndDistanceCulling()
-    {
-        if (Camera* camera = World::GetCamera())
-        {
-            Vector3 camera_position = camera->GetEntity()->GetPosition();
-    
-            const BoundingBox& bounding_box = GetBoundingBox();
-
-            // first, check if the bounding box is in the frustum
-            if (camera->IsInViewFrustum(bounding_box))
-            {
-                // only if in frustum, calculate distance
-                m_distance_squared = Vector3::DistanceSquared(camera_position, bounding_box.GetClosestPoint(camera_position));
-                m_is_visible       = m_distance_squared <= m_max_distance_render * m_max_distance_render;
-            }
-            else
-            {
-                // outside frustum, no need for distance check
-                m_is_visible = false;
-            }
-        }
-        else
-        {
-            m_distance_squared = 0.0f;
-            m_is_visible       = true;
-        }
-    }
-
     void Renderable::UpdateLodIndices()
     {
         // screen-space coverage based lod selection
@@ -35,6 +35,7 @@ namespace spartan
 {
     class Material;
     class RHI_CommandList;
+    class Bvh;
 
     enum RenderableFlags : uint32_t
     {
@@ -50,11 +51,17 @@ namespace spartan
         // icomponent
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void Save(BinaryWriter& writer) override;
+        void Load(BinaryReader& reader) override;
+        bool IsLoadThreadSafe() const override { return true; }
         void Tick() override;
+        bool IsTickThreadSafe() const override { return true; }
 
         // mesh
         void SetMesh(Mesh* mesh, const uint32_t sub_mesh_index = 0);
         void SetMesh(const MeshType type);
+        Mesh* GetMesh() const            { return m_mesh; }
+        uint32_t GetSubMeshIndex() const { return m_sub_mesh_index; }
         void GetGeometry(std::vector<uint32_t>* indices, std::vector<RHI_Vertex_PosTexNorTan>* vertices) const;
         uint32_t GetLodCount() const;
         uint32_t GetLodIndex() const { return m_lod_index; }
@@ -72,6 +79,11 @@ namespace spartan
         // bounding box
         const math::BoundingBox& GetBoundingBox() const { return m_bounding_box;}
 
+        // ray queries against the triangles, in world space, returns the hit distance or infinity
+        // BuildBvh() does the one off work up front (the mesh bvh and the one over the instances) so it can be spread across threads
+        void BuildBvh(const bool include_mesh = true);
+        float Raycast(const math::Vector3& origin, const math::Vector3& direction, const float max_distance, math::Vector3* out_normal = nullptr);
+
         // material
         void SetMaterial(const std::shared_ptr<Material>& material);
         void SetMaterial(const std::string& file_path);
@@ -95,10 +107,11 @@ namespace spartan
         float GetMaxShadowDistance() const                         { return m_max_distance_shadow; }
         void SetMaxShadowDistance(const float max_shadow_distance) { m_max_distance_shadow = max_shadow_distance; }
 
-        // distance & visibility
-        float GetDistanceSquared() const    { return m_distance_squared; }
-        bool IsVisible() const              { return m_is_visible; }
-        void SetVisible(const bool visible) { m_is_visible = visible; }
+        // distance & visibility, computed by the renderer's culling stage
+        float GetDistanceSquared() const                      { return m_distance_squared; }
+        void SetDistanceSquared(const float distance_squared) { m_distance_squared = distance_squared; }
+        bool IsVisible() const                                { return m_is_visible; }
+        void SetVisible(const bool visible)                   { m_is_visible = visible; }
 
         // flags
         bool HasFlag(const RenderableFlags flag) const { return m_flags & flag; }
@@ -109,8 +122,8 @@ namespace spartan
         void SetPreviousLights(uint64_t lights) { m_previous_lights = lights; }
 
     private:
+        void OnLoad(const std::string& mesh_name, const std::string& material_name); // shared tail of the xml and binary loads
         void UpdateAabb();
-        void UpdateFrustumAndDistanceCulling();
         void UpdateLodIndices();
 
         // geometry/mesh
@@ -127,6 +140,8 @@ namespace spartan
         // instancing
         std::vector<Instance> m_instances;
         std::shared_ptr<RHI_Buffer> m_instance_buffer;
+        std::unique_ptr<Bvh> m_instance_bvh; // over the instances in entity space, built on the first raycast
+        std::mutex m_instance_bvh_mutex;
 
         // misc
         math::Matrix m_transform_previous = math::Matrix::Identity;
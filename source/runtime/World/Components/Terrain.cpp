@@ -32,6 +32,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Geometry/GeometryProcessing.h"
 #include "../../Core/ThreadPool.h"
 #include "../../Core/ProgressTracker.h"
+#include "../../IO/Binary.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -46,17 +47,40 @@ namespace spartan
 {
     namespace placement
     {
+        // instances are handed out in cells of this size, which bounds how many exist at once
+        const float cell_size = 64.0f;
+
         struct ClusterData
         {
             Vector3 center_position;
             uint32_t center_tri_idx;
         };
 
+        Vector3 get_normal(const TriangleData& tri)
+        {
+            return Vector3::Cross(tri.v1_minus_v0, tri.v2_minus_v0).Normalized();
+        }
+
+        Vector3 get_centroid(const TriangleData& tri)
+        {
+            return tri.v0 + (tri.v1_minus_v0 + tri.v2_minus_v0) / 3.0f;
+        }
+
+        Vector3 get_random_point(const TriangleData& tri, mt19937& generator, uniform_real_distribution<float>& dist)
+        {
+            float r1      = dist(generator);
+            float r2      = dist(generator);
+            float sqrt_r1 = sqrtf(r1);
+            float u       = 1.0f - sqrt_r1;
+            float v       = r2 * sqrt_r1;
+            return tri.v0 + u * tri.v1_minus_v0 + v * tri.v2_minus_v0;
+        }
+
         void compute_triangle_data(
             const vector<vector<RHI_Vertex_PosTexNorTan>>& vertices_terrain,
             const vector<vector<uint32_t>>& indices_terrain,
             uint32_t tile_index,
-            unordered_map<uint64_t, vector<TriangleData>>& triangle_data_out
+            vector<vector<TriangleData>>& triangle_data_out
         )
         {
             const vector<RHI_Vertex_PosTexNorTan>& vertices_tile = vertices_terrain[tile_index];
@@ -78,104 +102,59 @@ namespace spartan
                     Vector3 v1(vertices_tile[idx1].pos[0], vertices_tile[idx1].pos[1], vertices_tile[idx1].pos[2]);
                     Vector3 v2(vertices_tile[idx2].pos[0], vertices_tile[idx2].pos[1], vertices_tile[idx2].pos[2]);
 
-                    Vector3 v1_minus_v0           = v1 - v0;
-                    Vector3 v2_minus_v0           = v2 - v0;
-                    Vector3 normal                = Vector3::Cross(v1_minus_v0, v2_minus_v0).Normalized();
-                    float slope_radians           = acos(Vector3::Dot(normal, Vector3::Up));
-                    Quaternion rotation_to_normal = Quaternion::FromRotation(Vector3::Up, normal);
-                    Vector3 centroid              = v0 + (v1_minus_v0 + v2_minus_v0) / 3.0f;
-
-                    tile_triangle_data[i] = {
-                        normal, v0, v1_minus_v0, v2_minus_v0, slope_radians,
-                        min({ v0.y, v1.y, v2.y }), max({ v0.y, v1.y, v2.y }),
-                        rotation_to_normal, centroid
-                    };
+                    tile_triangle_data[i] = { v0, v1 - v0, v2 - v0 };
                 }
             };
 
             ThreadPool::ParallelLoop(compute_triangle, triangle_count);
         }
 
-        void find_transforms(
+        void find_instances(
             TerrainPropDescription prop_desc,
             const float density_fraction,
             uint32_t tile_index,
-            vector<Matrix>& transforms_out,
-            unordered_map<uint64_t, vector<TriangleData>>& triangle_data
+            const float scale_compensation, // undoes the scale of the entity the instances end up under
+            const vector<TriangleData>& tile_triangle_data,
+            const function<void(const vector<Instance>&)>& on_cell
         )
         {
-            auto it = triangle_data.find(tile_index);
-            if (it == triangle_data.end())
-            {
-                SP_LOG_ERROR("no triangle data found for tile %d", tile_index);
-                return;
-            }
-            vector<TriangleData>& tile_triangle_data = it->second;
             SP_ASSERT(!tile_triangle_data.empty());
 
-            // compute tile bounds using parallel reduction
-            uint32_t tri_count_bounds = static_cast<uint32_t>(tile_triangle_data.size());
-            uint32_t num_chunks = min(tri_count_bounds, static_cast<uint32_t>(thread::hardware_concurrency()));
-            if (num_chunks == 0) num_chunks = 1;
-            
-            struct Bounds { float min_x, max_x, min_z, max_z; };
-            vector<Bounds> chunk_bounds(num_chunks, { 
-                numeric_limits<float>::max(), numeric_limits<float>::lowest(),
-                numeric_limits<float>::max(), numeric_limits<float>::lowest() 
-            });
-            
-            uint32_t chunk_size = (tri_count_bounds + num_chunks - 1) / num_chunks;
-            auto parallel_bounds = [&](uint32_t start, uint32_t end)
-            {
-                for (uint32_t c = start; c < end; c++)
-                {
-                    uint32_t chunk_start = c * chunk_size;
-                    uint32_t chunk_end   = min(chunk_start + chunk_size, tri_count_bounds);
-                    Bounds& b            = chunk_bounds[c];
-                    
-                    for (uint32_t i = chunk_start; i < chunk_end; i++)
-                    {
-                        const auto& tri = tile_triangle_data[i];
-                        b.min_x = min(b.min_x, tri.centroid.x);
-                        b.max_x = max(b.max_x, tri.centroid.x);
-                        b.min_z = min(b.min_z, tri.centroid.z);
-                        b.max_z = max(b.max_z, tri.centroid.z);
-                    }
-                }
-            };
-            ThreadPool::ParallelLoop(parallel_bounds, num_chunks);
-            
-            // merge chunk results
+            // compute tile bounds
             float tile_min_x = numeric_limits<float>::max();
             float tile_max_x = numeric_limits<float>::lowest();
             float tile_min_z = numeric_limits<float>::max();
             float tile_max_z = numeric_limits<float>::lowest();
-            for (const auto& b : chunk_bounds)
+            for (const TriangleData& tri : tile_triangle_data)
             {
-                tile_min_x = min(tile_min_x, b.min_x);
-                tile_max_x = max(tile_max_x, b.max_x);
-                tile_min_z = min(tile_min_z, b.min_z);
-                tile_max_z = max(tile_max_z, b.max_z);
+                const Vector3 centroid = get_centroid(tri);
+                tile_min_x             = min(tile_min_x, centroid.x);
+                tile_max_x             = max(tile_max_x, centroid.x);
+                tile_min_z             = min(tile_min_z, centroid.z);
+                tile_max_z             = max(tile_max_z, centroid.z);
             }
 
             // filter triangles that meet spawn criteria
             const float edge_epsilon = 0.01f;
             float edge_threshold_x   = tile_max_x - edge_epsilon;
             float edge_threshold_z   = tile_max_z - edge_epsilon;
+            const float cos_slope    = cosf(prop_desc.max_slope_angle_rad);
 
             vector<uint32_t> acceptable_triangles;
-            acceptable_triangles.reserve(tile_triangle_data.size());
             for (uint32_t i = 0; i < tile_triangle_data.size(); i++)
             {
                 const TriangleData& tri = tile_triangle_data[i];
 
                 // skip edge triangles to prevent double-spawning at tile boundaries
-                if (tri.centroid.x >= edge_threshold_x || tri.centroid.z >= edge_threshold_z)
+                const Vector3 centroid = get_centroid(tri);
+                if (centroid.x >= edge_threshold_x || centroid.z >= edge_threshold_z)
                     continue;
 
-                if (tri.slope_radians <= prop_desc.max_slope_angle_rad &&
-                    tri.height_min >= prop_desc.min_spawn_height &&
-                    tri.height_max <= prop_desc.max_spawn_height)
+                const float height_min = tri.v0.y + min({ 0.0f, tri.v1_minus_v0.y, tri.v2_minus_v0.y });
+                const float height_max = tri.v0.y + max({ 0.0f, tri.v1_minus_v0.y, tri.v2_minus_v0.y });
+                if (get_normal(tri).y >= cos_slope &&
+                    height_min >= prop_desc.min_spawn_height &&
+                    height_max <= prop_desc.max_spawn_height)
                 {
                     acceptable_triangles.push_back(i);
                 }
@@ -183,12 +162,102 @@ namespace spartan
             if (acceptable_triangles.empty())
                 return;
 
+            // bucket the acceptable triangles into cells, a counting sort keeps each cell contiguous
+            const uint32_t cells_x    = max(1u, static_cast<uint32_t>(ceilf((tile_max_x - tile_min_x) / cell_size)));
+            const uint32_t cells_z    = max(1u, static_cast<uint32_t>(ceilf((tile_max_z - tile_min_z) / cell_size)));
+            const uint32_t cell_count = cells_x * cells_z;
+            auto get_cell = [&](const Vector3& position)
+            {
+                uint32_t x = min(cells_x - 1, static_cast<uint32_t>(max(0.0f, (position.x - tile_min_x) / cell_size)));
+                uint32_t z = min(cells_z - 1, static_cast<uint32_t>(max(0.0f, (position.z - tile_min_z) / cell_size)));
+                return z * cells_x + x;
+            };
+
+            // build one instance, with the slope adjusted scale and the entity compensation
+            auto make_instance = [&](const TriangleData& tri, const Vector3& position, mt19937& generator)
+            {
+                uniform_real_distribution<float> angle_dist(0.0f, pi_2);
+                uniform_real_distribution<float> scale_dist(prop_desc.min_scale, prop_desc.max_scale);
+
+                const Vector3 normal = get_normal(tri);
+                float yaw            = angle_dist(generator);
+                float scale          = scale_dist(generator);
+                if (prop_desc.scale_adjust_by_slope)
+                {
+                    float slope_normalized = clamp(acosf(clamp(normal.y, -1.0f, 1.0f)) / prop_desc.max_slope_angle_rad, 0.0f, 1.0f);
+                    scale *= lerp(1.0f, prop_desc.max_scale / prop_desc.min_scale, slope_normalized);
+                }
+
+                Instance instance;
+                instance.Set(
+                    (position + Vector3(0.0f, prop_desc.surface_offset, 0.0f)) * scale_compensation,
+                    prop_desc.align_to_surface_normal ? normal : Vector3::Up,
+                    yaw,
+                    scale * scale_compensation
+                );
+                return instance;
+            };
+
             // compute instance count based on density
             uint32_t adjusted_count = static_cast<uint32_t>(density_fraction * static_cast<float>(acceptable_triangles.size()) + 0.5f);
-            transforms_out.resize(adjusted_count);
             if (adjusted_count == 0)
                 return;
 
+            vector<Instance> instances;
+
+            // scattered props, every cell gets its share of the instances on its own triangles
+            if (prop_desc.instances_per_cluster <= 1)
+            {
+                vector<uint32_t> cell_offsets(cell_count + 1, 0);
+                for (uint32_t tri_idx : acceptable_triangles)
+                {
+                    cell_offsets[get_cell(get_centroid(tile_triangle_data[tri_idx])) + 1]++;
+                }
+                for (uint32_t cell = 0; cell < cell_count; cell++)
+                {
+                    cell_offsets[cell + 1] += cell_offsets[cell];
+                }
+
+                vector<uint32_t> cell_triangles(acceptable_triangles.size());
+                {
+                    vector<uint32_t> cursors(cell_offsets.begin(), cell_offsets.end() - 1);
+                    for (uint32_t tri_idx : acceptable_triangles)
+                    {
+                        cell_triangles[cursors[get_cell(get_centroid(tile_triangle_data[tri_idx]))]++] = tri_idx;
+                    }
+                }
+                acceptable_triangles = {};
+
+                for (uint32_t cell = 0; cell < cell_count; cell++)
+                {
+                    // a running rounding keeps the total at what it would be for the whole tile
+                    const uint32_t begin = static_cast<uint32_t>(density_fraction * static_cast<float>(cell_offsets[cell]) + 0.5f);
+                    const uint32_t end   = static_cast<uint32_t>(density_fraction * static_cast<float>(cell_offsets[cell + 1]) + 0.5f);
+                    if (begin == end)
+                        continue;
+
+                    mt19937 generator(tile_index * 1000003u + cell * 31u + 12345u);
+                    uniform_int_distribution<uint32_t> triangle_dist(cell_offsets[cell], cell_offsets[cell + 1] - 1);
+                    uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+                    instances.resize(end - begin);
+                    for (Instance& instance : instances)
+                    {
+                        const TriangleData& tri = tile_triangle_data[cell_triangles[triangle_dist(generator)]];
+                        instance                = make_instance(tri, get_random_point(tri, generator, dist), generator);
+                    }
+
+                    on_cell(instances);
+                }
+
+                return;
+            }
+
+            // clustered props
+            uint32_t cluster_count              = max(1u, adjusted_count / prop_desc.instances_per_cluster);
+            uint32_t base_instances_per_cluster = adjusted_count / cluster_count;
+            uint32_t remainder_instances        = adjusted_count % cluster_count;
+
             // setup cluster parameters
             float safe_min_x   = tile_min_x + prop_desc.cluster_radius;
             float safe_max_x   = tile_max_x - prop_desc.cluster_radius;
@@ -196,15 +265,6 @@ namespace spartan
             float safe_max_z   = tile_max_z - prop_desc.cluster_radius;
             bool has_safe_zone = (safe_min_x < safe_max_x) && (safe_min_z < safe_max_z);
 
-            uint32_t cluster_count              = adjusted_count;
-            uint32_t base_instances_per_cluster = 1;
-            uint32_t remainder_instances        = 0;
-            if (prop_desc.instances_per_cluster > 1)
-            {
-                cluster_count              = max(1u, adjusted_count / prop_desc.instances_per_cluster);
-                base_instances_per_cluster = adjusted_count / cluster_count;
-                remainder_instances        = adjusted_count % cluster_count;
-            }
             vector<ClusterData> clusters(cluster_count);
 
             // place cluster centers
@@ -224,15 +284,8 @@ namespace spartan
                     
                     do
                     {
-                        tri_idx           = acceptable_triangles[triangle_dist(generator)];
-                        TriangleData& tri = tile_triangle_data[tri_idx];
-
-                        float r1      = dist(generator);
-                        float r2      = dist(generator);
-                        float sqrt_r1 = sqrtf(r1);
-                        float u       = 1.0f - sqrt_r1;
-                        float v       = r2 * sqrt_r1;
-                        position      = tri.v0 + u * tri.v1_minus_v0 + v * tri.v2_minus_v0 + Vector3(0.0f, prop_desc.surface_offset, 0.0f);
+                        tri_idx  = acceptable_triangles[triangle_dist(generator)];
+                        position = get_random_point(tile_triangle_data[tri_idx], generator, dist) + Vector3(0.0f, prop_desc.surface_offset, 0.0f);
                         attempts++;
                         
                         if (!has_safe_zone || prop_desc.cluster_radius <= 0.0f)
@@ -248,13 +301,12 @@ namespace spartan
             ThreadPool::ParallelLoop(place_cluster, cluster_count);
 
             // build spatial grid for nearby triangle lookup
-            vector<vector<uint32_t>> cluster_nearby_tris(cluster_count);
             const float max_effective_radius = prop_desc.cluster_radius * 1.6f;
-            const float cell_size            = max(max_effective_radius, 1.0f);
+            const float grid_cell_size       = max(max_effective_radius, 1.0f);
             
-            int32_t grid_min_x  = static_cast<int32_t>(floorf(tile_min_x / cell_size));
-            int32_t grid_min_z  = static_cast<int32_t>(floorf(tile_min_z / cell_size));
-            int32_t grid_max_x  = static_cast<int32_t>(floorf(tile_max_x / cell_size));
+            int32_t grid_min_x  = static_cast<int32_t>(floorf(tile_min_x / grid_cell_size));
+            int32_t grid_min_z  = static_cast<int32_t>(floorf(tile_min_z / grid_cell_size));
+            int32_t grid_max_x  = static_cast<int32_t>(floorf(tile_max_x / grid_cell_size));
             int32_t grid_width  = grid_max_x - grid_min_x + 1;
             
             unordered_map<int64_t, vector<uint32_t>> spatial_grid;
@@ -262,187 +314,169 @@ namespace spartan
             {
                 for (uint32_t t = 0; t < static_cast<uint32_t>(acceptable_triangles.size()); t++)
                 {
-                    uint32_t tri_idx  = acceptable_triangles[t];
-                    TriangleData& tri = tile_triangle_data[tri_idx];
-                    int32_t cell_x    = static_cast<int32_t>(floorf(tri.centroid.x / cell_size)) - grid_min_x;
-                    int32_t cell_z    = static_cast<int32_t>(floorf(tri.centroid.z / cell_size)) - grid_min_z;
-                    int64_t cell_key  = static_cast<int64_t>(cell_z) * grid_width + cell_x;
+                    const Vector3 centroid = get_centroid(tile_triangle_data[acceptable_triangles[t]]);
+                    int32_t cell_x         = static_cast<int32_t>(floorf(centroid.x / grid_cell_size)) - grid_min_x;
+                    int32_t cell_z         = static_cast<int32_t>(floorf(centroid.z / grid_cell_size)) - grid_min_z;
+                    int64_t cell_key       = static_cast<int64_t>(cell_z) * grid_width + cell_x;
                     spatial_grid[cell_key].push_back(t);
                 }
             }
             
             // find triangles within cluster radius using organic noise shape
-            auto compute_nearby = [&](uint32_t start_index, uint32_t end_index)
+            auto compute_nearby = [&](const ClusterData& cl, vector<uint32_t>& nearby)
             {
-                for (uint32_t c = start_index; c < end_index; c++)
+                nearby.clear();
+                Vector2 cl_xz(cl.center_position.x, cl.center_position.z);
+                
+                if (prop_desc.cluster_radius <= 0.0f)
                 {
-                    auto& nearby    = cluster_nearby_tris[c];
-                    ClusterData& cl = clusters[c];
-                    Vector2 cl_xz(cl.center_position.x, cl.center_position.z);
-                    
-                    if (prop_desc.cluster_radius <= 0.0f)
-                    {
-                        nearby.push_back(cl.center_tri_idx);
-                        continue;
-                    }
-                    
-                    // generate noise parameters from cluster position
-                    float seed1 = (cl.center_position.x * 12.9898f + cl.center_position.z * 78.233f) * 43758.5453f;
-                    float seed2 = (cl.center_position.x * 39.346f + cl.center_position.z * 11.135f) * 23421.631f;
-                    float seed3 = (cl.center_position.z * 47.134f + cl.center_position.x * 93.271f) * 67823.183f;
-                    seed1 -= floorf(seed1);
-                    seed2 -= floorf(seed2);
-                    seed3 -= floorf(seed3);
-                    
-                    float freq1  = 2.3f + seed1 * 1.4f;
-                    float freq2  = 3.7f + seed2 * 2.1f;
-                    float freq3  = 5.1f + seed3 * 2.8f;
-                    float freq4  = 1.7f + seed1 * 0.8f;
-                    float freq5  = 7.3f + seed2 * 3.2f;
-                    float phase1 = seed1 * pi_2;
-                    float phase2 = seed2 * pi_2;
-                    float phase3 = seed3 * pi_2;
-                    float phase4 = (seed1 + seed2) * pi;
-                    float phase5 = (seed2 + seed3) * pi;
-                    
-                    // query nearby grid cells
-                    float max_radius   = prop_desc.cluster_radius * 1.6f;
-                    int32_t cell_x     = static_cast<int32_t>(floorf(cl_xz.x / cell_size)) - grid_min_x;
-                    int32_t cell_z     = static_cast<int32_t>(floorf(cl_xz.y / cell_size)) - grid_min_z;
-                    int32_t cell_range = static_cast<int32_t>(ceilf(max_radius / cell_size));
-                    
-                    for (int32_t dz = -cell_range; dz <= cell_range; dz++)
+                    nearby.push_back(cl.center_tri_idx);
+                    return;
+                }
+                
+                // generate noise parameters from cluster position
+                float seed1 = (cl.center_position.x * 12.9898f + cl.center_position.z * 78.233f) * 43758.5453f;
+                float seed2 = (cl.center_position.x * 39.346f + cl.center_position.z * 11.135f) * 23421.631f;
+                float seed3 = (cl.center_position.z * 47.134f + cl.center_position.x * 93.271f) * 67823.183f;
+                seed1 -= floorf(seed1);
+                seed2 -= floorf(seed2);
+                seed3 -= floorf(seed3);
+                
+                float freq1  = 2.3f + seed1 * 1.4f;
+                float freq2  = 3.7f + seed2 * 2.1f;
+                float freq3  = 5.1f + seed3 * 2.8f;
+                float freq4  = 1.7f + seed1 * 0.8f;
+                float freq5  = 7.3f + seed2 * 3.2f;
+                float phase1 = seed1 * pi_2;
+                float phase2 = seed2 * pi_2;
+                float phase3 = seed3 * pi_2;
+                float phase4 = (seed1 + seed2) * pi;
+                float phase5 = (seed2 + seed3) * pi;
+                
+                // query nearby grid cells
+                float max_radius   = prop_desc.cluster_radius * 1.6f;
+                int32_t cell_x     = static_cast<int32_t>(floorf(cl_xz.x / grid_cell_size)) - grid_min_x;
+                int32_t cell_z     = static_cast<int32_t>(floorf(cl_xz.y / grid_cell_size)) - grid_min_z;
+                int32_t cell_range = static_cast<int32_t>(ceilf(max_radius / grid_cell_size));
+                
+                for (int32_t dz = -cell_range; dz <= cell_range; dz++)
+                {
+                    for (int32_t dx = -cell_range; dx <= cell_range; dx++)
                     {
-                        for (int32_t dx = -cell_range; dx <= cell_range; dx++)
+                        int64_t cell_key = static_cast<int64_t>(cell_z + dz) * grid_width + (cell_x + dx);
+                        auto grid_it     = spatial_grid.find(cell_key);
+                        if (grid_it == spatial_grid.end())
+                            continue;
+                        
+                        for (uint32_t t : grid_it->second)
                         {
-                            int64_t cell_key = static_cast<int64_t>(cell_z + dz) * grid_width + (cell_x + dx);
-                            auto grid_it     = spatial_grid.find(cell_key);
-                            if (grid_it == spatial_grid.end())
-                                continue;
+                            uint32_t tri_idx       = acceptable_triangles[t];
+                            const Vector3 centroid = get_centroid(tile_triangle_data[tri_idx]);
+                            Vector2 tri_xz(centroid.x, centroid.z);
+                            Vector2 offset  = tri_xz - cl_xz;
+                            float dist_sq   = offset.LengthSquared();
+                            float dist      = sqrtf(dist_sq);
+                            float angle     = atan2f(offset.y, offset.x);
+                            float norm_dist = dist / prop_desc.cluster_radius;
                             
-                            for (uint32_t t : grid_it->second)
-                            {
-                                uint32_t tri_idx  = acceptable_triangles[t];
-                                TriangleData& tri = tile_triangle_data[tri_idx];
-                                Vector2 tri_xz(tri.centroid.x, tri.centroid.z);
-                                Vector2 offset  = tri_xz - cl_xz;
-                                float dist_sq   = offset.LengthSquared();
-                                float dist      = sqrtf(dist_sq);
-                                float angle     = atan2f(offset.y, offset.x);
-                                float norm_dist = dist / prop_desc.cluster_radius;
-                                
-                                // layered noise for organic blob shape
-                                float noise1     = sinf(angle * freq1 + phase1) * 0.18f;
-                                float noise2     = sinf(angle * freq2 + phase2) * 0.14f;
-                                float noise3     = sinf(angle * freq3 + phase3) * 0.10f;
-                                float noise4     = cosf(angle * freq4 + phase4) * 0.20f;
-                                float noise5     = sinf(angle * freq5 + phase5) * 0.06f;
-                                float dist_noise = sinf(norm_dist * 3.14159f + seed1 * 6.28f) * 0.12f * norm_dist;
-                                float pos_noise  = sinf(offset.x * 0.3f + seed2 * 10.0f) * cosf(offset.y * 0.3f + seed3 * 10.0f) * 0.08f;
-                                
-                                float radius_variation = 1.0f + noise1 + noise2 + noise3 + noise4 + noise5 + dist_noise + pos_noise;
-                                radius_variation       = fmaxf(0.4f, fminf(1.6f, radius_variation));
-                                
-                                float effective_radius = prop_desc.cluster_radius * radius_variation;
-                                if (dist_sq <= effective_radius * effective_radius)
-                                    nearby.push_back(tri_idx);
-                            }
+                            // layered noise for organic blob shape
+                            float noise1     = sinf(angle * freq1 + phase1) * 0.18f;
+                            float noise2     = sinf(angle * freq2 + phase2) * 0.14f;
+                            float noise3     = sinf(angle * freq3 + phase3) * 0.10f;
+                            float noise4     = cosf(angle * freq4 + phase4) * 0.20f;
+                            float noise5     = sinf(angle * freq5 + phase5) * 0.06f;
+                            float dist_noise = sinf(norm_dist * 3.14159f + seed1 * 6.28f) * 0.12f * norm_dist;
+                            float pos_noise  = sinf(offset.x * 0.3f + seed2 * 10.0f) * cosf(offset.y * 0.3f + seed3 * 10.0f) * 0.08f;
+                            
+                            float radius_variation = 1.0f + noise1 + noise2 + noise3 + noise4 + noise5 + dist_noise + pos_noise;
+                            radius_variation       = fmaxf(0.4f, fminf(1.6f, radius_variation));
+                            
+                            float effective_radius = prop_desc.cluster_radius * radius_variation;
+                            if (dist_sq <= effective_radius * effective_radius)
+                                nearby.push_back(tri_idx);
                         }
                     }
-                    
-                    if (nearby.empty())
-                        nearby.push_back(cl.center_tri_idx);
                 }
+                
+                if (nearby.empty())
+                    nearby.push_back(cl.center_tri_idx);
             };
-            ThreadPool::ParallelLoop(compute_nearby, cluster_count);
+
+            // clusters go out with the cell their center is in
+            vector<uint32_t> cluster_offsets(cell_count + 1, 0);
+            for (const ClusterData& cl : clusters)
+            {
+                cluster_offsets[get_cell(cl.center_position) + 1]++;
+            }
+            for (uint32_t cell = 0; cell < cell_count; cell++)
+            {
+                cluster_offsets[cell + 1] += cluster_offsets[cell];
+            }
+            vector<uint32_t> cell_clusters(cluster_count);
+            {
+                vector<uint32_t> cursors(cluster_offsets.begin(), cluster_offsets.end() - 1);
+                for (uint32_t c = 0; c < cluster_count; c++)
+                {
+                    cell_clusters[cursors[get_cell(clusters[c].center_position)]++] = c;
+                }
+            }
 
             // place instances within clusters
-            auto place_mesh = [&](uint32_t start_index, uint32_t end_index)
+            vector<uint32_t> nearby;
+            for (uint32_t cell = 0; cell < cell_count; cell++)
             {
-                mt19937 generator(tile_index * 2000003u + start_index * 37u + 67890u);
-                uniform_real_distribution<float> dist(0.0f, 1.0f);
-                uniform_real_distribution<float> angle_dist(0.0f, 360.0f);
-                uniform_real_distribution<float> scale_dist(prop_desc.min_scale, prop_desc.max_scale);
-                uint32_t larger_cluster_size = base_instances_per_cluster + 1;
-                
-                for (uint32_t i = start_index; i < end_index; i++)
+                if (cluster_offsets[cell] == cluster_offsets[cell + 1])
+                    continue;
+
+                instances.clear();
+                for (uint32_t k = cluster_offsets[cell]; k < cluster_offsets[cell + 1]; k++)
                 {
-                    // map instance to cluster
-                    uint32_t cluster_idx;
-                    if (i < remainder_instances * larger_cluster_size)
-                        cluster_idx = i / larger_cluster_size;
-                    else
-                        cluster_idx = remainder_instances + (i - remainder_instances * larger_cluster_size) / base_instances_per_cluster;
-                    
-                    auto& nearby = cluster_nearby_tris[cluster_idx];
-                    if (nearby.empty())
-                        continue;
+                    const uint32_t cluster_idx = cell_clusters[k];
+                    compute_nearby(clusters[cluster_idx], nearby);
 
-                    uniform_int_distribution<int> nearby_dist(0, static_cast<int>(nearby.size()) - 1);
-                    uint32_t tri_idx  = nearby[nearby_dist(generator)];
-                    TriangleData& tri = tile_triangle_data[tri_idx];
-
-                    // random position within triangle
-                    float r1      = dist(generator);
-                    float r2      = dist(generator);
-                    float sqrt_r1 = sqrtf(r1);
-                    float u       = 1.0f - sqrt_r1;
-                    float v       = r2 * sqrt_r1;
-                    Vector3 position = tri.v0 + u * tri.v1_minus_v0 + v * tri.v2_minus_v0 + Vector3(0.0f, prop_desc.surface_offset, 0.0f);
-
-                    // rotation
-                    Quaternion rotation;
-                    if (prop_desc.align_to_surface_normal)
-                    {
-                        Quaternion random_y_rotation = Quaternion::FromEulerAngles(0.0f, angle_dist(generator), 0.0f);
-                        rotation = tri.rotation_to_normal * random_y_rotation;
-                    }
-                    else
-                    {
-                        rotation = Quaternion::FromEulerAngles(0.0f, angle_dist(generator), 0.0f);
-                    }
+                    mt19937 generator(tile_index * 2000003u + cluster_idx * 37u + 67890u);
+                    uniform_int_distribution<size_t> nearby_dist(0, nearby.size() - 1);
+                    uniform_real_distribution<float> dist(0.0f, 1.0f);
 
-                    // scale with optional slope adjustment
-                    float scale = scale_dist(generator);
-                    if (prop_desc.scale_adjust_by_slope)
+                    const uint32_t count = base_instances_per_cluster + (cluster_idx < remainder_instances ? 1 : 0);
+                    for (uint32_t i = 0; i < count; i++)
                     {
-                        float slope_normalized = clamp(tri.slope_radians / prop_desc.max_slope_angle_rad, 0.0f, 1.0f);
-                        scale *= lerp(1.0f, prop_desc.max_scale / prop_desc.min_scale, slope_normalized);
+                        const TriangleData& tri = tile_triangle_data[nearby[nearby_dist(generator)]];
+                        instances.push_back(make_instance(tri, get_random_point(tri, generator, dist), generator));
                     }
-                    
-                    transforms_out[i] = Matrix::CreateScale(scale) * Matrix::CreateRotation(rotation) * Matrix::CreateTranslation(position);
                 }
-            };
-            ThreadPool::ParallelLoop(place_mesh, adjusted_count);
+
+                on_cell(instances);
+            }
         }
     }
 
     namespace
     {
-        float compute_surface_area_km2(const vector<RHI_Vertex_PosTexNorTan>& vertices, const vector<uint32_t>& indices)
+        float compute_surface_area_km2(const vector<Vector3>& positions, uint32_t width, uint32_t height)
         {
-            uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
-            vector<float> partial_areas(triangle_count);
+            // two triangles per grid cell, split the same way the mesh is
+            uint32_t quad_count = (width - 1) * (height - 1);
+            vector<float> partial_areas(quad_count);
             
-            auto compute_areas = [&](uint32_t start_tri, uint32_t end_tri)
+            auto triangle_area = [](const Vector3& v0, const Vector3& v1, const Vector3& v2)
+            {
+                return 0.5f * Vector3::Cross(v1 - v0, v2 - v0).Length();
+            };
+
+            auto compute_areas = [&](uint32_t start_quad, uint32_t end_quad)
             {
-                for (uint32_t t = start_tri; t < end_tri; t++)
+                for (uint32_t quad = start_quad; quad < end_quad; quad++)
                 {
-                    size_t i        = static_cast<size_t>(t) * 3;
-                    const auto& v0  = vertices[indices[i + 0]].pos;
-                    const auto& v1  = vertices[indices[i + 1]].pos;
-                    const auto& v2  = vertices[indices[i + 2]].pos;
-                    
-                    float e1x = v1[0] - v0[0], e1y = v1[1] - v0[1], e1z = v1[2] - v0[2];
-                    float e2x = v2[0] - v0[0], e2y = v2[1] - v0[1], e2z = v2[2] - v0[2];
-                    float cx  = e1y * e2z - e1z * e2y;
-                    float cy  = e1z * e2x - e1x * e2z;
-                    float cz  = e1x * e2y - e1y * e2x;
-                    
-                    partial_areas[t] = 0.5f * sqrtf(cx * cx + cy * cy + cz * cz);
+                    uint32_t bl = (quad / (width - 1)) * width + quad % (width - 1);
+                    uint32_t br = bl + 1;
+                    uint32_t tl = bl + width;
+                    uint32_t tr = tl + 1;
+
+                    partial_areas[quad] = triangle_area(positions[br], positions[bl], positions[tl]) + triangle_area(positions[br], positions[tl], positions[tr]);
                 }
             };
-            ThreadPool::ParallelLoop(compute_areas, triangle_count);
+            ThreadPool::ParallelLoop(compute_areas, quad_count);
             
             float area_m2 = 0.0f;
             for (float a : partial_areas)
@@ -738,18 +772,8 @@ namespace spartan
                 );
             };
         
-            mt19937 gen(width * 3000017u + height * 41u + 11111u);
-            uniform_real_distribution<float> dist_x(1.0f, static_cast<float>(width) - 2.0f);
-            uniform_real_distribution<float> dist_z(1.0f, static_cast<float>(height) - 2.0f);
-        
-            // hydraulic erosion simulation
-            for (uint32_t i = 0; i < iterations; ++i)
+            auto simulate_droplet = [&](float pos_x, float pos_z)
             {
-                if (i % wind_interval == 0 && i != 0)
-                    apply_wind_erosion(positions, width, height, wind_strength);
-        
-                float pos_x    = dist_x(gen);
-                float pos_z    = dist_z(gen);
                 Vector2 dir    = Vector2::Zero;
                 float speed    = 1.0f;
                 float water    = 1.0f;
@@ -799,144 +823,94 @@ namespace spartan
         
                     water *= (1.0f - evaporation_rate);
                 }
-            }
-        
-            apply_wind_erosion(positions, width, height, wind_strength);
-        }
-
-        void generate_vertices_and_indices(vector<RHI_Vertex_PosTexNorTan>& vertices, vector<uint32_t>& indices, const vector<Vector3>& positions, uint32_t width, uint32_t height)
-        {
-            SP_ASSERT_MSG(!positions.empty(), "positions are empty");
-
-            const float inv_width  = 1.0f / static_cast<float>(width - 1);
-            const float inv_height = 1.0f / static_cast<float>(height - 1);
-            
-            auto gen_vertices = [&](uint32_t start_idx, uint32_t end_idx)
-            {
-                for (uint32_t idx = start_idx; idx < end_idx; idx++)
-                {
-                    uint32_t x   = idx % width;
-                    uint32_t y   = idx / width;
-                    vertices[idx] = RHI_Vertex_PosTexNorTan(positions[idx], Vector2(x * inv_width, y * inv_height));
-                }
             };
-            ThreadPool::ParallelLoop(gen_vertices, width * height);
-            
-            uint32_t quad_count = (width - 1) * (height - 1);
-            auto gen_indices = [&](uint32_t start_quad, uint32_t end_quad)
+
+            // a droplet moves at most one cell per step and samples one cell further for the gradient, so it can't touch
+            // anything more than max_steps + 2 cells away from where it starts, tiles twice that wide which share a color
+            // in a 2x2 checkerboard are then independent and each color can run its tiles in parallel with no races
+            const uint32_t reach        = max_steps + 2;
+            const uint32_t tile_size    = 2 * reach + 2;
+            const uint32_t tiles_x      = (width + tile_size - 1) / tile_size;
+            const uint32_t tiles_z      = (height + tile_size - 1) / tile_size;
+            const uint32_t tile_count   = tiles_x * tiles_z;
+            const float spawn_min       = 1.0f;
+            const float spawn_max_x     = static_cast<float>(width) - 2.0f;
+            const float spawn_max_z     = static_cast<float>(height) - 2.0f;
+
+            // the spawn rectangle of a tile, clipped to where droplets could spawn before
+            auto get_tile_spawn_rect = [&](uint32_t tile, float& x0, float& x1, float& z0, float& z1)
             {
-                for (uint32_t quad = start_quad; quad < end_quad; quad++)
-                {
-                    uint32_t x  = quad % (width - 1);
-                    uint32_t y  = quad / (width - 1);
-                    uint32_t k  = quad * 6;
-                    uint32_t bl = y * width + x;
-                    uint32_t br = bl + 1;
-                    uint32_t tl = bl + width;
-                    uint32_t tr = tl + 1;
-                    
-                    indices[k]     = br;
-                    indices[k + 1] = bl;
-                    indices[k + 2] = tl;
-                    indices[k + 3] = br;
-                    indices[k + 4] = tl;
-                    indices[k + 5] = tr;
-                }
+                x0 = max(spawn_min,   static_cast<float>((tile % tiles_x) * tile_size));
+                x1 = min(spawn_max_x, static_cast<float>((tile % tiles_x + 1) * tile_size));
+                z0 = max(spawn_min,   static_cast<float>((tile / tiles_x) * tile_size));
+                z1 = min(spawn_max_z, static_cast<float>((tile / tiles_x + 1) * tile_size));
             };
-            ThreadPool::ParallelLoop(gen_indices, quad_count);
-        }
 
-        void generate_normals(vector<RHI_Vertex_PosTexNorTan>& vertices, uint32_t width, uint32_t height)
-        {
-            SP_ASSERT_MSG(!vertices.empty(), "vertices are empty");
-        
-            // interior vertices - no boundary checks needed
-            uint32_t interior_count = (width - 2) * (height - 2);
-            if (interior_count > 0)
+            // droplets are spread over the tiles by area, the running sum keeps the total exact
+            vector<uint64_t> tile_area_prefix(tile_count + 1, 0);
+            for (uint32_t tile = 0; tile < tile_count; tile++)
             {
-                auto compute_interior = [&](uint32_t start, uint32_t end)
-                {
-                    for (uint32_t index = start; index < end; index++)
-                    {
-                        uint32_t interior_width = width - 2;
-                        uint32_t i              = (index % interior_width) + 1;
-                        uint32_t j              = (index / interior_width) + 1;
-                        uint32_t vertex_idx     = j * width + i;
-                        
-                        float h_left   = vertices[vertex_idx - 1].pos[1];
-                        float h_right  = vertices[vertex_idx + 1].pos[1];
-                        float h_bottom = vertices[vertex_idx - width].pos[1];
-                        float h_top    = vertices[vertex_idx + width].pos[1];
-                        
-                        float dh_dx = (h_right - h_left) * 0.5f;
-                        float dh_dz = (h_top - h_bottom) * 0.5f;
-                        
-                        float nx      = -dh_dx, ny = 1.0f, nz = -dh_dz;
-                        float inv_len = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
-                        nx *= inv_len; ny *= inv_len; nz *= inv_len;
-                        vertices[vertex_idx].nor[0] = nx;
-                        vertices[vertex_idx].nor[1] = ny;
-                        vertices[vertex_idx].nor[2] = nz;
-                        
-                        float proj      = nx;
-                        float tx        = 1.0f - nx * proj, ty = -ny * proj, tz = -nz * proj;
-                        float t_inv_len = 1.0f / sqrtf(tx * tx + ty * ty + tz * tz);
-                        vertices[vertex_idx].tan[0] = tx * t_inv_len;
-                        vertices[vertex_idx].tan[1] = ty * t_inv_len;
-                        vertices[vertex_idx].tan[2] = tz * t_inv_len;
-                    }
-                };
-                ThreadPool::ParallelLoop(compute_interior, interior_count);
+                float x0, x1, z0, z1;
+                get_tile_spawn_rect(tile, x0, x1, z0, z1);
+                const double area          = (x1 > x0 && z1 > z0) ? static_cast<double>(x1 - x0) * static_cast<double>(z1 - z0) : 0.0;
+                tile_area_prefix[tile + 1] = tile_area_prefix[tile] + static_cast<uint64_t>(area * 256.0);
             }
-            
-            // edge vertices with boundary handling
-            uint32_t edge_count = 2 * width + 2 * (height - 2);
-            auto compute_edges = [&](uint32_t start, uint32_t end)
+
+            // every tile gets its own generator seeded from the pass and its index, so the result only depends on the
+            // dimensions and not on the thread count or on which thread ran what
+            const uint32_t seed = width * 3000017u + height * 41u + 11111u;
+
+            // hydraulic erosion simulation, in passes between the wind erosion
+            const uint32_t pass_count = max(1u, (iterations + wind_interval - 1) / wind_interval);
+            for (uint32_t pass = 0; pass < pass_count; pass++)
             {
-                for (uint32_t edge_idx = start; edge_idx < end; edge_idx++)
+                if (pass != 0)
+                    apply_wind_erosion(positions, width, height, wind_strength);
+
+                const uint64_t droplets = min(wind_interval, iterations - pass * wind_interval);
+                const uint64_t area_sum = max<uint64_t>(tile_area_prefix[tile_count], 1);
+
+                for (uint32_t color = 0; color < 4; color++)
                 {
-                    uint32_t i, j;
-                    uint32_t perimeter = 2 * width + 2 * (height - 2);
-                    
-                    if (edge_idx < width)
-                        { i = edge_idx; j = 0; }
-                    else if (edge_idx < width + height - 1)
-                        { i = width - 1; j = edge_idx - width + 1; }
-                    else if (edge_idx < 2 * width + height - 2)
-                        { i = 2 * width + height - 3 - edge_idx; j = height - 1; }
-                    else
-                        { i = 0; j = perimeter - edge_idx; }
-                    
-                    uint32_t index   = j * width + i;
-                    uint32_t i_left  = (i > 0) ? i - 1 : i;
-                    uint32_t i_right = (i < width - 1) ? i + 1 : i;
-                    uint32_t j_bot   = (j > 0) ? j - 1 : j;
-                    uint32_t j_top   = (j < height - 1) ? j + 1 : j;
-                    
-                    float h_left  = vertices[j * width + i_left].pos[1];
-                    float h_right = vertices[j * width + i_right].pos[1];
-                    float h_bot   = vertices[j_bot * width + i].pos[1];
-                    float h_top   = vertices[j_top * width + i].pos[1];
-                    
-                    float dh_dx = (h_right - h_left) / ((i_right != i_left) ? static_cast<float>(i_right - i_left) : 1.0f);
-                    float dh_dz = (h_top - h_bot) / ((j_top != j_bot) ? static_cast<float>(j_top - j_bot) : 1.0f);
-                    
-                    float nx      = -dh_dx, ny = 1.0f, nz = -dh_dz;
-                    float inv_len = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
-                    nx *= inv_len; ny *= inv_len; nz *= inv_len;
-                    vertices[index].nor[0] = nx;
-                    vertices[index].nor[1] = ny;
-                    vertices[index].nor[2] = nz;
-                    
-                    float proj      = nx;
-                    float tx        = 1.0f - nx * proj, ty = -ny * proj, tz = -nz * proj;
-                    float t_inv_len = 1.0f / sqrtf(tx * tx + ty * ty + tz * tz);
-                    vertices[index].tan[0] = tx * t_inv_len;
-                    vertices[index].tan[1] = ty * t_inv_len;
-                    vertices[index].tan[2] = tz * t_inv_len;
+                    const uint32_t color_x       = color % 2;
+                    const uint32_t color_z       = color / 2;
+                    const uint32_t color_tiles_x = (tiles_x - color_x + 1) / 2;
+                    const uint32_t color_tiles_z = (tiles_z - color_z + 1) / 2;
+                    const uint32_t color_tiles   = color_tiles_x * color_tiles_z;
+                    if (color_tiles == 0)
+                        continue;
+
+                    auto erode_tiles = [&](uint32_t start_index, uint32_t end_index)
+                    {
+                        for (uint32_t i = start_index; i < end_index; i++)
+                        {
+                            const uint32_t tile = (color_z + (i / color_tiles_x) * 2) * tiles_x + color_x + (i % color_tiles_x) * 2;
+
+                            const uint64_t droplet_begin = droplets * tile_area_prefix[tile] / area_sum;
+                            const uint64_t droplet_end   = droplets * tile_area_prefix[tile + 1] / area_sum;
+                            if (droplet_begin == droplet_end)
+                                continue;
+
+                            float x0, x1, z0, z1;
+                            get_tile_spawn_rect(tile, x0, x1, z0, z1);
+
+                            mt19937 gen(seed + pass * 2654435761u + tile * 40503u);
+                            uniform_real_distribution<float> dist_x(x0, x1);
+                            uniform_real_distribution<float> dist_z(z0, z1);
+                            for (uint64_t droplet = droplet_begin; droplet < droplet_end; droplet++)
+                            {
+                                float pos_x = dist_x(gen);
+                                float pos_z = dist_z(gen);
+                                simulate_droplet(pos_x, pos_z);
+                            }
+                        }
+                    };
+
+                    ThreadPool::ParallelLoop(erode_tiles, color_tiles);
                 }
-            };
-            ThreadPool::ParallelLoop(compute_edges, edge_count);
+            }
+        
+            apply_wind_erosion(positions, width, height, wind_strength);
         }
 
         void apply_perlin_noise(vector<Vector3>& positions, uint32_t width, uint32_t height, float amplitude = 5.0f, float frequency = 0.01f, uint32_t octaves = 4, float persistence = 1.0f)
@@ -1018,85 +992,603 @@ namespace spartan
         
             ThreadPool::ParallelLoop(apply_noise, width * height);
         }
-    }
-
-    Terrain::Terrain(Entity* entity) : Component(entity)
-    {
-        m_material = make_shared<Material>();
-        m_material->SetObjectName("terrain");
-    }
-
-    Terrain::~Terrain()
-    {
-        m_height_map_seed = nullptr;
-    }
 
-    void Terrain::Save(pugi::xml_node& node)
-    {
-        // height map seed texture path
-        if (m_height_map_seed)
+        void heights_to_positions(const vector<float>& heights, vector<Vector3>& positions, uint32_t width, uint32_t height, uint32_t density, uint32_t scale)
         {
-            node.append_attribute("height_map_path") = m_height_map_seed->GetResourceFilePath().c_str();
+            positions.resize(width * height);
+            generate_positions(positions, heights, width, height, density, scale);
         }
 
-        // configurable parameters
-        node.append_attribute("min_y")         = m_min_y;
-        node.append_attribute("max_y")         = m_max_y;
-        node.append_attribute("level_sea")     = m_level_sea;
-        node.append_attribute("level_snow")    = m_level_snow;
-        node.append_attribute("smoothing")     = m_smoothing;
-        node.append_attribute("density")       = m_density;
-        node.append_attribute("scale")         = m_scale;
-        node.append_attribute("create_border") = m_create_border;
+        void positions_to_heights(const vector<Vector3>& positions, vector<float>& heights)
+        {
+            auto copy_heights = [&](uint32_t start, uint32_t end)
+            {
+                for (uint32_t i = start; i < end; i++)
+                    heights[i] = positions[i].y;
+            };
+            ThreadPool::ParallelLoop(copy_heights, static_cast<uint32_t>(positions.size()));
+        }
     }
 
-    void Terrain::Load(pugi::xml_node& node)
+    namespace tiles
     {
-        // height map seed texture
-        string height_map_path = node.attribute("height_map_path").as_string("");
-        if (!height_map_path.empty())
+        const uint32_t tiles_per_side = 16;
+
+        // where the dense grid sits in the world, matches generate_positions()
+        struct grid
         {
-            if (shared_ptr<RHI_Texture> texture = ResourceCache::Load<RHI_Texture>(height_map_path))
+            uint32_t width  = 0;
+            uint32_t height = 0;
+            float spacing_x = 0.0f;
+            float spacing_z = 0.0f;
+            float origin_x  = 0.0f;
+            float origin_z  = 0.0f;
+
+            grid(uint32_t width, uint32_t height, uint32_t density, uint32_t scale) : width(width), height(height)
             {
-                m_height_map_seed = texture.get();
+                float extent_x = static_cast<float>((width - 1) / density) * scale;
+                float extent_z = static_cast<float>((height - 1) / density) * scale;
+                spacing_x      = extent_x / static_cast<float>(width - 1);
+                spacing_z      = extent_z / static_cast<float>(height - 1);
+                origin_x       = -extent_x / 2.0f;
+                origin_z       = -extent_z / 2.0f;
             }
-        }
-
-        // configurable parameters
-        m_min_y         = node.attribute("min_y").as_float(-64.0f);
-        m_max_y         = node.attribute("max_y").as_float(256.0f);
-        m_level_sea     = node.attribute("level_sea").as_float(0.0f);
-        m_level_snow    = node.attribute("level_snow").as_float(400.0f);
-        m_smoothing     = node.attribute("smoothing").as_uint(0);
-        m_density       = node.attribute("density").as_uint(3);
-        m_scale         = node.attribute("scale").as_uint(6);
-        m_create_border = node.attribute("create_border").as_bool(true);
+        };
 
-        // regenerate terrain if we have a height map
-        if (m_height_map_seed)
+        float sign_not_zero(float value)
         {
-            Generate();
+            return value >= 0.0f ? 1.0f : -1.0f;
         }
-    }
 
-    uint64_t Terrain::ComputeCacheHash() const
+        // y is up, so the octahedron is folded over the xz plane
+        uint32_t encode_octahedral(const Vector3& normal)
+        {
+            const float l1 = abs(normal.x) + abs(normal.y) + abs(normal.z);
+            float u        = normal.x / l1;
+            float v        = normal.z / l1;
+            if (normal.y < 0.0f)
+            {
+                const float u_folded = (1.0f - abs(v)) * sign_not_zero(u);
+                v                    = (1.0f - abs(u)) * sign_not_zero(v);
+                u                    = u_folded;
+            }
+
+            const int16_t u_snorm = static_cast<int16_t>(lroundf(clamp(u, -1.0f, 1.0f) * 32767.0f));
+            const int16_t v_snorm = static_cast<int16_t>(lroundf(clamp(v, -1.0f, 1.0f) * 32767.0f));
+            return static_cast<uint32_t>(static_cast<uint16_t>(u_snorm)) | (static_cast<uint32_t>(static_cast<uint16_t>(v_snorm)) << 16);
+        }
+
+        Vector3 decode_octahedral(uint32_t encoded)
+        {
+            float u       = static_cast<float>(static_cast<int16_t>(encoded & 0xFFFF)) / 32767.0f;
+            float v       = static_cast<float>(static_cast<int16_t>(encoded >> 16)) / 32767.0f;
+            const float y = 1.0f - abs(u) - abs(v);
+            if (y < 0.0f)
+            {
+                const float u_unfolded = (1.0f - abs(v)) * sign_not_zero(u);
+                v                      = (1.0f - abs(u)) * sign_not_zero(v);
+                u                      = u_unfolded;
+            }
+
+            return Vector3(u, y, v).Normalized();
+        }
+
+        // central differences in grid units, one sided on the borders
+        Vector3 compute_normal(const vector<float>& heights, uint32_t width, uint32_t height, uint32_t i, uint32_t j)
+        {
+            uint32_t i_left  = (i > 0) ? i - 1 : i;
+            uint32_t i_right = (i < width - 1) ? i + 1 : i;
+            uint32_t j_bot   = (j > 0) ? j - 1 : j;
+            uint32_t j_top   = (j < height - 1) ? j + 1 : j;
+
+            float dh_dx = (heights[j * width + i_right] - heights[j * width + i_left]) / static_cast<float>(max(i_right - i_left, 1u));
+            float dh_dz = (heights[j_top * width + i] - heights[j_bot * width + i]) / static_cast<float>(max(j_top - j_bot, 1u));
+
+            return Vector3(-dh_dx, 1.0f, -dh_dz).Normalized();
+        }
+
+        void build(const vector<float>& heights, const grid& g, vector<TerrainTile>& tiles_out, vector<Vector3>& offsets_out)
+        {
+            const uint32_t tile_count = tiles_per_side * tiles_per_side;
+            tiles_out.resize(tile_count);
+            offsets_out.resize(tile_count);
+
+            auto build_tile = [&](uint32_t start_index, uint32_t end_index)
+            {
+                for (uint32_t tile_index = start_index; tile_index < end_index; tile_index++)
+                {
+                    const uint32_t tx = tile_index % tiles_per_side;
+                    const uint32_t tz = tile_index / tiles_per_side;
+
+                    // tiles split the cells evenly and share the samples on their borders
+                    TerrainTile& tile = tiles_out[tile_index];
+                    tile.x            = tx * (g.width - 1) / tiles_per_side;
+                    tile.z            = tz * (g.height - 1) / tiles_per_side;
+                    tile.width        = (tx + 1) * (g.width - 1) / tiles_per_side - tile.x + 1;
+                    tile.height       = (tz + 1) * (g.height - 1) / tiles_per_side - tile.z + 1;
+
+                    offsets_out[tile_index] = Vector3(
+                        (tile.x + (tile.width - 1) * 0.5f) * g.spacing_x + g.origin_x,
+                        0.0f,
+                        (tile.z + (tile.height - 1) * 0.5f) * g.spacing_z + g.origin_z
+                    );
+
+                    float height_min = numeric_limits<float>::max();
+                    float height_max = numeric_limits<float>::lowest();
+                    for (uint32_t j = 0; j < tile.height; j++)
+                    {
+                        for (uint32_t i = 0; i < tile.width; i++)
+                        {
+                            const float h = heights[(tile.z + j) * g.width + tile.x + i];
+                            height_min    = min(height_min, h);
+                            height_max    = max(height_max, h);
+                        }
+                    }
+                    tile.height_min   = height_min;
+                    tile.height_range = height_max - height_min;
+
+                    const float quantize = tile.height_range > 0.0f ? 65535.0f / tile.height_range : 0.0f;
+                    tile.heights.resize(tile.width * tile.height);
+                    tile.normals.resize(tile.width * tile.height);
+                    for (uint32_t j = 0; j < tile.height; j++)
+                    {
+                        for (uint32_t i = 0; i < tile.width; i++)
+                        {
+                            const uint32_t gx    = tile.x + i;
+                            const uint32_t gz    = tile.z + j;
+                            const uint32_t index = j * tile.width + i;
+
+                            tile.heights[index] = static_cast<uint16_t>(lroundf((heights[gz * g.width + gx] - height_min) * quantize));
+                            tile.normals[index] = encode_octahedral(compute_normal(heights, g.width, g.height, gx, gz));
+                        }
+                    }
+                }
+            };
+            ThreadPool::ParallelLoop(build_tile, tile_count);
+        }
+
+        float get_height(const TerrainTile& tile, uint32_t i, uint32_t j)
+        {
+            return tile.height_min + tile.heights[j * tile.width + i] * (tile.height_range / 65535.0f);
+        }
+
+        // every lod halves the sample rate of the one before it, the last row and column are always kept so tiles stay closed
+        void get_lod_samples(uint32_t sample_count, uint32_t lod, vector<uint32_t>& samples_out)
+        {
+            const uint32_t stride = 1u << lod;
+            samples_out.clear();
+            for (uint32_t s = 0; s < sample_count - 1; s += stride)
+            {
+                samples_out.push_back(s);
+            }
+            samples_out.push_back(sample_count - 1);
+        }
+
+        uint32_t get_lod_count(const TerrainTile& tile)
+        {
+            uint32_t lod_count = 1;
+            while (lod_count < mesh_lod_count && (1u << lod_count) < max(tile.width, tile.height) - 1)
+            {
+                lod_count++;
+            }
+
+            return lod_count;
+        }
+
+        // neighbouring tiles can be at different lods (and quantize their shared border a bit differently), so every tile
+        // hangs a skirt from its border deep enough to cover the largest gap its coarsest lod can open against a finer one
+        float compute_skirt_depth(const TerrainTile& tile)
+        {
+            const uint32_t stride = 1u << (get_lod_count(tile) - 1);
+            float deviation_max   = 0.0f;
+
+            auto measure = [&](uint32_t sample_count, auto get_border_height)
+            {
+                vector<uint32_t> samples;
+                get_lod_samples(sample_count, get_lod_count(tile) - 1, samples);
+                for (size_t k = 0; k + 1 < samples.size(); k++)
+                {
+                    const float h_a = get_border_height(samples[k]);
+                    const float h_b = get_border_height(samples[k + 1]);
+                    for (uint32_t s = samples[k] + 1; s < samples[k + 1]; s++)
+                    {
+                        const float t = static_cast<float>(s - samples[k]) / static_cast<float>(samples[k + 1] - samples[k]);
+                        deviation_max = max(deviation_max, abs(get_border_height(s) - (h_a + (h_b - h_a) * t)));
+                    }
+                }
+            };
+            measure(tile.width,  [&](uint32_t s) { return get_height(tile, s, 0); });
+            measure(tile.width,  [&](uint32_t s) { return get_height(tile, s, tile.height - 1); });
+            measure(tile.height, [&](uint32_t s) { return get_height(tile, 0, s); });
+            measure(tile.height, [&](uint32_t s) { return get_height(tile, tile.width - 1, s); });
+
+            // the quantization error of two tiles plus some slack
+            return deviation_max + tile.height_range / 65535.0f * 2.0f + 0.1f * stride;
+        }
+
+        // expands a tile to the vertex format the renderer consumes, positions are relative to the tile offset
+        void expand(
+            const TerrainTile& tile,
+            const grid& g,
+            const Vector3& offset,
+            uint32_t lod,
+            float skirt_depth, // zero for no skirt
+            vector<RHI_Vertex_PosTexNorTan>& vertices,
+            vector<uint32_t>& indices
+        )
+        {
+            vector<uint32_t> columns;
+            vector<uint32_t> rows;
+            get_lod_samples(tile.width, lod, columns);
+            get_lod_samples(tile.height, lod, rows);
+
+            const uint32_t column_count = static_cast<uint32_t>(columns.size());
+            const uint32_t row_count    = static_cast<uint32_t>(rows.size());
+            const float inv_width       = 1.0f / static_cast<float>(g.width - 1);
+            const float inv_height      = 1.0f / static_cast<float>(g.height - 1);
+
+            vertices.resize(column_count * row_count);
+            for (uint32_t r = 0; r < row_count; r++)
+            {
+                for (uint32_t c = 0; c < column_count; c++)
+                {
+                    const uint32_t gx = tile.x + columns[c];
+                    const uint32_t gz = tile.z + rows[r];
+
+                    const Vector3 position(gx * g.spacing_x + g.origin_x - offset.x, get_height(tile, columns[c], rows[r]), gz * g.spacing_z + g.origin_z - offset.z);
+                    const Vector3 normal = decode_octahedral(tile.normals[rows[r] * tile.width + columns[c]]);
+                    const Vector3 tangent = Vector3(1.0f - normal.x * normal.x, -normal.y * normal.x, -normal.z * normal.x).Normalized();
+
+                    vertices[r * column_count + c] = RHI_Vertex_PosTexNorTan(position, Vector2(gx * inv_width, gz * inv_height), normal, tangent);
+                }
+            }
+
+            // two triangles per cell, wound the same way the terrain always was
+            indices.resize((column_count - 1) * (row_count - 1) * 6);
+            for (uint32_t r = 0; r < row_count - 1; r++)
+            {
+                for (uint32_t c = 0; c < column_count - 1; c++)
+                {
+                    uint32_t k  = (r * (column_count - 1) + c) * 6;
+                    uint32_t bl = r * column_count + c;
+                    uint32_t br = bl + 1;
+                    uint32_t tl = bl + column_count;
+                    uint32_t tr = tl + 1;
+
+                    indices[k]     = br;
+                    indices[k + 1] = bl;
+                    indices[k + 2] = tl;
+                    indices[k + 3] = br;
+                    indices[k + 4] = tl;
+                    indices[k + 5] = tr;
+                }
+            }
+
+            if (skirt_depth <= 0.0f)
+                return;
+
+            // walk the border so the skirt quads are wound like the surface quads and face outwards
+            vector<uint32_t> border;
+            for (uint32_t c = 0; c < column_count - 1; c++) border.push_back(c);
+            for (uint32_t r = 0; r < row_count - 1; r++)    border.push_back(r * column_count + column_count - 1);
+            for (uint32_t c = column_count - 1; c > 0; c--) border.push_back((row_count - 1) * column_count + c);
+            for (uint32_t r = row_count - 1; r > 0; r--)    border.push_back(r * column_count);
+
+            const uint32_t skirt_first = static_cast<uint32_t>(vertices.size());
+            for (uint32_t index : border)
+            {
+                RHI_Vertex_PosTexNorTan vertex  = vertices[index];
+                vertex.pos[1]                  -= skirt_depth;
+                vertices.push_back(vertex);
+            }
+
+            const uint32_t border_count = static_cast<uint32_t>(border.size());
+            for (uint32_t k = 0; k < border_count; k++)
+            {
+                const uint32_t top_0    = border[k];
+                const uint32_t top_1    = border[(k + 1) % border_count];
+                const uint32_t bottom_0 = skirt_first + k;
+                const uint32_t bottom_1 = skirt_first + (k + 1) % border_count;
+
+                indices.insert(indices.end(), { top_0, top_1, bottom_0, top_1, bottom_1, bottom_0 });
+            }
+        }
+    }
+
+    namespace cache
+    {
+        enum stage : uint32_t
+        {
+            stage_heights,   // height map read and smoothed
+            stage_densify,   // upsampled by the density
+            stage_noise,     // perlin noise added
+            stage_erosion,   // hydraulic and wind erosion applied, the final heights
+            stage_mesh,      // tile geometry, which is the only copy of the mesh that's kept
+            stage_placement, // per triangle data for prop placement
+            stage_count
+        };
+
+        const char* stage_names[stage_count] = { "heights", "densify", "noise", "erosion", "mesh", "placement" };
+        const char* directory                = "terrain_cache";
+        const uint32_t magic                 = 0x43545053; // "SPTC"
+        const uint32_t version               = 3;          // bump when a stage changes what it computes or how it's laid out
+        const uint64_t alignment             = 64;
+
+        // a blob is a header, a table of sections and then the sections, each aligned so it can be mapped and used in place
+        struct blob_header
+        {
+            uint32_t magic         = cache::magic;
+            uint32_t version       = cache::version;
+            uint64_t hash          = 0;
+            uint32_t section_count = 0;
+            uint32_t padding       = 0;
+        };
+
+        struct blob_section
+        {
+            uint64_t offset = 0;
+            uint64_t size   = 0;
+        };
+
+        struct blob_data
+        {
+            const void* data = nullptr;
+            uint64_t size    = 0;
+        };
+
+        template<typename T>
+        blob_data section(const vector<T>& v)
+        {
+            return { v.data(), v.size() * sizeof(T) };
+        }
+
+        string get_path(const uint32_t stage, const uint64_t hash)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "%s_%016llx.bin", stage_names[stage], static_cast<unsigned long long>(hash));
+            return string(directory) + "/" + name;
+        }
+
+        bool write_blob(const string& path, const uint64_t hash, const vector<blob_data>& sections)
+        {
+            // write next to the final path and move it over at the end, so a crash never leaves a torn blob behind
+            const string path_temp = path + ".tmp";
+            ofstream file(path_temp, ios::binary);
+            if (!file.is_open())
+                return false;
+
+            blob_header header;
+            header.hash          = hash;
+            header.section_count = static_cast<uint32_t>(sections.size());
+
+            vector<blob_section> table(sections.size());
+            uint64_t offset = sizeof(blob_header) + table.size() * sizeof(blob_section);
+            for (size_t i = 0; i < sections.size(); i++)
+            {
+                offset           = (offset + alignment - 1) & ~(alignment - 1);
+                table[i].offset  = offset;
+                table[i].size    = sections[i].size;
+                offset          += sections[i].size;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(blob_header));
+            file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(blob_section));
+            for (size_t i = 0; i < sections.size(); i++)
+            {
+                file.seekp(table[i].offset);
+                file.write(reinterpret_cast<const char*>(sections[i].data), sections[i].size);
+            }
+
+            const bool written = file.good();
+            file.close();
+
+            if (!written)
+            {
+                FileSystem::Delete(path_temp);
+                return false;
+            }
+
+            if (FileSystem::Exists(path))
+            {
+                FileSystem::Delete(path);
+            }
+            FileSystem::Rename(path_temp, path);
+
+            return true;
+        }
+
+        // the blob is mapped and the sections are viewed in place, each one is copied once, straight into where it ends up
+        struct blob_reader
+        {
+            unique_ptr<MappedFile> file;
+            const blob_section* table = nullptr;
+            uint32_t section_count    = 0;
+
+            bool open(const string& path, const uint64_t hash)
+            {
+                file = make_unique<MappedFile>(path);
+                if (!file->IsValid() || file->GetSize() < sizeof(blob_header))
+                    return false;
+
+                const blob_header* header = reinterpret_cast<const blob_header*>(file->GetData());
+                if (header->magic != magic || header->version != version || header->hash != hash || header->section_count > 1'000'000)
+                    return false;
+
+                if (sizeof(blob_header) + header->section_count * sizeof(blob_section) > file->GetSize())
+                    return false;
+
+                table         = reinterpret_cast<const blob_section*>(file->GetData() + sizeof(blob_header));
+                section_count = header->section_count;
+                for (uint32_t i = 0; i < section_count; i++)
+                {
+                    if (table[i].offset % alignment != 0 || table[i].offset > file->GetSize() || table[i].size > file->GetSize() - table[i].offset)
+                        return false;
+                }
+
+                return true;
+            }
+
+            uint32_t get_section_count() const { return section_count; }
+
+            // a view of the section, valid for as long as the reader is
+            template<typename T>
+            bool view(const uint32_t index, const T*& data, size_t& count) const
+            {
+                if (index >= section_count || table[index].size % sizeof(T) != 0)
+                    return false;
+
+                data  = reinterpret_cast<const T*>(file->GetData() + table[index].offset);
+                count = static_cast<size_t>(table[index].size / sizeof(T));
+                return true;
+            }
+
+            template<typename T>
+            bool read(const uint32_t index, vector<T>& out) const
+            {
+                const T* data = nullptr;
+                size_t count  = 0;
+                if (!view(index, data, count))
+                    return false;
+
+                out.assign(data, data + count);
+                return true;
+            }
+        };
+
+        // blobs are content addressed, a stage only keeps the blob it last wrote so the directory doesn't grow without bound
+        void remove_stale(const uint32_t stage, const string& path_keep)
+        {
+            const string prefix    = string(stage_names[stage]) + "_";
+            const string name_keep = FileSystem::GetFileNameFromFilePath(path_keep);
+            for (const string& path : FileSystem::GetFilesInDirectory(directory))
+            {
+                const string name = FileSystem::GetFileNameFromFilePath(path);
+                if (name.rfind(prefix, 0) == 0 && name != name_keep)
+                {
+                    FileSystem::Delete(path);
+                }
+            }
+        }
+    }
+
+    Terrain::Terrain(Entity* entity) : Component(entity)
+    {
+        m_material = make_shared<Material>();
+        m_material->SetObjectName("terrain");
+    }
+
+    Terrain::~Terrain()
+    {
+        m_height_map_seed = nullptr;
+    }
+
+    void Terrain::Save(pugi::xml_node& node)
+    {
+        // height map seed texture path
+        if (m_height_map_seed)
+        {
+            node.append_attribute("height_map_path") = m_height_map_seed->GetResourceFilePath().c_str();
+        }
+
+        // configurable parameters
+        node.append_attribute("min_y")         = m_min_y;
+        node.append_attribute("max_y")         = m_max_y;
+        node.append_attribute("level_sea")     = m_level_sea;
+        node.append_attribute("level_snow")    = m_level_snow;
+        node.append_attribute("smoothing")     = m_smoothing;
+        node.append_attribute("density")       = m_density;
+        node.append_attribute("scale")         = m_scale;
+        node.append_attribute("create_border") = m_create_border;
+    }
+
+    void Terrain::Load(pugi::xml_node& node)
+    {
+        // height map seed texture
+        string height_map_path = node.attribute("height_map_path").as_string("");
+        if (!height_map_path.empty())
+        {
+            if (shared_ptr<RHI_Texture> texture = ResourceCache::Load<RHI_Texture>(height_map_path))
+            {
+                m_height_map_seed = texture.get();
+            }
+        }
+
+        // configurable parameters
+        m_min_y         = node.attribute("min_y").as_float(-64.0f);
+        m_max_y         = node.attribute("max_y").as_float(256.0f);
+        m_level_sea     = node.attribute("level_sea").as_float(0.0f);
+        m_level_snow    = node.attribute("level_snow").as_float(400.0f);
+        m_smoothing     = node.attribute("smoothing").as_uint(0);
+        m_density       = node.attribute("density").as_uint(3);
+        m_scale         = node.attribute("scale").as_uint(6);
+        m_create_border = node.attribute("create_border").as_bool(true);
+
+        // regenerate terrain if we have a height map
+        if (m_height_map_seed)
+        {
+            Generate();
+        }
+    }
+
+    void Terrain::Save(BinaryWriter& writer)
+    {
+        writer.WriteString(m_height_map_seed ? m_height_map_seed->GetResourceFilePath() : "");
+        writer.Write(m_min_y);
+        writer.Write(m_max_y);
+        writer.Write(m_level_sea);
+        writer.Write(m_level_snow);
+        writer.Write(m_smoothing);
+        writer.Write(m_density);
+        writer.Write(m_scale);
+        writer.Write(m_create_border);
+    }
+
+    void Terrain::Load(BinaryReader& reader)
     {
-        // hash inputs to detect when cache is stale
+        string height_map_path = reader.ReadString();
+        if (!height_map_path.empty())
+        {
+            if (shared_ptr<RHI_Texture> texture = ResourceCache::Load<RHI_Texture>(height_map_path))
+            {
+                m_height_map_seed = texture.get();
+            }
+        }
+
+        m_min_y         = reader.Read<float>(-64.0f);
+        m_max_y         = reader.Read<float>(256.0f);
+        m_level_sea     = reader.Read<float>(0.0f);
+        m_level_snow    = reader.Read<float>(400.0f);
+        m_smoothing     = reader.Read<uint32_t>(0);
+        m_density       = reader.Read<uint32_t>(3);
+        m_scale         = reader.Read<uint32_t>(6);
+        m_create_border = reader.Read<bool>(true);
+
+        if (m_height_map_seed)
+        {
+            Generate();
+        }
+    }
+
+    void Terrain::ComputeCacheHashes(uint64_t* hashes) const
+    {
+        // every stage hashes its own inputs on top of the hash of the stage it reads from, so a change only
+        // invalidates the stages downstream of it (the snow level isn't an input to any of them)
         uint64_t hash = 14695981039346656037ull; // fnv-1a offset basis
         auto hash_combine = [&hash](uint64_t value) {
             hash ^= value;
             hash *= 1099511628211ull; // fnv-1a prime
         };
+        auto hash_float = [&hash_combine](float value) {
+            hash_combine(static_cast<uint64_t>(static_cast<int64_t>(value * 1000)));
+        };
 
-        hash_combine(static_cast<uint64_t>(m_min_y * 1000));
-        hash_combine(static_cast<uint64_t>(m_max_y * 1000));
-        hash_combine(static_cast<uint64_t>(m_level_sea * 1000));
-        hash_combine(static_cast<uint64_t>(m_level_snow * 1000));
+        hash_combine(cache::version);
+
+        // heights
+        hash_float(m_min_y);
+        hash_float(m_max_y);
         hash_combine(m_smoothing);
-        hash_combine(m_density);
-        hash_combine(m_scale);
         hash_combine(m_create_border ? 1 : 0);
-        
         if (m_height_map_seed)
         {
             hash_combine(m_height_map_seed->GetWidth());
@@ -1109,11 +1601,33 @@ namespace spartan
                 hash_combine(static_cast<uint64_t>(c));
             }
         }
+        hashes[cache::stage_heights] = hash;
+
+        // densify
+        hash_combine(cache::stage_densify);
+        hash_combine(m_density);
+        hashes[cache::stage_densify] = hash;
 
-        return hash;
+        // noise, its parameters are fixed
+        hash_combine(cache::stage_noise);
+        hashes[cache::stage_noise] = hash;
+
+        // erosion
+        hash_combine(cache::stage_erosion);
+        hash_float(m_level_sea);
+        hashes[cache::stage_erosion] = hash;
+
+        // mesh, the scale only spreads the vertices out
+        hash_combine(cache::stage_mesh);
+        hash_combine(m_scale);
+        hashes[cache::stage_mesh] = hash;
+
+        // placement
+        hash_combine(cache::stage_placement);
+        hashes[cache::stage_placement] = hash;
     }
 
-    void Terrain::FindTransforms(const uint32_t tile_index, const TerrainProp terrain_prop, Entity* entity, const float density_fraction, const float scale, vector<Matrix>& transforms_out)
+    void Terrain::FindInstances(const uint32_t tile_index, const TerrainProp terrain_prop, Entity* entity, const float density_fraction, const float scale, const function<void(const vector<Instance>&)>& on_cell)
     {
         TerrainPropDescription description;
 
@@ -1160,166 +1674,213 @@ namespace spartan
             SP_ASSERT_MSG(false, "unknown terrain prop type");
         }
 
-        placement::find_transforms(description, density_fraction, tile_index, transforms_out, m_triangle_data);
+        if (tile_index >= m_triangle_data.size() || m_triangle_data[tile_index].empty())
+        {
+            SP_LOG_ERROR("no triangle data found for tile %d", tile_index);
+            return;
+        }
 
-        // compensate for entity scale
+        // compensate for entity scale, instances only carry a uniform scale
+        float scale_compensation = 1.0f;
         if (entity && entity->GetScale() != Vector3::One && entity->GetScale() != Vector3::Zero)
         {
-            Matrix root_scale_matrix = Matrix::CreateScale(Vector3::One / entity->GetScale());
-            for (Matrix& t : transforms_out)
-                t *= root_scale_matrix;
+            const Vector3 entity_scale = entity->GetScale();
+            scale_compensation         = 3.0f / (entity_scale.x + entity_scale.y + entity_scale.z);
         }
+
+        placement::find_instances(description, density_fraction, tile_index, scale_compensation, m_triangle_data[tile_index], on_cell);
     }
 
-    void Terrain::SaveToFile(const char* file_path)
+    bool Terrain::LoadCacheStage(const uint32_t stage, const uint64_t hash)
     {
-        ofstream file(file_path, ios::binary);
-        if (!file.is_open())
-        {
-            SP_LOG_ERROR("failed to open file for writing: %s", file_path);
-            return;
-        }
-    
-        uint32_t width               = GetWidth();
-        uint32_t height              = GetHeight();
-        uint32_t height_data_size    = static_cast<uint32_t>(m_height_data.size());
-        uint32_t vertex_count        = static_cast<uint32_t>(m_vertices.size());
-        uint32_t index_count         = static_cast<uint32_t>(m_indices.size());
-        uint32_t tile_count          = static_cast<uint32_t>(m_tile_vertices.size());
-        uint32_t triangle_data_count = static_cast<uint32_t>(m_triangle_data.size());
-        uint32_t offset_count        = static_cast<uint32_t>(m_tile_offsets.size());
-        uint32_t position_count      = static_cast<uint32_t>(m_positions.size());
-        uint64_t cache_hash          = ComputeCacheHash();
-    
-        // header
-        file.write(reinterpret_cast<const char*>(&cache_hash), sizeof(uint64_t));
-        file.write(reinterpret_cast<const char*>(&width), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&height), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&height_data_size), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&vertex_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&index_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&tile_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&triangle_data_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&offset_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&position_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&m_dense_width), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&m_dense_height), sizeof(uint32_t));
-    
-        // main data
-        file.write(reinterpret_cast<const char*>(m_height_data.data()), height_data_size * sizeof(float));
-        file.write(reinterpret_cast<const char*>(m_vertices.data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
-        file.write(reinterpret_cast<const char*>(m_indices.data()), index_count * sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(m_tile_offsets.data()), offset_count * sizeof(Vector3));
-        file.write(reinterpret_cast<const char*>(m_positions.data()), position_count * sizeof(Vector3));
-    
-        // triangle data
-        for (const auto& [tile_id, tile_triangles] : m_triangle_data)
-        {
-            file.write(reinterpret_cast<const char*>(&tile_id), sizeof(uint64_t));
-            uint32_t triangle_count = static_cast<uint32_t>(tile_triangles.size());
-            file.write(reinterpret_cast<const char*>(&triangle_count), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(tile_triangles.data()), triangle_count * sizeof(TriangleData));
-        }
-    
-        // tile data
-        for (uint32_t i = 0; i < tile_count; i++)
+        cache::blob_reader reader;
+        if (!reader.open(cache::get_path(stage, hash), hash))
+            return false;
+
+        const size_t dense_count = static_cast<size_t>(m_dense_width) * m_dense_height;
+        switch (stage)
         {
-            uint32_t vertex_size = static_cast<uint32_t>(m_tile_vertices[i].size());
-            uint32_t index_size  = static_cast<uint32_t>(m_tile_indices[i].size());
-            file.write(reinterpret_cast<const char*>(&vertex_size), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(&index_size), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(m_tile_vertices[i].data()), vertex_size * sizeof(RHI_Vertex_PosTexNorTan));
-            file.write(reinterpret_cast<const char*>(m_tile_indices[i].data()), index_size * sizeof(uint32_t));
+            case cache::stage_heights:
+                return reader.read(0, m_height_data) && m_height_data.size() == static_cast<size_t>(m_width) * m_height;
+
+            case cache::stage_densify:
+            case cache::stage_noise:
+            case cache::stage_erosion:
+                return reader.read(0, m_height_data) && m_height_data.size() == dense_count;
+
+            case cache::stage_mesh:
+            {
+                // the area, the tile offsets, the tile placements and then the heights and normals of every tile
+                const float* area          = nullptr;
+                const uint32_t* placements = nullptr;
+                size_t area_count          = 0;
+                size_t placement_count     = 0;
+                if (reader.get_section_count() < 3 || reader.get_section_count() % 2 != 1 || !reader.view(0, area, area_count) || area_count != 1 ||
+                    !reader.read(1, m_tile_offsets) || !reader.view(2, placements, placement_count))
+                    return false;
+
+                const uint32_t tile_count = (reader.get_section_count() - 3) / 2;
+                if (m_tile_offsets.size() != tile_count || placement_count != tile_count * 6)
+                    return false;
+
+                m_area_km2 = area[0];
+                m_tiles.resize(tile_count);
+                for (uint32_t i = 0; i < tile_count; i++)
+                {
+                    TerrainTile& tile = m_tiles[i];
+                    tile.x            = placements[i * 6 + 0];
+                    tile.z            = placements[i * 6 + 1];
+                    tile.width        = placements[i * 6 + 2];
+                    tile.height       = placements[i * 6 + 3];
+                    memcpy(&tile.height_min, &placements[i * 6 + 4], sizeof(float));
+                    memcpy(&tile.height_range, &placements[i * 6 + 5], sizeof(float));
+
+                    if (!reader.read(3 + i * 2, tile.heights) || !reader.read(4 + i * 2, tile.normals))
+                        return false;
+
+                    if (tile.heights.size() != tile.width * tile.height || tile.normals.size() != tile.heights.size() ||
+                        tile.x + tile.width > m_dense_width || tile.z + tile.height > m_dense_height)
+                        return false;
+                }
+
+                return true;
+            }
+
+            case cache::stage_placement:
+            {
+                m_triangle_data.clear();
+                m_triangle_data.resize(reader.get_section_count());
+                for (uint32_t i = 0; i < reader.get_section_count(); i++)
+                {
+                    if (!reader.read(i, m_triangle_data[i]))
+                        return false;
+                }
+
+                return true;
+            }
         }
-    
-        file.close();
-        SP_LOG_INFO("saved terrain cache: hash=%llu", cache_hash);
+
+        return false;
     }
-    
-    void Terrain::LoadFromFile(const char* file_path)
+
+    void Terrain::SaveCacheStage(const uint32_t stage, const uint64_t hash)
     {
-        ifstream file(file_path, ios::binary);
-        if (!file.is_open())
-            return;
-    
-        // verify cache hash matches current parameters
-        uint64_t stored_hash = 0;
-        file.read(reinterpret_cast<char*>(&stored_hash), sizeof(uint64_t));
-        
-        uint64_t current_hash = ComputeCacheHash();
-        if (stored_hash != current_hash)
+        vector<cache::blob_data> sections;
+        vector<float> area = { m_area_km2 };
+        vector<uint32_t> placements;
+        switch (stage)
         {
-            SP_LOG_INFO("terrain cache invalidated (hash mismatch: %llu vs %llu)", stored_hash, current_hash);
-            file.close();
-            return;
+            case cache::stage_heights:
+            case cache::stage_densify:
+            case cache::stage_noise:
+            case cache::stage_erosion:
+                sections.push_back(cache::section(m_height_data));
+                break;
+
+            case cache::stage_mesh:
+                for (const TerrainTile& tile : m_tiles)
+                {
+                    uint32_t height_min, height_range;
+                    memcpy(&height_min, &tile.height_min, sizeof(float));
+                    memcpy(&height_range, &tile.height_range, sizeof(float));
+                    placements.insert(placements.end(), { tile.x, tile.z, tile.width, tile.height, height_min, height_range });
+                }
+
+                sections.push_back(cache::section(area));
+                sections.push_back(cache::section(m_tile_offsets));
+                sections.push_back(cache::section(placements));
+                for (const TerrainTile& tile : m_tiles)
+                {
+                    sections.push_back(cache::section(tile.heights));
+                    sections.push_back(cache::section(tile.normals));
+                }
+                break;
+
+            case cache::stage_placement:
+                for (uint32_t i = 0; i < static_cast<uint32_t>(m_tiles.size()); i++)
+                {
+                    sections.push_back(cache::section(m_triangle_data[i]));
+                }
+                break;
         }
 
-        uint32_t height_data_size    = 0;
-        uint32_t vertex_count        = 0;
-        uint32_t index_count         = 0;
-        uint32_t tile_count          = 0;
-        uint32_t triangle_data_count = 0;
-        uint32_t offset_count        = 0;
-        uint32_t position_count      = 0;
-    
-        file.read(reinterpret_cast<char*>(&m_width), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&m_height), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&height_data_size), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&vertex_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&index_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&tile_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&triangle_data_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&offset_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&position_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&m_dense_width), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&m_dense_height), sizeof(uint32_t));
-    
-        if (tile_count > 10000 || offset_count > 10000)
+        const string path = cache::get_path(stage, hash);
+        if (!cache::write_blob(path, hash, sections))
         {
-            SP_LOG_ERROR("invalid tile_count (%u) or offset_count (%u), aborting load", tile_count, offset_count);
-            file.close();
+            SP_LOG_WARNING("failed to write terrain cache: %s", path.c_str());
             return;
         }
-    
-        m_height_data.resize(height_data_size);
-        m_vertices.resize(vertex_count);
-        m_indices.resize(index_count);
-        m_tile_vertices.resize(tile_count);
-        m_tile_indices.resize(tile_count);
-        m_tile_offsets.resize(offset_count);
-        m_positions.resize(position_count);
-        m_triangle_data.clear();
-    
-        file.read(reinterpret_cast<char*>(m_height_data.data()), height_data_size * sizeof(float));
-        file.read(reinterpret_cast<char*>(m_vertices.data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
-        file.read(reinterpret_cast<char*>(m_indices.data()), index_count * sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(m_tile_offsets.data()), offset_count * sizeof(Vector3));
-        file.read(reinterpret_cast<char*>(m_positions.data()), position_count * sizeof(Vector3));
-    
-        for (uint32_t i = 0; i < triangle_data_count; i++)
-        {
-            uint64_t tile_id;
-            uint32_t triangle_count;
-            file.read(reinterpret_cast<char*>(&tile_id), sizeof(uint64_t));
-            file.read(reinterpret_cast<char*>(&triangle_count), sizeof(uint32_t));
-            vector<TriangleData>& tile_triangles = m_triangle_data[tile_id];
-            tile_triangles.resize(triangle_count);
-            file.read(reinterpret_cast<char*>(tile_triangles.data()), triangle_count * sizeof(TriangleData));
-        }
-    
-        for (uint32_t i = 0; i < tile_count; i++)
+
+        cache::remove_stale(stage, path);
+    }
+
+    void Terrain::ComputeCacheStage(const uint32_t stage)
+    {
+        ProgressTracker::GetProgress(ProgressType::Terrain).SetText(string("generating ") + cache::stage_names[stage] + "...");
+
+        switch (stage)
         {
-            uint32_t vertex_size, index_size;
-            file.read(reinterpret_cast<char*>(&vertex_size), sizeof(uint32_t));
-            file.read(reinterpret_cast<char*>(&index_size), sizeof(uint32_t));
-            m_tile_vertices[i].resize(vertex_size);
-            m_tile_indices[i].resize(index_size);
-            file.read(reinterpret_cast<char*>(m_tile_vertices[i].data()), vertex_size * sizeof(RHI_Vertex_PosTexNorTan));
-            file.read(reinterpret_cast<char*>(m_tile_indices[i].data()), index_size * sizeof(uint32_t));
+            case cache::stage_heights:
+            {
+                get_values_from_height_map(m_height_data, m_height_map_seed, m_min_y, m_max_y, m_smoothing, m_create_border);
+                break;
+            }
+
+            case cache::stage_densify:
+            {
+                densify_height_map(m_height_data, m_width, m_height, m_density);
+                break;
+            }
+
+            case cache::stage_noise:
+            {
+                vector<Vector3> positions;
+                heights_to_positions(m_height_data, positions, m_dense_width, m_dense_height, m_density, m_scale);
+                apply_perlin_noise(positions, m_dense_width, m_dense_height);
+                positions_to_heights(positions, m_height_data);
+                break;
+            }
+
+            case cache::stage_erosion:
+            {
+                vector<Vector3> positions;
+                heights_to_positions(m_height_data, positions, m_dense_width, m_dense_height, m_density, m_scale);
+                apply_erosion(positions, m_dense_width, m_dense_height, m_level_sea);
+                positions_to_heights(positions, m_height_data);
+                break;
+            }
+
+            case cache::stage_mesh:
+            {
+                {
+                    vector<Vector3> positions;
+                    heights_to_positions(m_height_data, positions, m_dense_width, m_dense_height, m_density, m_scale);
+                    m_area_km2 = compute_surface_area_km2(positions, m_dense_width, m_dense_height);
+                }
+
+                tiles::build(m_height_data, tiles::grid(m_dense_width, m_dense_height, m_density, m_scale), m_tiles, m_tile_offsets);
+                break;
+            }
+
+            case cache::stage_placement:
+            {
+                // placement works on the full resolution surface, one tile at a time so it's never all expanded at once
+                const tiles::grid grid(m_dense_width, m_dense_height, m_density, m_scale);
+                vector<vector<RHI_Vertex_PosTexNorTan>> tile_vertices(m_tiles.size());
+                vector<vector<uint32_t>> tile_indices(m_tiles.size());
+
+                m_triangle_data.clear();
+                m_triangle_data.resize(m_tiles.size());
+                for (uint32_t tile_index = 0; tile_index < m_tiles.size(); tile_index++)
+                {
+                    tiles::expand(m_tiles[tile_index], grid, m_tile_offsets[tile_index], 0, 0.0f, tile_vertices[tile_index], tile_indices[tile_index]);
+                    placement::compute_triangle_data(tile_vertices, tile_indices, tile_index, m_triangle_data);
+                    tile_vertices[tile_index] = {};
+                    tile_indices[tile_index]  = {};
+                }
+                break;
+            }
         }
-    
-        file.close();
-        SP_LOG_INFO("loaded terrain from cache: hash=%llu", stored_hash);
     }
 
     void Terrain::Generate()
@@ -1338,77 +1899,57 @@ namespace spartan
     
         m_is_generating = true;
     
-        uint32_t job_count = 9;
+        uint32_t job_count = cache::stage_count + 1;
         ProgressTracker::GetProgress(ProgressType::Terrain).Start(job_count, "generating terrain...");
-    
-        // try loading from cache
-        const string cache_file = "terrain_cache.bin";
-        bool loaded_from_cache  = false;
 
-        LoadFromFile(cache_file.c_str());
-        if (!m_vertices.empty())
+        m_width        = m_height_map_seed->GetWidth();
+        m_height       = m_height_map_seed->GetHeight();
+        m_dense_width  = m_density * (m_width - 1) + 1;
+        m_dense_height = m_density * (m_height - 1) + 1;
+
+        // 1-6. get the output of every stage that's needed, from the cache when it has it, otherwise from the stage before it
         {
-            loaded_from_cache = true;
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("loaded from cache");
-            for (uint32_t i = 0; i < job_count - 1; i++)
+            uint64_t hashes[cache::stage_count];
+            ComputeCacheHashes(hashes);
+            FileSystem::CreateDirectory_(cache::directory);
+
+            bool ready[cache::stage_count] = {};
+            function<void(uint32_t)> require = [&](uint32_t stage)
+            {
+                if (ready[stage])
+                    return;
+
+                if (LoadCacheStage(stage, hashes[stage]))
+                {
+                    SP_LOG_INFO("terrain stage \"%s\" loaded from cache", cache::stage_names[stage]);
+                }
+                else
+                {
+                    if (stage > 0)
+                    {
+                        require(stage - 1);
+                    }
+                    ComputeCacheStage(stage);
+                    SaveCacheStage(stage, hashes[stage]);
+                }
+
+                ready[stage] = true;
                 ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-        }
+            };
 
-        if (!loaded_from_cache)
-        {
-            SP_LOG_INFO("generating terrain from scratch...");
-    
-            // 1. process height map
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("processing height map...");
-            get_values_from_height_map(m_height_data, m_height_map_seed, m_min_y, m_max_y, m_smoothing, m_create_border);
-            m_width  = m_height_map_seed->GetWidth();
-            m_height = m_height_map_seed->GetHeight();
-            densify_height_map(m_height_data, m_width, m_height, m_density);
-            m_dense_width  = m_density * (m_width - 1) + 1;
-            m_dense_height = m_density * (m_height - 1) + 1;
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-    
-            // 2. generate positions
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("generating positions...");
-            m_positions.resize(m_dense_width * m_dense_height);
-            generate_positions(m_positions, m_height_data, m_dense_width, m_dense_height, m_density, m_scale);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 3. apply perlin noise
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("applying perlin noise...");
-            apply_perlin_noise(m_positions, m_dense_width, m_dense_height);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 4. apply erosion
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("applying erosion...");
-            apply_erosion(m_positions, m_dense_width, m_dense_height, m_level_sea);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 5. generate vertices and indices
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("generating mesh...");
-            m_vertices.resize(m_dense_width * m_dense_height);
-            m_indices.resize((m_dense_width - 1) * (m_dense_height - 1) * 6);
-            generate_vertices_and_indices(m_vertices, m_indices, m_positions, m_dense_width, m_dense_height);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-    
-            // 6. generate normals
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("generating normals...");
-            generate_normals(m_vertices, m_dense_width, m_dense_height);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-    
-            // 7. split into tiles
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("splitting into tiles...");
-            uint32_t tile_count = 16;
-            geometry_processing::split_surface_into_tiles(m_vertices, m_indices, tile_count, m_tile_vertices, m_tile_indices, m_tile_offsets);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 8. compute triangle data for placement
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("computing placement data...");
-            for (uint32_t tile_index = 0; tile_index < m_tile_vertices.size(); tile_index++)
-                placement::compute_triangle_data(m_tile_vertices, m_tile_indices, tile_index, m_triangle_data);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            SaveToFile(cache_file.c_str());
+            // the final heights are needed for the baked height map, the rest for the tiles
+            require(cache::stage_erosion);
+            require(cache::stage_mesh);
+            require(cache::stage_placement);
+
+            // stages that didn't have to run
+            for (uint32_t stage = 0; stage < cache::stage_count; stage++)
+            {
+                if (!ready[stage])
+                {
+                    ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
+                }
+            }
         }
 
         // bake height map texture
@@ -1416,14 +1957,7 @@ namespace spartan
             vector<RHI_Texture_Slice> data(1);
             data[0].mips.resize(1);
             data[0].mips[0].bytes.resize(m_dense_width * m_dense_height * sizeof(float));
-        
-            float* height_ptr = reinterpret_cast<float*>(data[0].mips[0].bytes.data());
-            auto copy_heights = [this, height_ptr](uint32_t start, uint32_t end)
-            {
-                for (uint32_t i = start; i < end; i++)
-                    height_ptr[i] = m_positions[i].y;
-            };
-            ThreadPool::ParallelLoop(copy_heights, m_dense_width * m_dense_height);
+            memcpy(data[0].mips[0].bytes.data(), m_height_data.data(), data[0].mips[0].bytes.size());
         
             m_height_map_final = make_shared<RHI_Texture>(
                 RHI_Texture_Type::Type2D,
@@ -1435,22 +1969,33 @@ namespace spartan
     
         // compute stats
         m_height_samples = m_dense_width * m_dense_height;
-        m_vertex_count   = static_cast<uint32_t>(m_vertices.size());
-        m_index_count    = static_cast<uint32_t>(m_indices.size());
+        m_vertex_count   = m_dense_width * m_dense_height;
+        m_index_count    = (m_dense_width - 1) * (m_dense_height - 1) * 6;
         m_triangle_count = m_index_count / 3;
-        m_area_km2       = compute_surface_area_km2(m_vertices, m_indices);
 
         // 9. create tile entities and gpu buffers
         ProgressTracker::GetProgress(ProgressType::Terrain).SetText("creating gpu mesh...");
         m_mesh = make_shared<Mesh>();
         m_mesh->SetObjectName("terrain_mesh");
         m_mesh->SetFlag(static_cast<uint32_t>(MeshFlags::PostProcessOptimize), false);
-        m_mesh->SetFlag(static_cast<uint32_t>(MeshFlags::PostProcessPreserveTerrainEdges), true);
 
-        for (uint32_t tile_index = 0; tile_index < static_cast<uint32_t>(m_tile_vertices.size()); tile_index++)
+        // lods come straight from the grid, every one halves the sample rate, and the renderable picks one per tile by screen size
+        const tiles::grid grid(m_dense_width, m_dense_height, m_density, m_scale);
+        vector<RHI_Vertex_PosTexNorTan> vertices;
+        vector<uint32_t> indices;
+        for (uint32_t tile_index = 0; tile_index < static_cast<uint32_t>(m_tiles.size()); tile_index++)
         {
+            const TerrainTile& tile = m_tiles[tile_index];
+            const float skirt_depth = tiles::compute_skirt_depth(tile);
+
             uint32_t sub_mesh_index = 0;
-            m_mesh->AddGeometry(m_tile_vertices[tile_index], m_tile_indices[tile_index], true, &sub_mesh_index);
+            tiles::expand(tile, grid, m_tile_offsets[tile_index], 0, skirt_depth, vertices, indices);
+            m_mesh->AddGeometry(vertices, indices, false, &sub_mesh_index);
+            for (uint32_t lod = 1; lod < tiles::get_lod_count(tile); lod++)
+            {
+                tiles::expand(tile, grid, m_tile_offsets[tile_index], lod, skirt_depth, vertices, indices);
+                m_mesh->AddLod(vertices, indices, sub_mesh_index);
+            }
             
             Entity* entity = World::CreateEntity();
             entity->SetObjectName("tile_" + to_string(tile_index + 1));
@@ -1468,20 +2013,14 @@ namespace spartan
         ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
     
         // free temporary data
-        m_vertices.clear();
-        m_indices.clear();
-        m_tile_vertices.clear();
-        m_tile_indices.clear();
+        m_tiles.clear();
 
         m_is_generating = false;
     }
 
     void Terrain::Clear()
     {
-        m_vertices.clear();
-        m_indices.clear();
-        m_tile_vertices.clear();
-        m_tile_indices.clear();
+        m_tiles.clear();
         m_triangle_data.clear();
         ResourceCache::Remove(m_mesh);
         m_mesh = nullptr;
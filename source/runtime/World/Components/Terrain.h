@@ -24,15 +24,16 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =========================
 #include "Component.h"
 #include <atomic>
-#include <unordered_map>
+#include <functional>
 #include "../../RHI/RHI_Definitions.h"
-#include "../../Math/Quaternion.h"
+#include "../../Math/Vector3.h"
 //====================================
 
 namespace spartan
 {
     class Mesh;
     class Material;
+    struct Instance;
     namespace math
     {
         class Vector3;
@@ -61,18 +62,28 @@ namespace spartan
         float cluster_radius           = 0.0f;
     };
 
-    // precomputed per-triangle data for prop placement
+    // per-triangle data for prop placement, the normal, slope and height range are derived from it when needed
     struct TriangleData
     {
-        math::Vector3 normal;
         math::Vector3 v0;
         math::Vector3 v1_minus_v0;
         math::Vector3 v2_minus_v0;
-        float slope_radians;
-        float height_min;
-        float height_max;
-        math::Quaternion rotation_to_normal;
-        math::Vector3 centroid;
+    };
+
+    // a tile in its stored form, positions, uvs and tangents follow from where its samples sit on the grid
+    struct TerrainTile
+    {
+        // first sample and sample count on the dense grid, the border samples are shared with the neighbouring tiles
+        uint32_t x      = 0;
+        uint32_t z      = 0;
+        uint32_t width  = 0;
+        uint32_t height = 0;
+
+        // heights are quantized to 16 bits over the range of the tile, normals are octahedral with two 16 bit components
+        float height_min   = 0.0f;
+        float height_range = 0.0f;
+        std::vector<uint16_t> heights;
+        std::vector<uint32_t> normals;
     };
 
     class Terrain : public Component
@@ -122,29 +133,35 @@ namespace spartan
 
         // generation
         void Generate();
-        void FindTransforms(
+
+        // places a prop over a tile and hands the instances, already packed, to on_cell one spatial cell at a time
+        // so that a tile's worth of placements never exists in full, on_cell is called on the calling thread
+        void FindInstances(
             const uint32_t tile_index,
             const TerrainProp terrain_prop,
             Entity* entity,
             const float density_fraction,
             const float scale,
-            std::vector<math::Matrix>& transforms_out
+            const std::function<void(const std::vector<Instance>& instances)>& on_cell
         );
 
         // component io
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
-
-        // cache io
-        void SaveToFile(const char* file_path);
-        void LoadFromFile(const char* file_path);
+        void Save(BinaryWriter& writer) override;
+        void Load(BinaryReader& reader) override;
 
         // triangle data access for placement system
-        std::unordered_map<uint64_t, std::vector<TriangleData>>& GetTriangleData() { return m_triangle_data; }
+        std::vector<std::vector<TriangleData>>& GetTriangleData() { return m_triangle_data; }
  
     private:
         void Clear();
-        uint64_t ComputeCacheHash() const;
+
+        // generation runs as a chain of stages, each cached on disk under a hash of its own inputs and of the stage before it
+        void ComputeCacheHashes(uint64_t* hashes) const;
+        bool LoadCacheStage(const uint32_t stage, const uint64_t hash);
+        void SaveCacheStage(const uint32_t stage, const uint64_t hash);
+        void ComputeCacheStage(const uint32_t stage);
 
         // textures
         RHI_Texture* m_height_map_seed                  = nullptr;
@@ -173,17 +190,13 @@ namespace spartan
         uint32_t m_dense_height           = 0;
     
         // geometry data
-        std::vector<float> m_height_data;
-        std::vector<std::vector<RHI_Vertex_PosTexNorTan>> m_tile_vertices;
-        std::vector<RHI_Vertex_PosTexNorTan> m_vertices;
-        std::vector<uint32_t> m_indices;
-        std::vector<std::vector<uint32_t>> m_tile_indices;
+        std::vector<float> m_height_data; // the output of the last height stage that ran, the final heights once generated
+        std::vector<TerrainTile> m_tiles;
         std::shared_ptr<Mesh> m_mesh;
         std::shared_ptr<Material> m_material;
         std::vector<math::Vector3> m_tile_offsets;
-        std::vector<math::Vector3> m_positions;
 
-        // placement data (per-terrain, not static)
-        std::unordered_map<uint64_t, std::vector<TriangleData>> m_triangle_data;
+        // placement data (per-terrain, not static), one table per tile
+        std::vector<std::vector<TriangleData>> m_triangle_data;
     };
 }
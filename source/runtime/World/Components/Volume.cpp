@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Entity.h"
 #include "../../Core/Engine.h"
 #include "../../Rendering/Renderer.h"
+#include "../../IO/Binary.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -108,6 +109,38 @@ namespace spartan
         }
     }
 
+    void Volume::Save(BinaryWriter& writer)
+    {
+        writer.Write(m_bounding_box.GetMin());
+        writer.Write(m_bounding_box.GetMax());
+
+        writer.Write(static_cast<uint32_t>(m_options.size()));
+        for (const auto& [name, value] : m_options)
+        {
+            writer.WriteString(name);
+            writer.Write(value);
+        }
+    }
+
+    void Volume::Load(BinaryReader& reader)
+    {
+        const Vector3 bb_min = reader.Read<Vector3>(Vector3(-0.5f));
+        const Vector3 bb_max = reader.Read<Vector3>(Vector3(0.5f));
+        m_bounding_box       = BoundingBox(bb_min, bb_max);
+
+        m_options.clear();
+        const uint32_t option_count = reader.Read<uint32_t>(0);
+        for (uint32_t i = 0; i < option_count && !reader.HasFailed(); i++)
+        {
+            string name = reader.ReadString();
+            float value = reader.Read<float>(0.0f);
+            if (!name.empty())
+            {
+                m_options[name] = value;
+            }
+        }
+    }
+
     void Volume::SetOption(const char* name, float value)
     {
         m_options[name] = value;
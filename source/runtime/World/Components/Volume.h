@@ -42,6 +42,9 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void Save(BinaryWriter& writer) override;
+        void Load(BinaryReader& reader) override;
+        bool IsLoadThreadSafe() const override { return true; }
         //=================================
 
         // box
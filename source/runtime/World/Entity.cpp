@@ -28,6 +28,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Components/AudioSource.h"
 #include "Components/Terrain.h"
 #include "Components/Volume.h"
+#include "../IO/Binary.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -96,18 +97,6 @@ namespace spartan
     Entity::~Entity()
     {
         m_components.fill(nullptr);
-
-        // if this entity is selected, deselect it
-        if (Camera* camera = World::GetCamera())
-        {
-            if (Entity* selected_entity = camera->GetSelectedEntity())
-            {
-                if (selected_entity->GetObjectId() == GetObjectId())
-                {
-                    camera->SetSelectedEntity(nullptr);
-                }
-            }
-        }
     }
 
     Entity* Entity::Clone()
@@ -137,28 +126,9 @@ namespace spartan
         }
     }
 
-    void Entity::PreTick()
-    {
-        for (shared_ptr<Component>& component : m_components)
-        {
-            if (component)
-            {
-                component->PreTick();
-            }
-        }
-    }
-
-    void Entity::Tick()
+    float Entity::GetTimeSinceLastTransform() const
     {
-        for (shared_ptr<Component>& component : m_components)
-        {
-            if (component)
-            {
-                component->Tick();
-            }
-        }
-
-        m_time_since_last_transform_sec += static_cast<float>(Timer::GetDeltaTimeSec());
+        return static_cast<float>(Timer::GetTimeSec() - m_time_last_transform_sec);
     }
 
     void Entity::Save(pugi::xml_node& node)
@@ -259,7 +229,29 @@ namespace spartan
             child->SetParent(this);
         }
 
-        UpdateTransform();
+        MarkTransformDirty();
+    }
+
+    void Entity::Save(BinaryWriter& writer)
+    {
+        writer.Write(m_object_id);
+        writer.WriteString(m_object_name);
+        writer.Write(m_is_active);
+        writer.Write(m_position_local);
+        writer.Write(m_rotation_local);
+        writer.Write(m_scale_local);
+    }
+
+    void Entity::Load(BinaryReader& reader)
+    {
+        m_object_id      = reader.Read<uint64_t>();
+        m_object_name    = reader.ReadString();
+        m_is_active      = reader.Read<bool>(true);
+        m_position_local = reader.Read<Vector3>(Vector3::Zero);
+        m_rotation_local = reader.Read<Quaternion>(Quaternion::Identity);
+        m_scale_local    = reader.Read<Vector3>(Vector3::One);
+
+        MarkTransformDirty();
     }
 
     bool Entity::GetActive()
@@ -278,6 +270,7 @@ namespace spartan
             return;
 
         m_is_active = active;
+        World::MarkEntityChanged(this, EntityChange::Active);
     }
     
     Component* Entity::AddComponent(const ComponentType type)
@@ -308,6 +301,7 @@ namespace spartan
                 {
                     component->Remove();
                     component = nullptr;
+                    World::MarkEntityChanged(this, EntityChange::Components);
                     break;
                 }
             }
@@ -328,15 +322,26 @@ namespace spartan
         return count;
     }
 
-    void Entity::UpdateTransform()
+    void Entity::UpdateTransform() const
     {
+        // the parent has to be resolved first, a dirty parent always means a dirty child, so this never runs on a clean child
+        if (m_parent)
+        {
+            m_parent->ResolveTransform();
+        }
+
+        // another thread may have resolved it while we waited
+        lock_guard lock(m_mutex_transform);
+        if (!m_transform_dirty.load(memory_order_relaxed))
+            return;
+
         // compute local transform
         m_matrix_local = Matrix(m_position_local, m_rotation_local, m_scale_local);
 
         // compute world transform
         if (m_parent)
         {
-            m_matrix = m_matrix_local * m_parent->GetMatrix();
+            m_matrix = m_matrix_local * m_parent->m_matrix;
         }
         else
         {
@@ -358,13 +363,31 @@ namespace spartan
         }
 
         // mark update
-        m_time_since_last_transform_sec = 0.0f;
+        m_time_last_transform_sec = Timer::GetTimeSec();
+        m_transform_dirty.store(false, memory_order_release);
+    }
 
-        // update children
-        for (Entity* child : m_children)
+    void Entity::MarkTransformDirty()
+    {
+        // already dirty means the descendants are too
+        if (m_transform_dirty.load(memory_order_relaxed))
+            return;
+
+        // flag the subtree, only its root is reported to the world
+        m_transform_dirty.store(true, memory_order_relaxed);
+        vector<Entity*> stack(m_children.begin(), m_children.end());
+        while (!stack.empty())
         {
-            child->UpdateTransform();
+            Entity* entity = stack.back();
+            stack.pop_back();
+            if (entity->m_transform_dirty.load(memory_order_relaxed))
+                continue;
+
+            entity->m_transform_dirty.store(true, memory_order_relaxed);
+            stack.insert(stack.end(), entity->m_children.begin(), entity->m_children.end());
         }
+
+        World::MarkTransformsDirty(this);
     }
 
     void Entity::SetPosition(const Vector3& position)
@@ -381,7 +404,7 @@ namespace spartan
             return;
 
         m_position_local = position;
-        UpdateTransform();
+        MarkTransformDirty();
     }
 
     void Entity::SetRotation(const Quaternion& rotation)
@@ -423,7 +446,7 @@ namespace spartan
             return;
 
         m_rotation_local = rotation;
-        UpdateTransform();
+        MarkTransformDirty();
     }
 
     void Entity::SetScale(const Vector3& scale)
@@ -446,7 +469,7 @@ namespace spartan
         m_scale_local.y = (m_scale_local.y == 0.0f) ? numeric_limits<float>::min() : m_scale_local.y;
         m_scale_local.z = (m_scale_local.z == 0.0f) ? numeric_limits<float>::min() : m_scale_local.z;
 
-        UpdateTransform();
+        MarkTransformDirty();
     }
 
     void Entity::Translate(const Vector3& delta)
@@ -511,8 +534,8 @@ namespace spartan
             {
                 for (Entity* child : m_children)
                 {
-                    child->m_parent = m_parent; // directly setting parent
-                    child->UpdateTransform();   // update transform if needed
+                    child->m_parent = m_parent;  // directly setting parent
+                    child->MarkTransformDirty(); // update transform if needed
                 }
         
                 m_children.clear();
@@ -533,7 +556,8 @@ namespace spartan
         }
 
         m_parent = new_parent;
-        UpdateTransform();
+        MarkTransformDirty();
+        World::MarkEntityChanged(this, EntityChange::Active); // the active state is inherited from the new parent
     }
 
     void Entity::AddChild(Entity* child)
@@ -51,17 +51,20 @@ namespace spartan
         // core
         void Start();
         void Stop();
-        void PreTick();
-        void Tick();
 
         // io
         void Save(pugi::xml_node& node);
         void Load(pugi::xml_node& node);
+        void Save(BinaryWriter& writer); // self only, the binary world format keeps children and components in their own tables
+        void Load(BinaryReader& reader);
 
         // active
         bool GetActive();
         void SetActive(const bool active);
 
+        // false while the entity is a pending addition or still loading, changes made before it joins aren't reported to the world
+        bool IsInWorld() const { return m_in_world.load(std::memory_order_acquire); }
+
         // adds a component of type T
         template <class T>
         T* AddComponent()
@@ -82,6 +85,8 @@ namespace spartan
             component->SetType(type);
             component->Initialize();
 
+            World::MarkEntityChanged(this, EntityChange::Components);
+
             return component.get();
         }
 
@@ -103,7 +108,7 @@ namespace spartan
             const ComponentType component_type = Component::TypeToEnum<T>();
             m_components[static_cast<uint32_t>(component_type)] = nullptr;
 
-            World::Resolve();
+            World::MarkEntityChanged(this, EntityChange::Components);
         }
 
         void RemoveComponentById(uint64_t id);
@@ -111,21 +116,21 @@ namespace spartan
         uint32_t GetComponentCount() const;
 
         //= POSITION ======================================================================
-        math::Vector3 GetPosition()             const { return m_matrix.GetTranslation(); }
+        math::Vector3 GetPosition()             const { ResolveTransform(); return m_matrix.GetTranslation(); }
         const math::Vector3& GetPositionLocal() const { return m_position_local; }
         void SetPosition(const math::Vector3& position);
         void SetPositionLocal(const math::Vector3& position);
         //=================================================================================
 
         //= ROTATION ======================================================================
-        math::Quaternion GetRotation()             const { return m_matrix.GetRotation(); }
+        math::Quaternion GetRotation()             const { ResolveTransform(); return m_matrix.GetRotation(); }
         const math::Quaternion& GetRotationLocal() const { return m_rotation_local; }
         void SetRotation(const math::Quaternion& rotation);
         void SetRotationLocal(const math::Quaternion& rotation);
         //=================================================================================
 
         //= SCALE ================================================================
-        math::Vector3 GetScale()             const { return m_matrix.GetScale(); }
+        math::Vector3 GetScale()             const { ResolveTransform(); return m_matrix.GetScale(); }
         const math::Vector3& GetScaleLocal() const { return m_scale_local; }
         void SetScale(const math::Vector3& scale);
         void SetScaleLocal(const math::Vector3& scale);
@@ -136,14 +141,14 @@ namespace spartan
         void Rotate(const math::Quaternion& delta);
         //=========================================
 
-        //= DIRECTIONS ================================================
-        const math::Vector3& GetUp() const       { return m_up; }
-        const math::Vector3& GetDown() const     { return m_down; }
-        const math::Vector3& GetForward() const  { return m_forward; }
-        const math::Vector3& GetBackward() const { return m_backward; }
-        const math::Vector3& GetRight() const    { return m_right; }
-        const math::Vector3& GetLeft() const     { return m_left; }
-        //=============================================================
+        //= DIRECTIONS ============================================================================
+        const math::Vector3& GetUp() const       { ResolveTransform(); return m_up; }
+        const math::Vector3& GetDown() const     { ResolveTransform(); return m_down; }
+        const math::Vector3& GetForward() const  { ResolveTransform(); return m_forward; }
+        const math::Vector3& GetBackward() const { ResolveTransform(); return m_backward; }
+        const math::Vector3& GetRight() const    { ResolveTransform(); return m_right; }
+        const math::Vector3& GetLeft() const     { ResolveTransform(); return m_left; }
+        //=========================================================================================
 
         //= HIERARCHY ===================================================================================
         void SetParent(Entity* new_parent);
@@ -162,17 +167,28 @@ namespace spartan
         std::vector<Entity*>& GetChildren()       { return m_children; }
         //===============================================================================================
 
-        const math::Matrix& GetMatrix() const              { return m_matrix; }
-        const math::Matrix& GetLocalMatrix() const         { return m_matrix_local; }
+        const math::Matrix& GetMatrix() const              { ResolveTransform(); return m_matrix; }
+        const math::Matrix& GetLocalMatrix() const         { ResolveTransform(); return m_matrix_local; }
         const math::Matrix& GetMatrixPrevious() const      { return m_matrix_previous; }
         void SetMatrixPrevious(const math::Matrix& matrix) { m_matrix_previous = matrix; }
-        float GetTimeSinceLastTransform() const            { return m_time_since_last_transform_sec; }
+        float GetTimeSinceLastTransform() const;
+
+        // setters only flag the entity and its descendants, World::Tick() resolves the flagged subtrees once per frame, level by level
+        // a getter that runs before that resolves the entity and its ancestors on the spot, so reads always see the latest values
+        // getters can run from any thread (parallel ticks, loading), every entity resolves under its own lock
+        // setters (and re-parenting) are main thread only and must not overlap with the parallel ticks
+        void ResolveTransform() const { if (m_transform_dirty.load(std::memory_order_acquire)) UpdateTransform(); }
+        bool IsTransformDirty() const { return m_transform_dirty.load(std::memory_order_acquire); }
 
     private:
+        friend class World; // flags the entity when it joins the world
+
         std::atomic<bool> m_is_active = true;
+        std::atomic<bool> m_in_world  = false;
         std::array<std::shared_ptr<Component>, static_cast<uint32_t>(ComponentType::Max)> m_components;
 
-        void UpdateTransform();
+        void UpdateTransform() const;
+        void MarkTransformDirty();
         math::Matrix GetParentTransformMatrix();
 
         // local
@@ -180,17 +196,20 @@ namespace spartan
         math::Quaternion m_rotation_local = math::Quaternion::Identity;
         math::Vector3 m_scale_local       = math::Vector3::One;
 
-        math::Matrix m_matrix          = math::Matrix::Identity;
-        math::Matrix m_matrix_previous = math::Matrix::Identity;
-        math::Matrix m_matrix_local    = math::Matrix::Identity;
+        // computed during UpdateTransform(), which can run lazily from the const getters
+        mutable math::Matrix m_matrix       = math::Matrix::Identity;
+        mutable math::Matrix m_matrix_local = math::Matrix::Identity;
+        math::Matrix m_matrix_previous      = math::Matrix::Identity;
+        mutable std::atomic<bool> m_transform_dirty = true; // when set, all descendants are set too
+        mutable std::mutex m_mutex_transform;                // serializes concurrent lazy resolves of this entity
 
         // computed during UpdateTransform() and cached for performance
-        math::Vector3 m_forward  = math::Vector3::Zero;
-        math::Vector3 m_backward = math::Vector3::Zero;
-        math::Vector3 m_up       = math::Vector3::Zero;
-        math::Vector3 m_down     = math::Vector3::Zero;
-        math::Vector3 m_right    = math::Vector3::Zero;
-        math::Vector3 m_left     = math::Vector3::Zero;
+        mutable math::Vector3 m_forward  = math::Vector3::Zero;
+        mutable math::Vector3 m_backward = math::Vector3::Zero;
+        mutable math::Vector3 m_up       = math::Vector3::Zero;
+        mutable math::Vector3 m_down     = math::Vector3::Zero;
+        mutable math::Vector3 m_right    = math::Vector3::Zero;
+        mutable math::Vector3 m_left     = math::Vector3::Zero;
 
         Entity* m_parent = nullptr;      // the parent of this entity
         std::vector<Entity*> m_children; // the children of this entity
@@ -198,6 +217,6 @@ namespace spartan
         // misc
         std::mutex m_mutex_children;
         std::mutex m_mutex_parent;
-        float m_time_since_last_transform_sec = 0.0f;
+        mutable double m_time_last_transform_sec = 0.0; // timer time of the last transform change, nothing has to tick to age it
     };
 }
@@ -21,18 +21,22 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =========================
 #include "pch.h"
+#include <shared_mutex>
 #include "World.h"
 #include "Entity.h"
+#include "WorldPartition.h"
 #include "../Game/Game.h"
 #include "../Profiling/Profiler.h"
 #include "../Core/ProgressTracker.h"
-//#include "../Core/ThreadPool.h" // Take a look at later
+#include "../Core/ThreadPool.h"
 #include "Components/Renderable.h"
 #include "Components/Camera.h"
 #include "Components/Light.h"
 #include "Components/AudioSource.h"
 #include "../Resource/ResourceCache.h"
 #include "../RHI/RHI_Texture.h"
+#include "../IO/Binary.h"
+#include "../Geometry/Bvh.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -48,38 +52,429 @@ namespace spartan
     namespace
     {
         vector<Entity*> entities;
-        vector<Entity*> entities_lights; // entities subset that contains only lights
+        vector<Entity*> entities_lights;  // active entities with a light, maintained incrementally
+        vector<Entity*> entities_cameras; // active entities with a camera, maintained incrementally
+        vector<Entity*> entities_audio;   // active entities with an audio source, maintained incrementally
         string file_path;
         mutex entity_access_mutex;
         vector<Entity*> pending_add;
-        set<uint64_t> pending_remove;
-        uint32_t audio_source_count     = 0;
-        atomic<bool> resolve            = false;
-        bool was_in_editor_mode         = false;
+        unordered_set<uint64_t> pending_remove;
+        atomic<bool> resolve              = false; // derived state (bounding box, directional light, version) needs a refresh
+        atomic<bool> resolve_full         = true;  // the tracked sets can't be trusted, rebuild them from the component lists
+        atomic<uint64_t> entities_version = 0;
+        bool was_in_editor_mode           = false;
         BoundingBox bounding_box    = BoundingBox::Unit;
         Entity* camera              = nullptr;
         Entity* light               = nullptr;
 
-        // entity state tracking - things that change the nature of the entity for rendering
-        enum class EntityChange : uint8_t
+        // entity change tracking, setters push records from any thread and the world drains them once per frame
+        // records carry ids, not pointers, so a record for an entity that got removed in the meantime simply doesn't resolve
+        struct change_record
         {
-            None       = 0,
-            Active     = 1 << 0,
-            Components = 1 << 1,
-            CullMode   = 1 << 2,
-            LightType  = 1 << 3
+            uint64_t id         = 0; // 0 for changes that aren't tied to an entity
+            EntityChange change = EntityChange::Components;
         };
-        unordered_map<uint64_t, uint32_t> entity_states; // stores: low 8 bits for flags, next 8 for component count, next 8 for cull mode, next 8 for light type
 
-        // material change tracking - things that change the nature of the material for rendering
-        unordered_map<uint64_t, size_t> material_state_hashes;
+        // bounded multi-producer queue, every cell carries a sequence number which tells producers and the consumer whose turn it is
+        class change_queue
+        {
+        public:
+            change_queue()
+            {
+                for (uint64_t i = 0; i < capacity; i++)
+                {
+                    m_cells[i].sequence.store(i, memory_order_relaxed);
+                }
+            }
+
+            // returns false when full, the caller falls back to a full rebuild
+            bool Push(const change_record& record)
+            {
+                uint64_t position = m_write.load(memory_order_relaxed);
+                while (true)
+                {
+                    cell& cell_      = m_cells[position & (capacity - 1)];
+                    uint64_t sequence = cell_.sequence.load(memory_order_acquire);
+                    int64_t diff      = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+                    if (diff == 0)
+                    {
+                        if (m_write.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                        {
+                            cell_.record = record;
+                            cell_.sequence.store(position + 1, memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = m_write.load(memory_order_relaxed);
+                    }
+                }
+            }
+
+            // single consumer, the main thread
+            bool Pop(change_record& record)
+            {
+                cell& cell_ = m_cells[m_read & (capacity - 1)];
+                if (cell_.sequence.load(memory_order_acquire) != m_read + 1)
+                    return false;
+
+                record = cell_.record;
+                cell_.sequence.store(m_read + capacity, memory_order_release);
+                m_read++;
+
+                return true;
+            }
+
+        private:
+            static const uint64_t capacity = 8192; // power of two
+
+            struct cell
+            {
+                atomic<uint64_t> sequence;
+                change_record record;
+            };
+
+            array<cell, capacity> m_cells;
+            alignas(64) atomic<uint64_t> m_write = 0;
+            alignas(64) uint64_t m_read          = 0;
+        };
+        change_queue entity_changes;
+
+        // entity lookup, ids map to slots and slots carry a generation which is bumped when the entity goes away, so stale handles resolve to null
+        // only entities in the world (not pending additions) are indexed, same as what GetEntities() returns
+        struct entity_slot
+        {
+            Entity* entity      = nullptr;
+            uint32_t generation = 1; // 0 is reserved for invalid handles
+        };
+        vector<entity_slot> entity_slots;
+        vector<uint32_t> entity_slots_free;
+        unordered_map<uint64_t, uint32_t> entity_index; // id -> slot
+
+        void entity_index_add(Entity* entity)
+        {
+            uint32_t slot = 0;
+            if (!entity_slots_free.empty())
+            {
+                slot = entity_slots_free.back();
+                entity_slots_free.pop_back();
+            }
+            else
+            {
+                slot = static_cast<uint32_t>(entity_slots.size());
+                entity_slots.emplace_back();
+            }
+            entity_slots[slot].entity = entity;
+
+            // duplicate ids keep resolving to the first entity, like the linear search used to
+            entity_index.try_emplace(entity->GetObjectId(), slot);
+        }
+
+        void entity_index_remove(Entity* entity)
+        {
+            auto it = entity_index.find(entity->GetObjectId());
+            if (it == entity_index.end() || entity_slots[it->second].entity != entity)
+            {
+                // a duplicate id that never made it into the index, find its slot the slow way
+                for (uint32_t slot = 0; slot < entity_slots.size(); slot++)
+                {
+                    if (entity_slots[slot].entity == entity)
+                    {
+                        entity_slots[slot].entity = nullptr;
+                        entity_slots[slot].generation++;
+                        entity_slots_free.push_back(slot);
+                        break;
+                    }
+                }
+                return;
+            }
+
+            entity_slot& slot = entity_slots[it->second];
+            slot.entity       = nullptr;
+            slot.generation++;
+            entity_slots_free.push_back(it->second);
+            entity_index.erase(it);
+        }
+
+        void entity_index_clear()
+        {
+            // generations survive so handles from before the clear stay stale
+            entity_index.clear();
+            entity_slots_free.clear();
+            for (uint32_t slot = 0; slot < entity_slots.size(); slot++)
+            {
+                if (entity_slots[slot].entity)
+                {
+                    entity_slots[slot].entity = nullptr;
+                    entity_slots[slot].generation++;
+                }
+                entity_slots_free.push_back(slot);
+            }
+        }
+
+        // component lists, entities own their components, these are per type lists of pointers to them
+        array<vector<Component*>, static_cast<uint32_t>(ComponentType::Max)> component_lists;
+        atomic<bool> component_lists_dirty = true;
+
+        void component_lists_add(Entity* entity)
+        {
+            for (const shared_ptr<Component>& component : entity->GetAllComponents())
+            {
+                if (component)
+                {
+                    component_lists[static_cast<uint32_t>(component->GetType())].push_back(component.get());
+                }
+            }
+        }
+
+        void component_lists_rebuild()
+        {
+            for (vector<Component*>& list : component_lists)
+            {
+                list.clear();
+            }
+
+            for (Entity* entity : entities)
+            {
+                component_lists_add(entity);
+            }
+        }
+
+        // transform resolution, setters report the root of every subtree they flag and only those subtrees are walked
+        // roots are kept as ids, like the change records, so a root that got removed in the meantime simply doesn't resolve
+        mutex transform_roots_mutex;
+        vector<uint64_t> transform_roots;
+        vector<uint64_t> transform_roots_pending;
+        unordered_set<Entity*> transform_roots_set;
+        vector<Entity*> transform_order;   // the flagged subtrees, sorted by depth so that every level only reads parents which the previous level resolved
+        vector<uint32_t> transform_levels; // start of every level in transform_order, followed by the end
+
+        void update_transforms()
+        {
+            {
+                lock_guard<mutex> lock(transform_roots_mutex);
+                if (transform_roots.empty())
+                    return;
+
+                transform_roots_pending.swap(transform_roots);
+                transform_roots.clear();
+            }
+
+            transform_roots_set.clear();
+            for (uint64_t id : transform_roots_pending)
+            {
+                auto it = entity_index.find(id);
+                if (it != entity_index.end())
+                {
+                    transform_roots_set.insert(entity_slots[it->second].entity);
+                }
+            }
+
+            // a root under another root is covered by it
+            transform_order.clear();
+            transform_levels.clear();
+            for (Entity* root : transform_roots_set)
+            {
+                bool covered = false;
+                for (Entity* ancestor = root->GetParent(); ancestor && !covered; ancestor = ancestor->GetParent())
+                {
+                    covered = transform_roots_set.count(ancestor) != 0;
+                }
+
+                if (!covered)
+                {
+                    transform_order.push_back(root);
+                }
+            }
+
+            // the descendants, level by level
+            uint32_t level_start = 0;
+            while (level_start < transform_order.size())
+            {
+                const uint32_t level_end = static_cast<uint32_t>(transform_order.size());
+                transform_levels.push_back(level_start);
+                for (uint32_t i = level_start; i < level_end; i++)
+                {
+                    for (Entity* child : transform_order[i]->GetChildren())
+                    {
+                        if (child->GetParent() == transform_order[i])
+                        {
+                            transform_order.push_back(child);
+                        }
+                    }
+                }
+                level_start = level_end;
+            }
+            transform_levels.push_back(static_cast<uint32_t>(transform_order.size()));
+
+            // resolve level by level, entities within a level are independent of each other
+            const uint32_t parallel_threshold = 256;
+            for (uint32_t level = 0; level + 1 < transform_levels.size(); level++)
+            {
+                const uint32_t start = transform_levels[level];
+                const uint32_t count = transform_levels[level + 1] - start;
+                auto resolve_range   = [start](uint32_t work_index_start, uint32_t work_index_end)
+                {
+                    for (uint32_t i = work_index_start; i < work_index_end; i++)
+                    {
+                        transform_order[start + i]->ResolveTransform();
+                    }
+                };
+
+                if (count < parallel_threshold)
+                {
+                    resolve_range(0, count);
+                }
+                else
+                {
+                    ThreadPool::ParallelLoop(resolve_range, count);
+                }
+            }
+        }
+
+        // component ticks are scheduled per type, types that aren't thread safe tick on the calling thread first
+        // transforms are then resolved, so the parallel ticks never race to lazily resolve a shared parent
+        void tick_components(const bool pre_tick)
+        {
+            const uint32_t parallel_threshold = 64;
+
+            array<ComponentType, static_cast<uint32_t>(ComponentType::Max)> types_parallel;
+            uint32_t types_parallel_count = 0;
+            for (uint32_t i = 0; i < static_cast<uint32_t>(ComponentType::Max); i++)
+            {
+                const ComponentType type               = static_cast<ComponentType>(i);
+                const vector<Component*>& components = World::GetComponents(type);
+                if (components.empty())
+                    continue;
+
+                if (components.front()->IsTickThreadSafe() && components.size() >= parallel_threshold)
+                {
+                    types_parallel[types_parallel_count++] = type;
+                    continue;
+                }
+
+                for (Component* component : components)
+                {
+                    if (component->GetEntity()->GetActive())
+                    {
+                        pre_tick ? component->PreTick() : component->Tick();
+                    }
+                }
+            }
+
+            if (types_parallel_count == 0)
+                return;
+
+            update_transforms();
+
+            for (uint32_t i = 0; i < types_parallel_count; i++)
+            {
+                // fetched again, a serial tick may have added or removed components
+                const vector<Component*>& components = World::GetComponents(types_parallel[i]);
+                if (components.empty())
+                    continue;
+
+                ThreadPool::ParallelLoop([&components, pre_tick](uint32_t work_index_start, uint32_t work_index_end)
+                {
+                    for (uint32_t j = work_index_start; j < work_index_end; j++)
+                    {
+                        Component* component = components[j];
+                        if (component->GetEntity()->GetActive())
+                        {
+                            pre_tick ? component->PreTick() : component->Tick();
+                        }
+                    }
+                }, static_cast<uint32_t>(components.size()));
+            }
+        }
+
+        void tracked_set(vector<Entity*>& set, Entity* entity, const bool present)
+        {
+            auto it = find(set.begin(), set.end(), entity);
+            if (present && it == set.end())
+            {
+                set.push_back(entity);
+            }
+            else if (!present && it != set.end())
+            {
+                set.erase(it);
+            }
+        }
+
+        void track_entity(Entity* entity)
+        {
+            const bool active = entity->GetActive();
+            tracked_set(entities_cameras, entity, active && entity->GetComponent<Camera>());
+            tracked_set(entities_lights,  entity, active && entity->GetComponent<Light>());
+            tracked_set(entities_audio,   entity, active && entity->GetComponent<AudioSource>());
+        }
 
-        void mark_entity_changed(uint64_t id, EntityChange change)
+        void untrack_entity(Entity* entity)
         {
-            entity_states[id] |= static_cast<uint32_t>(change);
-            resolve            = true;
+            tracked_set(entities_cameras, entity, false);
+            tracked_set(entities_lights,  entity, false);
+            tracked_set(entities_audio,   entity, false);
         }
 
+        void track_entities_rebuild()
+        {
+            entities_cameras.clear();
+            entities_lights.clear();
+            entities_audio.clear();
+
+            World::ForEach<Camera>([](Entity* entity, Camera*)           { entities_cameras.push_back(entity); });
+            World::ForEach<Light>([](Entity* entity, Light*)             { entities_lights.push_back(entity); });
+            World::ForEach<AudioSource>([](Entity* entity, AudioSource*) { entities_audio.push_back(entity); });
+        }
+
+        // applies the changes reported since the last frame, so a frame where nothing changed costs nothing
+        void track_entities()
+        {
+            vector<Entity*> descendants;
+            change_record record;
+            while (entity_changes.Pop(record))
+            {
+                resolve = true;
+
+                // a full rebuild is pending, the queue only has to be emptied
+                if (resolve_full || record.id == 0)
+                    continue;
+
+                auto it = entity_index.find(record.id);
+                if (it == entity_index.end())
+                    continue;
+
+                Entity* entity = entity_slots[it->second].entity;
+                track_entity(entity);
+
+                // the active state is inherited
+                if (record.change == EntityChange::Active)
+                {
+                    descendants.clear();
+                    entity->GetDescendants(&descendants);
+                    for (Entity* descendant : descendants)
+                    {
+                        track_entity(descendant);
+                    }
+                }
+            }
+
+            if (resolve_full.exchange(false))
+            {
+                track_entities_rebuild();
+                resolve = true;
+            }
+        }
+
+        // material change tracking - things that change the nature of the material for rendering
+        unordered_map<uint64_t, size_t> material_state_hashes;
+
         size_t compute_material_hash(Material* material)
         {
             size_t hash = 17; // FNV-1a seed
@@ -108,16 +503,25 @@ namespace spartan
         {
             bounding_box = BoundingBox::Unit;
 
-            for (Entity* entity : entities)
+            World::ForEach<Renderable>([](Entity*, Renderable* renderable)
             {
-                if (entity->GetActive())
+                bounding_box.Merge(renderable->GetBoundingBox());
+            });
+        }
+
+        // textures which materials are still loading, the ones the camera saw last frame move to the high lane
+        void update_pending_textures()
+        {
+            if (!Material::AnyPendingTextures())
+                return;
+
+            World::ForEach<Renderable>([](Entity*, Renderable* renderable)
+            {
+                if (Material* material = renderable->GetMaterial())
                 {
-                    if (Renderable* renderable = entity->GetComponent<Renderable>())
-                    {
-                        bounding_box.Merge(renderable->GetBoundingBox());
-                    }
+                    material->UpdatePendingTextures(renderable->IsVisible() ? TaskPriority::High : TaskPriority::Normal);
                 }
-            }
+            });
         }
 
         string world_file_path_to_resource_directory(const string& world_file_path)
@@ -125,6 +529,152 @@ namespace spartan
             const string world_name = FileSystem::GetFileNameWithoutExtensionFromFilePath(world_file_path);
             return FileSystem::GetDirectoryFromFilePath(world_file_path) + "\\" + world_name + "_resources\\";
         }
+
+        bool save_xml(const string& path)
+        {
+            // create document
+            pugi::xml_document doc;
+            pugi::xml_node world_node = doc.append_child("World");
+            world_node.append_attribute("name") = FileSystem::GetFileNameWithoutExtensionFromFilePath(path).c_str();
+
+            // entities
+            {
+                // node
+                pugi::xml_node entities_node = world_node.append_child("Entities");
+
+                // get root entities, save them, and they will save their children recursively
+                static vector<Entity*> root_entities;
+                World::GetRootEntities(root_entities);
+                const uint32_t root_entity_count = static_cast<uint32_t>(root_entities.size());
+
+                // progress tracking
+                ProgressTracker::GetProgress(ProgressType::World).Start(root_entity_count, "Saving world...");
+
+                // write entities to node
+                for (Entity* root : root_entities)
+                {
+                    pugi::xml_node entity_node = entities_node.append_child("Entity");
+                    root->Save(entity_node);
+                    ProgressTracker::GetProgress(ProgressType::World).JobDone();
+                }
+            }
+
+            // save to file
+            if (!doc.save_file(path.c_str(), " ", pugi::format_indent))
+            {
+                SP_LOG_ERROR("Failed to save XML file.");
+                return false;
+            }
+
+            return true;
+        }
+
+        bool load_xml(const string& path)
+        {
+            // load xml document
+            pugi::xml_document doc;
+            pugi::xml_parse_result result = doc.load_file(path.c_str());
+            if (!result)
+            {
+                SP_LOG_ERROR("Failed to load XML file: %s", result.description());
+                return false;
+            }
+
+            // get world node
+            pugi::xml_node world_node = doc.child("World");
+            if (!world_node)
+            {
+                SP_LOG_ERROR("No 'World' node found.");
+                return false;
+            }
+
+            // entities
+            {
+                // get node
+                pugi::xml_node entities_node = world_node.child("Entities");
+                if (!entities_node)
+                {
+                    SP_LOG_ERROR("No 'Entities' node found.");
+                    return false;
+                }
+
+                // count root entities for progress tracking
+                uint32_t root_entity_count = 0;
+                for (pugi::xml_node entity_node = entities_node.child("Entity"); entity_node; entity_node = entity_node.next_sibling("Entity"))
+                {
+                    ++root_entity_count;
+                }
+
+                // progress tracking
+                ProgressTracker::GetProgress(ProgressType::World).Start(root_entity_count, "Loading world...");
+
+                // load root entities (they will load their descendants recursively)
+                for (pugi::xml_node entity_node = entities_node.child("Entity"); entity_node; entity_node = entity_node.next_sibling("Entity"))
+                {
+                    Entity* entity = World::CreateEntity();
+                    entity->Load(entity_node);
+                    ProgressTracker::GetProgress(ProgressType::World).JobDone();
+                }
+            }
+
+            return true;
+        }
+
+        // binary world format
+        // a header followed by tagged and sized chunks, so a reader can skip what it doesn't know
+        // strings:    every string the entities and components refer to, stored once
+        // entities:   parents before children, each with the index of its parent in the table
+        // components: one blob per component with the index of its entity, its type and the version it was written with
+        // floats are stored as is and the blobs are independent of each other, so components deserialize in parallel
+        const uint32_t world_binary_magic   = 0x42575053; // "SPWB"
+        const uint32_t world_binary_version = 1;
+
+        enum class world_chunk : uint32_t
+        {
+            Strings,
+            Entities,
+            Components,
+            Max
+        };
+
+        bool save_binary(const string& path)
+        {
+            vector<Entity*> root_entities;
+            World::GetRootEntities(root_entities);
+
+            ProgressTracker::GetProgress(ProgressType::World).Start(1, "Saving world...");
+            vector<uint8_t> blob;
+            World::SaveEntities(root_entities, blob);
+            ProgressTracker::GetProgress(ProgressType::World).JobDone();
+
+            ofstream file(path, ios::binary);
+            file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+            if (!file)
+            {
+                SP_LOG_ERROR("Failed to write world file: %s", path.c_str());
+                return false;
+            }
+
+            return true;
+        }
+
+        bool load_binary(const string& path)
+        {
+            MappedFile file(path);
+            if (!file.IsValid())
+            {
+                SP_LOG_ERROR("Failed to open file: %s", path.c_str());
+                return false;
+            }
+
+            ProgressTracker::GetProgress(ProgressType::World).Start(1, "Loading world...");
+            vector<Entity*> loaded;
+            const bool result = World::LoadEntities(file.GetData(), file.GetSize(), loaded);
+            World::AddEntities(loaded);
+            ProgressTracker::GetProgress(ProgressType::World).JobDone();
+
+            return result;
+        }
     }
 
     namespace world_time
@@ -172,32 +722,134 @@ namespace spartan
         }
     }
 
-    void World::ProcessPendingRemovals()
+    namespace raycasting
     {
-        lock_guard<mutex> lock(entity_access_mutex);
-
-        if (pending_remove.empty())
-            return;
+        // top level bvh over the world bounding boxes of the renderables, meshes carry their own over their triangles
+        // the renderables and their boxes are a snapshot the main thread takes at the end of every tick, raycasts only ever read that
+        // raycasts share the lock so they don't wait for each other, the snapshot (and removals) take it exclusively and wait for them
+        shared_mutex access_mutex;
+        Bvh bvh;
+        vector<Renderable*> renderables; // the primitives of the above
+        vector<BoundingBox> boxes;
+        uint32_t moved_count = 0;        // boxes that moved since the bvh was last built or refitted
+        bool build           = false;    // the renderables changed, the bvh has to be built from scratch
+        uint64_t version     = numeric_limits<uint64_t>::max();
+
+        void clear()
+        {
+            lock_guard<shared_mutex> lock(access_mutex);
+            bvh.Clear();
+            renderables.clear();
+            boxes.clear();
+            moved_count = 0;
+            build       = false;
+            version     = numeric_limits<uint64_t>::max();
+        }
 
-        for (auto it = entities.begin(); it != entities.end(); )
+        // main thread, end of the tick
+        void snapshot()
         {
-            uint64_t id = (*it)->GetObjectId();
-            if (pending_remove.count(id) > 0)
+            lock_guard<shared_mutex> lock(access_mutex);
+
+            if (version != World::GetEntitiesVersion())
             {
-                // clean up change tracking
-                entity_states.erase(id);
-                if (Material* mat = (*it)->GetComponent<Renderable>() ? (*it)->GetComponent<Renderable>()->GetMaterial() : nullptr)
+                version = World::GetEntitiesVersion();
+                renderables.clear();
+                for (Component* component : World::GetComponents<Renderable>())
                 {
-                    material_state_hashes.erase(mat->GetObjectId());
+                    Renderable* renderable = static_cast<Renderable*>(component);
+                    if (renderable->GetMesh() && renderable->GetEntity()->GetActive())
+                    {
+                        renderables.push_back(renderable);
+                    }
                 }
-                delete *it;
-                it = entities.erase(it);
+
+                boxes.resize(renderables.size());
+                for (uint32_t i = 0; i < static_cast<uint32_t>(renderables.size()); i++)
+                {
+                    boxes[i] = renderables[i]->GetBoundingBox();
+                }
+                moved_count = 0;
+                build       = true;
+                return;
             }
-            else
+
+            // same renderables, some of them may have moved
+            for (uint32_t i = 0; i < static_cast<uint32_t>(renderables.size()); i++)
+            {
+                const BoundingBox& box = renderables[i]->GetBoundingBox();
+                if (!(box == boxes[i]))
+                {
+                    boxes[i] = box;
+                    moved_count++;
+                }
+            }
+        }
+
+        // brings the bvh up to date with the snapshot, on the first raycast after it changed, returns false when there is no snapshot to cast against
+        bool update()
+        {
+            lock_guard<shared_mutex> lock(access_mutex);
+
+            // components changed since the snapshot, some of the renderables may be gone
+            if (version != World::GetEntitiesVersion())
+                return false;
+
+            // refitting keeps the topology, which is fine for a few movers but degrades when many move
+            if (build || moved_count > renderables.size() / 10)
+            {
+                bvh.Build(boxes);
+            }
+            else if (moved_count > 0)
+            {
+                bvh.Refit(boxes);
+            }
+            build       = false;
+            moved_count = 0;
+
+            return true;
+        }
+
+        bool is_current()
+        {
+            return version == World::GetEntitiesVersion() && !build && moved_count == 0;
+        }
+    }
+
+    void World::ProcessPendingRemovals()
+    {
+        {
+            lock_guard<mutex> lock(entity_access_mutex);
+            if (pending_remove.empty())
+                return;
+        }
+
+        // waits for raycasts in flight, the snapshot refers to renderables which are about to go
+        // done before taking the entity lock, which a raycast may need while it waits on its parallel loop
+        raycasting::clear();
+
+        lock_guard<mutex> lock(entity_access_mutex);
+
+        // single pass, the survivors keep their order
+        auto it_end = remove_if(entities.begin(), entities.end(), [](Entity* entity)
+        {
+            uint64_t id = entity->GetObjectId();
+            if (pending_remove.count(id) == 0)
+                return false;
+
+            // clean up change tracking
+            untrack_entity(entity);
+            if (Material* mat = entity->GetComponent<Renderable>() ? entity->GetComponent<Renderable>()->GetMaterial() : nullptr)
             {
-                ++it;
+                material_state_hashes.erase(mat->GetObjectId());
             }
-        }
+            entity_index_remove(entity);
+            delete entity;
+            return true;
+        });
+        entities.erase(it_end, entities.end());
+        component_lists_dirty = true;
+        resolve               = true;
 
         pending_remove.clear();
     }
@@ -209,8 +861,26 @@ namespace spartan
         if (pending_add.empty())
             return;
 
+        // appended to the component lists, unless they are about to be rebuilt anyway
+        const bool lists_valid = !component_lists_dirty;
         entities.insert(entities.end(), pending_add.begin(), pending_add.end());
+        for (Entity* entity : pending_add)
+        {
+            if (lists_valid)
+            {
+                component_lists_add(entity);
+            }
+            // nothing was reported while the entity was outside the world, so its state is picked up here, once
+            entity->m_in_world.store(true, memory_order_release);
+            entity_index_add(entity);
+            track_entity(entity);
+            if (entity->IsTransformDirty())
+            {
+                World::MarkTransformsDirty(entity);
+            }
+        }
         pending_add.clear();
+        resolve = true;
     }
 
     void World::Initialize()
@@ -221,6 +891,7 @@ namespace spartan
     void World::Shutdown()
     {
         Engine::SetFlag(EngineMode::Playing, false); // stop simulation
+        WorldPartition::Shutdown();                  // drop streamed cells, they refer to this world
         ResourceCache::Shutdown();                   // release all resources (textures, materials, meshes, etc)
 
         // clear entities
@@ -232,17 +903,29 @@ namespace spartan
         }
         entities.clear();
         entities_lights.clear();
+        entities_cameras.clear();
+        entities_audio.clear();
+        for (Entity* entity : pending_add)
+        {
+            delete entity;
+        }
         pending_add.clear();
+        entity_index_clear();
+        component_lists_dirty = true;
         camera = nullptr;
         light  = nullptr;
         file_path.clear();
 
-        // clear change tracking
-        entity_states.clear();
+        // clear change tracking, records still queued refer to entities which are gone
         material_state_hashes.clear();
+        resolve_full = true;
+        {
+            lock_guard<mutex> lock(transform_roots_mutex);
+            transform_roots.clear();
+        }
 
-        // mark for resolve
-        resolve = true;
+        // the top level bvh refers to renderables which are gone
+        raycasting::clear();
     }
 
     void World::Tick()
@@ -278,130 +961,32 @@ namespace spartan
 
         ProcessPendingRemovals();
 
-      
-        for (Entity* entity : entities)
-        {
-            if (entity->GetActive())
-            {
-                entity->PreTick();
-            }
-        }
+        // pre-tick
+        tick_components(true);
 
         // tick
-        for (Entity* entity : entities)
-        {
-            if (entity->GetActive())
-            {
-                entity->Tick();
-            }
-        }
-
-        // check for entity changes
-        for (Entity* entity : entities)
-        {
-            if (entity->GetActive())
-            {
-                uint64_t id = entity->GetObjectId();
-                auto it = entity_states.find(id);
-                if (it != entity_states.end())
-                {
-                    uint32_t& state = it->second;
-                    uint32_t new_state = state;
-
-                    // active state
-                    bool was_active = (state & static_cast<uint32_t>(EntityChange::Active)) != 0;
-                    if (entity->GetActive() != was_active)
-                    {
-                        new_state |= static_cast<uint32_t>(EntityChange::Active);
-                        resolve = true;
-                    }
-
-                    // component count
-                    uint8_t prev_component_count = (state >> 8) & 0xFF;
-                    uint8_t curr_component_count = static_cast<uint8_t>(min(entity->GetComponentCount(), 255u));
-                    if (curr_component_count != prev_component_count)
-                    {
-                        new_state = (new_state & ~0xFF00) | (curr_component_count << 8);
-                        new_state |= static_cast<uint32_t>(EntityChange::Components);
-                        resolve = true;
-                    }
-
-                    // cull mode
-                    uint8_t prev_cull = (state >> 16) & 0xFF;
-                    uint8_t curr_cull = static_cast<uint8_t>(RHI_CullMode::None);
-                    if (Renderable* renderable = entity->GetComponent<Renderable>())
-                    {
-                        if (Material* material = renderable->GetMaterial())
-                        {
-                            curr_cull = static_cast<uint8_t>(material->GetProperty(MaterialProperty::CullMode));
-                        }
-                    }
-                    if (curr_cull != prev_cull)
-                    {
-                        new_state = (new_state & ~0xFF0000) | (curr_cull << 16);
-                        new_state |= static_cast<uint32_t>(EntityChange::CullMode);
-                        resolve = true;
-                    }
-
-                    // light type
-                    uint8_t prev_light_type = (state >> 24) & 0xFF;
-                    uint8_t curr_light_type = static_cast<uint8_t>(LightType::Max);
-                    if (Light* light_comp = entity->GetComponent<Light>())
-                    {
-                        curr_light_type = static_cast<uint8_t>(light_comp->GetLightType());
-                    }
-                    if (curr_light_type != prev_light_type)
-                    {
-                        new_state = (new_state & ~0xFF000000) | (curr_light_type << 24);
-                        new_state |= static_cast<uint32_t>(EntityChange::LightType);
-                        resolve = true;
-                    }
-
-                    state = new_state;
-                }
-            }
-        }
+        tick_components(false);
 
         ProcessPendingAdditions();
 
-        // resolve if needed
-        if (resolve)
+        // apply entity changes, additions are in by now so their records resolve
+        track_entities();
+        if (resolve.exchange(false))
         {
-            // track entities
+            camera = entities_cameras.empty() ? nullptr : entities_cameras.front();
+
+            light = nullptr;
+            for (Entity* entity : entities_lights)
             {
-                camera             = nullptr;
-                light              = nullptr;
-                audio_source_count = 0;
-                entities_lights.clear();
-                for (Entity* entity : entities)
+                if (entity->GetComponent<Light>()->GetLightType() == LightType::Directional)
                 {
-                    if (entity->GetActive())
-                    {
-                        if (!camera && entity->GetComponent<Camera>())
-                        {
-                            camera = entity;
-                        }
-
-                        if (Light* light_comp = entity->GetComponent<Light>())
-                        {
-                            if (!light && light_comp->GetLightType() == LightType::Directional)
-                            {
-                                light = entity;
-                            }
-                            entities_lights.push_back(entity);
-                        }
-
-                        if (entity->GetComponent<AudioSource>())
-                        {
-                            audio_source_count++;
-                        }
-                    }
+                    light = entity;
+                    break;
                 }
             }
 
             compute_bounding_box();
-            resolve = false;
-            entity_states.clear();
+            entities_version++;
         }
 
         if (Engine::IsFlagSet(EngineMode::Playing))
@@ -409,11 +994,23 @@ namespace spartan
             world_time::tick();
             Game::Tick();
         }
+
+        // stream cells in and out around the camera
+        WorldPartition::Tick();
+        update_pending_textures();
+
+        // resolve the transforms that changed this frame in one go
+        update_transforms();
+
+        // what raycasts see until the next tick
+        raycasting::snapshot();
     }
 
     bool World::SaveToFile(string file_path)
     {
-        if (FileSystem::GetExtensionFromFilePath(file_path) != EXTENSION_WORLD)
+        // xml unless binary is asked for
+        const string extension = FileSystem::GetExtensionFromFilePath(file_path);
+        if (extension != EXTENSION_WORLD && extension != EXTENSION_WORLD_BINARY)
         {
             file_path += string(EXTENSION_WORLD);
         }
@@ -421,7 +1018,11 @@ namespace spartan
         // start timing
         const Stopwatch timer;
 
-        // serialize the resources before saving the world (XML), as it references them
+        // a streaming world only has part of its entities resident, the rest would be missing from the save
+        WorldPartition::LoadAll();
+        ProcessPendingAdditions();
+
+        // serialize the resources before saving the world, as it references them
         {
             string directory = world_file_path_to_resource_directory(file_path);
             FileSystem::CreateDirectory_(directory);
@@ -452,40 +1053,9 @@ namespace spartan
             }
         }
 
-        // create document
-        pugi::xml_document doc;
-        pugi::xml_node world_node = doc.append_child("World");
-        world_node.append_attribute("name") = FileSystem::GetFileNameWithoutExtensionFromFilePath(file_path).c_str();
-
-        // entities
-        {
-            // node
-            pugi::xml_node entities_node = world_node.append_child("Entities");
-
-            // get root entities, save them, and they will save their children recursively
-            static vector<Entity*> root_entities;
-            World::GetRootEntities(root_entities);
-            const uint32_t root_entity_count = static_cast<uint32_t>(root_entities.size());
-
-            // progress tracking
-            ProgressTracker::GetProgress(ProgressType::World).Start(root_entity_count, "Saving world...");
-
-            // write entities to node
-            for (Entity* root : root_entities)
-            {
-                pugi::xml_node entity_node = entities_node.append_child("Entity");
-                root->Save(entity_node);
-                ProgressTracker::GetProgress(ProgressType::World).JobDone();
-            }
-        }
-
-        // save to file
-        bool saved = doc.save_file(file_path.c_str(), " ", pugi::format_indent);
+        const bool saved = FileSystem::GetExtensionFromFilePath(file_path) == EXTENSION_WORLD_BINARY ? save_binary(file_path) : save_xml(file_path);
         if (!saved)
-        {
-            SP_LOG_ERROR("Failed to save XML file.");
             return false;
-        }
 
         // log
         SP_LOG_INFO("World \"%s\" has been saved. Duration %.2f ms", file_path.c_str(), timer.GetElapsedTimeMs());
@@ -501,7 +1071,7 @@ namespace spartan
         // start timing
         const Stopwatch timer;
 
-        // deserialize the resources before loading the world (XML), as it references them
+        // deserialize the resources before loading the world, as it references them
         {
             string directory = world_file_path_to_resource_directory(file_path);
             vector<string> files = FileSystem::GetFilesInDirectory(directory);
@@ -527,67 +1097,276 @@ namespace spartan
             }
         }
 
-        // load xml document
-        pugi::xml_document doc;
-        pugi::xml_parse_result result = doc.load_file(file_path.c_str());
-        if (!result)
+        const bool loaded = FileSystem::GetExtensionFromFilePath(file_path) == EXTENSION_WORLD_BINARY ? load_binary(file_path) : load_xml(file_path);
+        if (!loaded)
+            return false;
+
+        // report time
+        SP_LOG_INFO("World \"%s\" has been loaded. Duration %.2f ms", file_path.c_str(), timer.GetElapsedTimeMs());
+
+        return true;
+    }
+
+    Entity* World::CreateEntity()
+    {
+        lock_guard lock(entity_access_mutex);
+
+        // joins the world on the next tick
+        Entity* entity = new Entity();
+        pending_add.push_back(entity);
+
+        return entity;
+    }
+
+    void World::SaveEntities(const vector<Entity*>& roots, vector<uint8_t>& blob)
+    {
+        // flatten the hierarchies, depth first so parents come before their children
+        vector<Entity*> table;
+        vector<uint32_t> table_parents;
+        {
+            vector<pair<Entity*, uint32_t>> stack; // entity, parent index
+            for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+            {
+                stack.emplace_back(*it, UINT32_MAX);
+            }
+
+            while (!stack.empty())
+            {
+                auto [entity, parent] = stack.back();
+                stack.pop_back();
+
+                const uint32_t index = static_cast<uint32_t>(table.size());
+                table.push_back(entity);
+                table_parents.push_back(parent);
+
+                vector<Entity*>& children = entity->GetChildren();
+                for (auto it = children.rbegin(); it != children.rend(); ++it)
+                {
+                    stack.emplace_back(*it, index);
+                }
+            }
+        }
+
+        // in world_chunk order, the strings chunk holds the table itself so it writes characters
+        BinaryStringTable strings;
+        array<BinaryWriter, static_cast<uint32_t>(world_chunk::Max)> chunks = { BinaryWriter(), BinaryWriter(&strings), BinaryWriter(&strings) };
+        BinaryWriter& chunk_strings    = chunks[static_cast<uint32_t>(world_chunk::Strings)];
+        BinaryWriter& chunk_entities   = chunks[static_cast<uint32_t>(world_chunk::Entities)];
+        BinaryWriter& chunk_components = chunks[static_cast<uint32_t>(world_chunk::Components)];
+
+        // entities and components
+        uint32_t component_count = 0;
+        for (Entity* entity : table)
+        {
+            for (const shared_ptr<Component>& component : entity->GetAllComponents())
+            {
+                component_count += component ? 1 : 0;
+            }
+        }
+
+        chunk_entities.Write(static_cast<uint32_t>(table.size()));
+        chunk_components.Write(component_count);
+        BinaryWriter blob_component(&strings);
+        for (uint32_t i = 0; i < static_cast<uint32_t>(table.size()); i++)
+        {
+            chunk_entities.Write(table_parents[i]);
+            table[i]->Save(chunk_entities);
+
+            for (const shared_ptr<Component>& component : table[i]->GetAllComponents())
+            {
+                if (!component)
+                    continue;
+
+                blob_component.Clear();
+                component->Save(blob_component);
+
+                chunk_components.Write(i);
+                chunk_components.Write(static_cast<uint32_t>(component->GetType()));
+                chunk_components.Write(component->GetBinaryVersion());
+                chunk_components.Write(blob_component.GetSize());
+                chunk_components.Write(blob_component.GetData(), blob_component.GetSize());
+            }
+        }
+
+        // strings, last to be filled but first in the blob
+        chunk_strings.Write(static_cast<uint32_t>(strings.GetStrings().size()));
+        for (const string& value : strings.GetStrings())
+        {
+            chunk_strings.WriteString(value);
+        }
+
+        BinaryWriter writer;
+        writer.Write(world_binary_magic);
+        writer.Write(world_binary_version);
+        writer.Write(static_cast<uint32_t>(chunks.size()));
+        for (uint32_t i = 0; i < static_cast<uint32_t>(chunks.size()); i++)
+        {
+            writer.Write(i);
+            writer.Write(chunks[i].GetSize());
+            writer.Write(chunks[i].GetData(), chunks[i].GetSize());
+        }
+
+        blob = writer.Release();
+    }
+
+    bool World::LoadEntities(const uint8_t* data, const uint64_t size, vector<Entity*>& entities_out)
+    {
+        entities_out.clear();
+
+        // header
+        BinaryReader reader(data, size);
+        const uint32_t magic       = reader.Read<uint32_t>();
+        const uint32_t version     = reader.Read<uint32_t>();
+        const uint32_t chunk_count = reader.Read<uint32_t>();
+        if (reader.HasFailed() || magic != world_binary_magic || version > world_binary_version)
         {
-            SP_LOG_ERROR("Failed to load XML file: %s", result.description());
+            SP_LOG_ERROR("Not a binary world, or written by a newer version");
             return false;
         }
 
-        // get world node
-        pugi::xml_node world_node = doc.child("World");
-        if (!world_node)
+        // chunk directory
+        array<pair<const uint8_t*, uint64_t>, static_cast<uint32_t>(world_chunk::Max)> chunks = {};
+        for (uint32_t i = 0; i < chunk_count; i++)
+        {
+            const uint32_t id         = reader.Read<uint32_t>();
+            const uint64_t chunk_size = reader.Read<uint64_t>();
+            if (id < chunks.size())
+            {
+                chunks[id] = { reader.GetCursorData(), chunk_size };
+            }
+            reader.Skip(chunk_size);
+        }
+        if (reader.HasFailed())
         {
-            SP_LOG_ERROR("No 'World' node found.");
+            SP_LOG_ERROR("Corrupted binary world");
             return false;
         }
 
-        // entities
+        // strings
+        BinaryStringTable strings;
         {
-            // get node
-            pugi::xml_node entities_node = world_node.child("Entities");
-            if (!entities_node)
+            auto [chunk_data, chunk_size] = chunks[static_cast<uint32_t>(world_chunk::Strings)];
+            BinaryReader chunk(chunk_data, chunk_size);
+            const uint32_t count = chunk.Read<uint32_t>();
+            for (uint32_t i = 0; i < count && !chunk.HasFailed(); i++)
             {
-                SP_LOG_ERROR("No 'Entities' node found.");
-                return false;
+                strings.Add(chunk.ReadString());
             }
+        }
 
-            // count root entities for progress tracking
-            uint32_t root_entity_count = 0;
-            for (pugi::xml_node entity_node = entities_node.child("Entity"); entity_node; entity_node = entity_node.next_sibling("Entity"))
+        // entities, detached from the world until AddEntities()
+        {
+            auto [chunk_data, chunk_size] = chunks[static_cast<uint32_t>(world_chunk::Entities)];
+            BinaryReader chunk(chunk_data, chunk_size, &strings);
+            const uint32_t count = chunk.Read<uint32_t>();
+            entities_out.reserve(min<uint64_t>(count, chunk.GetRemaining() / sizeof(uint32_t))); // each entity takes at least its parent index, so a corrupt count can't reserve past the data
+            for (uint32_t i = 0; i < count && !chunk.HasFailed(); i++)
             {
-                ++root_entity_count;
+                const uint32_t parent = chunk.Read<uint32_t>();
+
+                Entity* entity = new Entity();
+                entity->Load(chunk);
+                if (parent < i)
+                {
+                    entity->SetParent(entities_out[parent]);
+                }
+                entities_out.push_back(entity);
             }
 
-            // progress tracking
-            ProgressTracker::GetProgress(ProgressType::World).Start(root_entity_count, "Loading world...");
+            if (chunk.HasFailed())
+            {
+                SP_LOG_ERROR("Corrupted entity table");
+                for (Entity* entity : entities_out)
+                {
+                    delete entity;
+                }
+                entities_out.clear();
+                return false;
+            }
+        }
 
-            // load root entities (they will load their descendants recursively)
-            for (pugi::xml_node entity_node = entities_node.child("Entity"); entity_node; entity_node = entity_node.next_sibling("Entity"))
+        // components, added up front and deserialized after
+        struct component_blob
+        {
+            Component* component = nullptr;
+            const uint8_t* data  = nullptr;
+            uint64_t size        = 0;
+            uint32_t version     = 0;
+        };
+        vector<component_blob> blobs_parallel;
+        vector<component_blob> blobs_serial;
+        {
+            auto [chunk_data, chunk_size] = chunks[static_cast<uint32_t>(world_chunk::Components)];
+            BinaryReader chunk(chunk_data, chunk_size);
+            const uint32_t count = chunk.Read<uint32_t>();
+            for (uint32_t i = 0; i < count; i++)
             {
-                Entity* entity = World::CreateEntity();
-                entity->Load(entity_node);
-                ProgressTracker::GetProgress(ProgressType::World).JobDone();
+                const uint32_t entity_index = chunk.Read<uint32_t>();
+                const uint32_t type         = chunk.Read<uint32_t>();
+                component_blob blob;
+                blob.version                = chunk.Read<uint32_t>();
+                blob.size                   = chunk.Read<uint64_t>();
+                blob.data                   = chunk.GetCursorData();
+                chunk.Skip(blob.size);
+                if (chunk.HasFailed())
+                {
+                    SP_LOG_ERROR("Corrupted component table, the remaining components are skipped");
+                    break;
+                }
+
+                if (entity_index >= entities_out.size() || type >= static_cast<uint32_t>(ComponentType::Max))
+                    continue;
+
+                blob.component = entities_out[entity_index]->AddComponent(static_cast<ComponentType>(type));
+                if (!blob.component)
+                    continue;
+
+                if (blob.version > blob.component->GetBinaryVersion())
+                {
+                    SP_LOG_WARNING("Skipping %s component written by a newer version", Component::TypeToString(static_cast<ComponentType>(type)).c_str());
+                    continue;
+                }
+
+                (blob.component->IsLoadThreadSafe() ? blobs_parallel : blobs_serial).push_back(blob);
             }
         }
 
-        // report time
-        SP_LOG_INFO("World \"%s\" has been loaded. Duration %.2f ms", file_path.c_str(), timer.GetElapsedTimeMs());
+        // resolve the transforms up front, parents first, so the parallel loads only ever read them
+        for (Entity* entity : entities_out)
+        {
+            entity->ResolveTransform();
+        }
+
+        auto load_blob = [&strings](const component_blob& blob)
+        {
+            BinaryReader blob_reader(blob.data, blob.size, &strings, blob.version);
+            blob.component->Load(blob_reader);
+        };
+
+        if (!blobs_parallel.empty())
+        {
+            ThreadPool::ParallelLoop([&blobs_parallel, &load_blob](uint32_t work_index_start, uint32_t work_index_end)
+            {
+                for (uint32_t i = work_index_start; i < work_index_end; i++)
+                {
+                    load_blob(blobs_parallel[i]);
+                }
+            }, static_cast<uint32_t>(blobs_parallel.size()));
+        }
+
+        for (const component_blob& blob : blobs_serial)
+        {
+            load_blob(blob);
+        }
 
         return true;
     }
 
-    Entity* World::CreateEntity()
+    void World::AddEntities(const vector<Entity*>& entities_to_add)
     {
-        lock_guard lock(entity_access_mutex);
-
-        Entity* entity = new Entity();
-        pending_add.push_back(entity);
-        mark_entity_changed(entity->GetObjectId(), EntityChange::Components); // new entity requires resolve
-
-        return entity;
+        // main thread, they join on the next tick and report everything that changed while they loaded at once
+        lock_guard<mutex> lock(entity_access_mutex);
+        pending_add.insert(pending_add.end(), entities_to_add.begin(), entities_to_add.end());
     }
 
     bool World::EntityExists(Entity* entity)
@@ -616,16 +1395,12 @@ namespace spartan
             entities_to_remove.push_back(entity_to_remove); // add the root entity
             entity_to_remove->GetDescendants(&entities_to_remove); // get descendants
 
-            // create a set containing the object ids of entities to remove
-            set<uint64_t> ids_to_remove;
+            // defer removal
             for (Entity* entity : entities_to_remove)
             {
-                ids_to_remove.insert(entity->GetObjectId());
+                pending_remove.insert(entity->GetObjectId());
             }
 
-            // defer removal
-            pending_remove.insert(ids_to_remove.begin(), ids_to_remove.end());
-
             // if there was a parent, update it
             if (Entity* parent = entity_to_remove->GetParent())
             {
@@ -655,13 +1430,32 @@ namespace spartan
     {
         lock_guard<mutex> lock(entity_access_mutex);
 
-        for (const auto& entity : entities)
-        {
-            if (entity && entity->GetObjectId() == id)
-                return entity;
-        }
+        auto it = entity_index.find(id);
+        return it != entity_index.end() ? entity_slots[it->second].entity : nullptr;
+    }
+
+    EntityHandle World::GetEntityHandle(Entity* entity)
+    {
+        if (!entity)
+            return EntityHandle();
+
+        lock_guard<mutex> lock(entity_access_mutex);
+
+        auto it = entity_index.find(entity->GetObjectId());
+        if (it == entity_index.end() || entity_slots[it->second].entity != entity)
+            return EntityHandle();
+
+        return EntityHandle{ it->second, entity_slots[it->second].generation };
+    }
+
+    Entity* World::GetEntity(const EntityHandle handle)
+    {
+        lock_guard<mutex> lock(entity_access_mutex);
 
-        return nullptr;
+        if (handle.index >= entity_slots.size() || entity_slots[handle.index].generation != handle.generation)
+            return nullptr;
+
+        return entity_slots[handle.index].entity;
     }
 
     const vector<Entity*>& World::GetEntities()
@@ -674,6 +1468,114 @@ namespace spartan
         return entities_lights;
     }
 
+    uint64_t World::GetEntitiesVersion()
+    {
+        return entities_version;
+    }
+
+    void World::MarkEntityChanged(Entity* entity, const EntityChange change)
+    {
+        // entities outside the world (pending additions, entities loading on a worker) are picked up as a whole when they join
+        // so their changes don't invalidate what the world and the renderer cached, and loading threads never touch the world's state
+        if (entity && !entity->IsInWorld())
+            return;
+
+        if (change == EntityChange::Components)
+        {
+            // bumped right away as well, anything caching component pointers has to let go before the next tick
+            entities_version++;
+            component_lists_dirty = true;
+        }
+
+        if (!entity_changes.Push(change_record{ entity ? entity->GetObjectId() : 0, change }))
+        {
+            resolve_full = true;
+        }
+    }
+
+    const vector<Component*>& World::GetComponents(const ComponentType type)
+    {
+        if (component_lists_dirty.exchange(false))
+        {
+            lock_guard<mutex> lock(entity_access_mutex);
+            component_lists_rebuild();
+        }
+
+        return component_lists[static_cast<uint32_t>(type)];
+    }
+
+    bool World::Raycast(const Ray& ray, RayHitResult* hit, const float max_distance)
+    {
+        // the bvh is brought up to date exclusively, the rest runs under the shared lock, a snapshot taken in between means another round
+        shared_lock<shared_mutex> lock(raycasting::access_mutex, defer_lock);
+        while (true)
+        {
+            if (!raycasting::update())
+                return false;
+
+            lock.lock();
+            if (raycasting::is_current())
+                break;
+            lock.unlock();
+        }
+
+        const Vector3& origin    = ray.GetStart();
+        const Vector3& direction = ray.GetDirection();
+        const float infinity     = numeric_limits<float>::infinity();
+
+        // gather what the ray passes by and build the bvh of every mesh it reaches for the first time in parallel, once per mesh
+        vector<Renderable*> candidates;
+        raycasting::bvh.Raycast(origin, direction, max_distance, [&](const uint32_t index, const float)
+        {
+            candidates.push_back(raycasting::renderables[index]);
+            return infinity;
+        });
+        if (candidates.empty())
+            return false;
+
+        sort(candidates.begin(), candidates.end(), [](const Renderable* a, const Renderable* b)
+        {
+            return a->GetMesh() != b->GetMesh() ? a->GetMesh() < b->GetMesh() : a->GetSubMeshIndex() < b->GetSubMeshIndex();
+        });
+        ThreadPool::ParallelLoop([&candidates](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                const bool first_of_mesh = i == 0 || candidates[i]->GetMesh() != candidates[i - 1]->GetMesh() || candidates[i]->GetSubMeshIndex() != candidates[i - 1]->GetSubMeshIndex();
+                candidates[i]->BuildBvh(first_of_mesh);
+            }
+        }, static_cast<uint32_t>(candidates.size()));
+
+        // closest triangle, front to back through the top level
+        Renderable* closest_renderable = nullptr;
+        Vector3 closest_normal         = Vector3::Zero;
+        const float distance = raycasting::bvh.Raycast(origin, direction, max_distance, [&](const uint32_t index, const float limit)
+        {
+            Vector3 normal = Vector3::Zero;
+            const float d  = raycasting::renderables[index]->Raycast(origin, direction, limit, &normal);
+            if (d < limit)
+            {
+                closest_renderable = raycasting::renderables[index];
+                closest_normal     = normal;
+            }
+            return d;
+        });
+
+        if (!closest_renderable || distance == infinity)
+            return false;
+
+        if (hit)
+        {
+            hit->m_entity   = closest_renderable->GetEntity();
+            hit->m_position = origin + direction * distance;
+            hit->m_normal   = closest_normal;
+            hit->m_distance = distance;
+            hit->m_inside   = false;
+        }
+
+        return true;
+    }
+
     string World::GetName()
     {
         return FileSystem::GetFileNameFromFilePath(file_path);
@@ -706,7 +1608,7 @@ namespace spartan
 
     uint32_t World::GetAudioSourceCount()
     {
-        return audio_source_count;
+        return static_cast<uint32_t>(entities_audio.size());
     }
 
     bool World::HaveMaterialsChangedThisFrame()
@@ -742,6 +1644,16 @@ namespace spartan
         return changed;
     }
 
+    void World::MarkTransformsDirty(Entity* root)
+    {
+        // reported when it joins the world
+        if (!root->IsInWorld())
+            return;
+
+        lock_guard<mutex> lock(transform_roots_mutex);
+        transform_roots.push_back(root->GetObjectId());
+    }
+
     bool World::HaveLightsChangedThisFrame()
     {
         lock_guard<mutex> lock(entity_access_mutex);
@@ -21,14 +21,39 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ===================
+//= INCLUDES ======================
 #include "../Math/BoundingBox.h"
-//==============================
+#include "Components/Component.h"
+//=================================
 
 namespace spartan
 {
     class Camera;
     class Light;
+    namespace math
+    {
+        class Ray;
+        class RayHitResult;
+    }
+
+    // generational reference to an entity, resolves through World::GetEntity() and comes back null once the entity is removed
+    struct EntityHandle
+    {
+        uint32_t index      = 0;
+        uint32_t generation = 0; // never handed out, so a default handle is always invalid
+
+        bool IsValid() const { return generation != 0; }
+        bool operator==(const EntityHandle& other) const = default;
+    };
+
+    // things that change the nature of an entity for rendering, reported to the world as they happen
+    enum class EntityChange : uint8_t
+    {
+        Active,     // entity (and so its descendants) was (de)activated
+        Components, // entity gained or lost components
+        CullMode,   // a material changed its cull mode, not tied to one entity
+        LightType   // a light changed type
+    };
 
     class World
     {
@@ -42,14 +67,61 @@ namespace spartan
         static bool SaveToFile(std::string filePath);
         static bool LoadFromFile(const std::string& file_path);
 
+        // whole hierarchies in the binary world format, LoadEntities() is safe from any thread as the entities it builds
+        // stay detached from the world (parents before children) until they are handed over with AddEntities()
+        static void SaveEntities(const std::vector<Entity*>& roots, std::vector<uint8_t>& blob);
+        static bool LoadEntities(const uint8_t* data, const uint64_t size, std::vector<Entity*>& entities);
+        static void AddEntities(const std::vector<Entity*>& entities);
+
         // entities
         static Entity* CreateEntity();
         static bool EntityExists(Entity* entity);
         static void RemoveEntity(Entity* entity);
         static void GetRootEntities(std::vector<Entity*>& entities);
         static Entity* GetEntityById(uint64_t id);
+        static EntityHandle GetEntityHandle(Entity* entity);
+        static Entity* GetEntity(const EntityHandle handle);
         static const std::vector<Entity*>& GetEntities();
         static const std::vector<Entity*>& GetEntitiesLights();
+        static uint64_t GetEntitiesVersion(); // increments whenever entities are added, removed, (de)activated or change components
+
+        // lock-free and safe from any thread, changes are applied once per frame during Tick()
+        static void MarkEntityChanged(Entity* entity, const EntityChange change);
+
+        // components, one list per type with a pointer to every component of that type in the world (the entities own the components)
+        // added entities are appended, anything else rebuilds the lists on first access after the change
+        // main thread only, grab the list before handing it to worker threads
+        static const std::vector<Component*>& GetComponents(const ComponentType type);
+
+        template<class T>
+        static const std::vector<Component*>& GetComponents() { return GetComponents(Component::TypeToEnum<T>()); }
+
+        // calls function(Entity*, T*, Ts*...) for every active entity that has all of the given components, walking the shortest of their lists
+        template<class T, class... Ts, class Function>
+        static void ForEach(Function&& function)
+        {
+            const std::vector<Component*>* components = &GetComponents<T>();
+            ((components = GetComponents<Ts>().size() < components->size() ? &GetComponents<Ts>() : components), ...);
+
+            for (Component* component : *components)
+            {
+                // the cast keeps this dependent on T, so the entity is only touched once it's a complete type
+                auto* entity = static_cast<std::conditional_t<true, Component, T>*>(component)->GetEntity();
+                if (!entity->GetActive())
+                    continue;
+
+                T* first = entity->template GetComponent<T>();
+                if (!first || ((entity->template GetComponent<Ts>() == nullptr) || ...))
+                    continue;
+
+                function(entity, first, entity->template GetComponent<Ts>()...);
+            }
+        }
+
+        // closest triangle of an active renderable along the ray, ray direction is expected to be normalized (math::Ray does that)
+        // casts against the renderables as of the last Tick(), safe from any thread, misses everything while components changed since then
+        // the first ray to reach a mesh builds its bvh
+        static bool Raycast(const math::Ray& ray, math::RayHitResult* hit = nullptr, const float max_distance = FLT_MAX);
 
         // misc
         static std::string GetName();
@@ -62,6 +134,9 @@ namespace spartan
         static bool HaveMaterialsChangedThisFrame();
         static bool HaveLightsChangedThisFrame();
 
+        // transforms are resolved once per frame at the end of Tick(), entities report the root of every subtree they flag here
+        static void MarkTransformsDirty(Entity* root);
+
         // world time: 0.0 = midnight, 0.5 = noon, 1.0 = next midnight
         static float GetTimeOfDay(bool use_real_world_time = false);
         static void SetTimeOfDay(float time_of_day);
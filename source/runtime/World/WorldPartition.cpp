@@ -0,0 +1,447 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========================
+#include "pch.h"
+#include "WorldPartition.h"
+#include "World.h"
+#include "Entity.h"
+#include "Components/Camera.h"
+#include "Components/Renderable.h"
+#include "../Core/ThreadPool.h"
+#include "../Profiling/Profiler.h"
+//====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan::math;
+//============================
+
+namespace spartan
+{
+    namespace
+    {
+        enum class cell_state : uint8_t
+        {
+            Unloaded, // entities live in the blobs
+            Loading,  // blobs are being deserialized on the thread pool
+            Loaded    // entities live in the world
+        };
+
+        struct cell_blob
+        {
+            vector<uint8_t> data;
+            vector<uint64_t> root_parents; // per root, in the order they were saved, 0 for none
+        };
+
+        struct cell
+        {
+            int32_t x        = 0;
+            int32_t z        = 0;
+            cell_state state = cell_state::Unloaded;
+            uint64_t bytes   = 0; // serialized size, kept while loaded as an estimate of what the cell costs
+
+            vector<cell_blob> blobs;         // while unloaded
+            vector<uint64_t> roots;          // while loaded, ids of the root entities in the world
+            vector<Entity*> loaded;          // output of the load task, detached from the world
+            vector<uint64_t> loaded_parents; // parents of the roots in the above
+            JobCounter loading;
+        };
+
+        unordered_map<uint64_t, unique_ptr<cell>> cells;
+        atomic<bool> enabled           = false;
+        float cell_size                = 128.0f;
+        float load_radius              = 512.0f;
+        uint64_t budget                = 0;
+        uint64_t resident_bytes        = 0;
+        uint32_t cells_loaded          = 0;
+        const uint32_t loads_in_flight = 2; // cells deserialized at once, more would only compete with the frame
+
+        // entities handed over but not seen in the world yet, and the ones seen last tick which have been ticked since
+        mutex mutex_pending;
+        vector<uint64_t> pending;
+        vector<uint64_t> pending_ready;
+
+        uint64_t cell_key(const int32_t x, const int32_t z)
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+        }
+
+        cell& cell_get(const Vector3& position)
+        {
+            const int32_t x = static_cast<int32_t>(floor(position.x / cell_size));
+            const int32_t z = static_cast<int32_t>(floor(position.z / cell_size));
+
+            unique_ptr<cell>& entry = cells[cell_key(x, z)];
+            if (!entry)
+            {
+                entry    = make_unique<cell>();
+                entry->x = x;
+                entry->z = z;
+            }
+
+            return *entry;
+        }
+
+        // distance from a point to the closest point of the cell, on the xz plane
+        float cell_distance(const cell& c, const Vector3& position)
+        {
+            const float min_x = c.x * cell_size;
+            const float min_z = c.z * cell_size;
+            const float dx    = max(max(min_x - position.x, 0.0f), position.x - (min_x + cell_size));
+            const float dz    = max(max(min_z - position.z, 0.0f), position.z - (min_z + cell_size));
+
+            return sqrt(dx * dx + dz * dz);
+        }
+
+        // where an entity sits, renderables with instances can spread far from the entity's own position
+        Vector3 entity_position(Entity* entity)
+        {
+            vector<Entity*> hierarchy = { entity };
+            entity->GetDescendants(&hierarchy);
+
+            BoundingBox box;
+            bool has_box = false;
+            for (Entity* e : hierarchy)
+            {
+                if (Renderable* renderable = e->GetComponent<Renderable>())
+                {
+                    if (!has_box)
+                    {
+                        box     = renderable->GetBoundingBox();
+                        has_box = true;
+                    }
+                    else
+                    {
+                        box.Merge(renderable->GetBoundingBox());
+                    }
+                }
+            }
+
+            return has_box ? box.GetCenter() : entity->GetPosition();
+        }
+
+        // serializes entities into an unloaded cell and takes them out of the world
+        void cell_stash(cell& c, const vector<Entity*>& roots)
+        {
+            cell_blob& blob = c.blobs.emplace_back();
+            World::SaveEntities(roots, blob.data);
+            for (Entity* root : roots)
+            {
+                blob.root_parents.push_back(root->GetParent() ? root->GetParent()->GetObjectId() : 0);
+                World::RemoveEntity(root);
+            }
+
+            c.bytes += blob.data.size();
+        }
+
+        // assigns entities to the cells they sit in, they stay in the world if their cell is (being) loaded
+        void place(const vector<Entity*>& entities, const Vector3& camera_position)
+        {
+            // descendants of other entities in the list go wherever their ancestor goes
+            unordered_set<Entity*> set(entities.begin(), entities.end());
+            auto has_ancestor_in_set = [&set](Entity* entity)
+            {
+                for (Entity* parent = entity->GetParent(); parent; parent = parent->GetParent())
+                {
+                    if (set.count(parent))
+                        return true;
+                }
+                return false;
+            };
+
+            unordered_map<cell*, vector<Entity*>> groups;
+            for (Entity* entity : entities)
+            {
+                if (!has_ancestor_in_set(entity))
+                {
+                    groups[&cell_get(entity_position(entity))].push_back(entity);
+                }
+            }
+
+            for (auto& [c, group] : groups)
+            {
+                // an empty cell next to the camera would only be loaded right back, so it starts out loaded
+                if (c->state == cell_state::Unloaded && c->blobs.empty() && cell_distance(*c, camera_position) <= load_radius)
+                {
+                    c->state = cell_state::Loaded;
+                    cells_loaded++;
+                }
+
+                if (c->state == cell_state::Unloaded)
+                {
+                    cell_stash(*c, group);
+                    continue;
+                }
+
+                for (Entity* entity : group)
+                {
+                    c->roots.push_back(entity->GetObjectId());
+                }
+            }
+        }
+
+        void cell_load_begin(cell& c)
+        {
+            c.state = cell_state::Loading;
+            c.loaded.clear();
+            c.loaded_parents.clear();
+
+            ThreadPool::AddTask([&c]()
+            {
+                for (cell_blob& blob : c.blobs)
+                {
+                    vector<Entity*> entities;
+                    if (World::LoadEntities(blob.data.data(), blob.data.size(), entities))
+                    {
+                        c.loaded.insert(c.loaded.end(), entities.begin(), entities.end());
+                        c.loaded_parents.insert(c.loaded_parents.end(), blob.root_parents.begin(), blob.root_parents.end());
+                    }
+                }
+            }, c.loading);
+        }
+
+        void cell_load_end(cell& c)
+        {
+            // roots come out in the order they were saved, so they line up with their parents
+            uint32_t root_index = 0;
+            for (Entity* entity : c.loaded)
+            {
+                if (entity->GetParent())
+                    continue;
+
+                const uint64_t parent_id = root_index < c.loaded_parents.size() ? c.loaded_parents[root_index] : 0;
+                if (Entity* parent = parent_id != 0 ? World::GetEntityById(parent_id) : nullptr)
+                {
+                    entity->SetParent(parent);
+                }
+
+                c.roots.push_back(entity->GetObjectId());
+                root_index++;
+            }
+
+            World::AddEntities(c.loaded);
+            c.loaded.clear();
+            c.loaded_parents.clear();
+            c.blobs.clear();
+            c.state = cell_state::Loaded;
+            cells_loaded++;
+        }
+
+        void cell_evict(cell& c, const Vector3& camera_position)
+        {
+            vector<Entity*> roots;
+            for (uint64_t id : c.roots)
+            {
+                if (Entity* entity = World::GetEntityById(id))
+                {
+                    roots.push_back(entity);
+                }
+            }
+
+            c.roots.clear();
+            c.bytes = 0;
+            c.state = cell_state::Unloaded;
+            cells_loaded--;
+
+            // entities may have moved since they were loaded, so they are placed again
+            place(roots, camera_position);
+        }
+    }
+
+    void WorldPartition::Initialize(const float cell_size_, const float load_radius_, const uint64_t budget_bytes)
+    {
+        SP_ASSERT(cell_size_ > 0.0f);
+
+        Shutdown();
+
+        cell_size   = cell_size_;
+        load_radius = load_radius_;
+        budget      = budget_bytes;
+        enabled     = true;
+    }
+
+    void WorldPartition::Shutdown()
+    {
+        for (auto& [key, c] : cells)
+        {
+            ThreadPool::Wait(c->loading);
+            for (Entity* entity : c->loaded)
+            {
+                delete entity;
+            }
+        }
+        cells.clear();
+
+        {
+            lock_guard<mutex> lock(mutex_pending);
+            pending.clear();
+        }
+        pending_ready.clear();
+
+        resident_bytes = 0;
+        cells_loaded   = 0;
+        enabled        = false;
+    }
+
+    void WorldPartition::Tick()
+    {
+        if (!enabled)
+            return;
+
+        Camera* camera = World::GetCamera();
+        if (!camera)
+            return;
+
+        SP_PROFILE_CPU();
+
+        const Vector3 camera_position = camera->GetEntity()->GetPosition();
+
+        // pick up handed over entities, one frame after they showed up in the world so their bounding boxes are current
+        {
+            vector<Entity*> entities;
+            for (uint64_t id : pending_ready)
+            {
+                if (Entity* entity = World::GetEntityById(id))
+                {
+                    entities.push_back(entity);
+                }
+            }
+            pending_ready.clear();
+
+            if (!entities.empty())
+            {
+                place(entities, camera_position);
+            }
+
+            lock_guard<mutex> lock(mutex_pending);
+            auto it_end = remove_if(pending.begin(), pending.end(), [](uint64_t id)
+            {
+                if (!World::GetEntityById(id))
+                    return false;
+
+                pending_ready.push_back(id);
+                return true;
+            });
+            pending.erase(it_end, pending.end());
+        }
+
+        // finish loads, begin new ones (closest first) and total up what's resident
+        vector<pair<float, cell*>> candidates_load;
+        vector<pair<float, cell*>> candidates_evict;
+        uint32_t loading = 0;
+        resident_bytes   = 0;
+        for (auto& [key, entry] : cells)
+        {
+            cell& c = *entry;
+
+            if (c.state == cell_state::Loading && c.loading.IsDone())
+            {
+                cell_load_end(c);
+            }
+
+            const float distance = cell_distance(c, camera_position);
+            if (c.state == cell_state::Unloaded && !c.blobs.empty() && distance <= load_radius)
+            {
+                candidates_load.emplace_back(distance, &c);
+            }
+            else if (c.state == cell_state::Loaded && distance > load_radius)
+            {
+                candidates_evict.emplace_back(distance, &c);
+            }
+
+            loading        += c.state == cell_state::Loading ? 1 : 0;
+            resident_bytes += c.state != cell_state::Unloaded ? c.bytes : 0;
+        }
+
+        sort(candidates_load.begin(), candidates_load.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (uint32_t i = 0; i < candidates_load.size() && loading < loads_in_flight; i++, loading++)
+        {
+            cell_load_begin(*candidates_load[i].second);
+            resident_bytes += candidates_load[i].second->bytes;
+        }
+
+        // over budget, evict the farthest cells outside of the load radius
+        sort(candidates_evict.begin(), candidates_evict.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (uint32_t i = 0; i < candidates_evict.size() && resident_bytes > budget; i++)
+        {
+            resident_bytes -= candidates_evict[i].second->bytes;
+            cell_evict(*candidates_evict[i].second, camera_position);
+        }
+    }
+
+    void WorldPartition::Add(const vector<Entity*>& entities)
+    {
+        SP_ASSERT_MSG(enabled, "WorldPartition::Initialize() has to be called first");
+
+        lock_guard<mutex> lock(mutex_pending);
+        for (Entity* entity : entities)
+        {
+            pending.push_back(entity->GetObjectId());
+        }
+    }
+
+    void WorldPartition::LoadAll()
+    {
+        if (!enabled)
+            return;
+
+        SP_PROFILE_CPU();
+
+        // all at once, the thread pool decodes them in parallel
+        for (auto& [key, c] : cells)
+        {
+            if (c->state == cell_state::Unloaded && !c->blobs.empty())
+            {
+                cell_load_begin(*c);
+            }
+        }
+
+        for (auto& [key, c] : cells)
+        {
+            if (c->state == cell_state::Loading)
+            {
+                ThreadPool::Wait(c->loading);
+                cell_load_end(*c);
+            }
+        }
+    }
+
+    bool WorldPartition::IsEnabled()
+    {
+        return enabled;
+    }
+
+    uint32_t WorldPartition::GetCellCount()
+    {
+        return static_cast<uint32_t>(cells.size());
+    }
+
+    uint32_t WorldPartition::GetCellCountLoaded()
+    {
+        return cells_loaded;
+    }
+
+    uint64_t WorldPartition::GetResidentBytes()
+    {
+        return resident_bytes;
+    }
+}
@@ -0,0 +1,59 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==========
+#include <vector>
+#include <cstdint>
+//=====================
+
+namespace spartan
+{
+    class Entity;
+
+    // streams entities in and out of the world by their position on a grid of square cells (on the xz plane)
+    // entities handed to the partition are serialized into the cell they sit in and removed from the world, cells
+    // within the load radius of the camera are deserialized on the thread pool and handed back, cells outside of it
+    // stay resident until the budget is exceeded and are then evicted (serialized again) farthest first
+    class WorldPartition
+    {
+    public:
+        // the budget is in serialized bytes, which is what a cell costs to keep around in either state
+        static void Initialize(const float cell_size, const float load_radius, const uint64_t budget_bytes);
+        static void Shutdown();
+        static void Tick();
+
+        // safe from any thread, the entities are picked up once they have been in the world for a frame
+        // an entity keeps its parent, which stays resident, when streamed back in
+        static void Add(const std::vector<Entity*>& entities);
+
+        // brings every cell into the world and waits for it, so that a save sees all of the entities
+        // they join the world like any other load, and the budget evicts them again over the next ticks
+        static void LoadAll();
+
+        // stats
+        static bool IsEnabled();
+        static uint32_t GetCellCount();
+        static uint32_t GetCellCountLoaded();
+        static uint64_t GetResidentBytes();
+    };
+}